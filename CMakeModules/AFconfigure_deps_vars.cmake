@@ -66,7 +66,6 @@ set_and_mark_depnames_advncd(gtest_prefix "googletest")
 set_and_mark_depnames_advncd(glad_prefix "af_glad")
 set_and_mark_depnames_advncd(forge_prefix "af_forge")
 set_and_mark_depnames_advncd(spdlog_prefix "spdlog")
-set_and_mark_depnames_advncd(threads_prefix "af_threads")
 set_and_mark_depnames_advncd(cub_prefix "nv_cub")
 set_and_mark_depnames_advncd(cl2hpp_prefix "ocl_cl2hpp")
 set_and_mark_depnames_advncd(clblast_prefix "ocl_clblast")
@@ -1675,6 +1675,9 @@ extern "C" {
 #if AF_API_VERSION >= 34
     /**
        Evaluate multiple arrays together
+
+       The arrays can have different types and sizes. Arrays of the same size
+       share the evaluation of their common subexpressions.
     */
     AFAPI af_err af_eval_multiple(const int num, af_array *arrays);
 #endif
@@ -547,6 +547,23 @@ typedef enum {
 } af_conv_gradient_type;
 #endif
 
+#if AF_API_VERSION >= 39
+typedef enum {
+    AF_HUGE_PAGES_NONE        = 0,  ///< Pages of the default size
+    AF_HUGE_PAGES_TRANSPARENT = 1,  ///< Transparent huge pages
+    AF_HUGE_PAGES_EXPLICIT    = 2   ///< Reserved huge pages, or transparent
+                                    ///< ones if none are available
+} af_huge_pages;
+
+typedef enum {
+    AF_NUMA_DEFAULT    = 0,  ///< Pages placed on the node of the thread
+                             ///< touching them first
+    AF_NUMA_LOCAL      = 1,  ///< Pages first touched by the threads computing
+                             ///< on them
+    AF_NUMA_INTERLEAVE = 2   ///< Pages spread over all the nodes
+} af_numa_policy;
+#endif
+
 #ifdef __cplusplus
 namespace af
 {
@@ -602,6 +619,10 @@ namespace af
     typedef af_inverse_deconv_algo inverseDeconvAlgo;
     typedef af_conv_gradient_type convGradientType;
 #endif
+#if AF_API_VERSION >= 39
+    typedef af_huge_pages hugePages;
+    typedef af_numa_policy numaPolicy;
+#endif
 }
 
 #endif
@@ -10,6 +10,84 @@
 #pragma once
 #include <af/defines.h>
 
+#if AF_API_VERSION >= 39
+/// The number of bins of \ref af_memory_stats::size_histogram
+#define AF_MEMORY_STATS_BINS 32
+
+/**
+   Statistics of the memory manager for one device
+
+   The counters accumulate from the creation of the memory manager or the last
+   call to \ref af_reset_memory_stats. The peaks restart from the current
+   usage when the statistics are reset.
+
+   \ingroup device_func_mem
+*/
+typedef struct af_memory_stats {
+    size_t alloc_bytes;         ///< Bytes allocated by the memory manager
+    size_t alloc_buffers;       ///< Buffers allocated by the memory manager
+    size_t lock_bytes;          ///< Bytes in use
+    size_t lock_buffers;        ///< Buffers in use
+    size_t peak_alloc_bytes;    ///< Highest value of alloc_bytes
+    size_t peak_lock_bytes;     ///< Highest value of lock_bytes
+
+    size_t alloc_count;         ///< Allocation requests
+    size_t cache_hits;          ///< Requests reusing a freed buffer
+    size_t cache_misses;        ///< Requests allocating a new buffer
+    size_t requested_bytes;     ///< Bytes requested by the allocations
+    size_t rounding_bytes;      ///< Bytes added by rounding the requests up
+
+    size_t gc_count;            ///< Garbage collections
+    size_t gc_buffers;          ///< Buffers released by garbage collections
+    size_t gc_bytes;            ///< Bytes released by garbage collections
+
+    size_t native_alloc_count;  ///< Buffers allocated by the device API
+    double native_alloc_time;   ///< Seconds spent allocating them
+    size_t native_free_count;   ///< Buffers freed through the device API
+    double native_free_time;    ///< Seconds spent freeing them
+
+    /// The number of allocation requests by size. Bin 0 counts the requests
+    /// below 1 KiB and bin i the requests in [2^(i+9), 2^(i+10)) bytes. The
+    /// last bin also counts the larger requests.
+    size_t size_histogram[AF_MEMORY_STATS_BINS];
+} af_memory_stats;
+
+/**
+   Counters describing how the JIT trees are evaluated
+
+   The counters accumulate from the start of the program or the last call to
+   \ref af_reset_jit_stats.
+
+   \ingroup device_func_info
+*/
+typedef struct af_jit_stats {
+    /// The kernels evaluating JIT trees
+    unsigned long long evaluations;
+    /// The trees evaluated early because they reached the maximum height
+    unsigned long long height_evals;
+    /// The trees evaluated early because of the size of the kernel parameters
+    unsigned long long parameter_evals;
+    /// The trees evaluated early because of memory pressure
+    unsigned long long memory_evals;
+    /// The nodes evaluated by all the kernels
+    unsigned long long nodes;
+    /// The nodes evaluated by the largest kernel
+    unsigned long long max_nodes;
+    /// The sum of the heights of the evaluated trees
+    unsigned long long heights;
+    /// The height of the tallest evaluated tree
+    unsigned long long max_height;
+    /// The buffers read by all the kernels
+    unsigned long long buffers_read;
+    /// The buffers written by all the kernels
+    unsigned long long buffers_written;
+    /// The bytes written by all the kernels
+    unsigned long long bytes_written;
+    /// The time spent evaluating the trees in nanoseconds
+    unsigned long long eval_time_ns;
+} af_jit_stats;
+#endif
+
 #ifdef __cplusplus
 namespace af
 {
@@ -258,6 +336,79 @@ namespace af
     AFAPI void deviceMemInfo(size_t *alloc_bytes, size_t *alloc_buffers,
                              size_t *lock_bytes, size_t *lock_buffers);
 
+#if AF_API_VERSION >= 39
+    /// \brief Gets the statistics of the memory manager for the active device
+    ///
+    /// \param[out] stats the statistics
+    ///
+    /// \note Only the default memory managers record statistics
+    AFAPI void deviceMemStats(af_memory_stats *stats);
+
+    /// \brief Resets the statistics of the memory manager for the active
+    ///        device
+    AFAPI void resetDeviceMemStats();
+
+    /// \brief Sets the number of bytes the memory manager keeps in free
+    ///        buffers on each device
+    ///
+    /// \param[in] bytes the budget. SIZE_MAX keeps every free buffer
+    ///
+    /// \note Only supported by the default memory managers
+    AFAPI void setMemCacheBudget(const size_t bytes);
+
+    /// \brief Gets the number of bytes the memory manager keeps in free
+    ///        buffers on each device
+    AFAPI size_t getMemCacheBudget();
+
+    /// \brief Gets the JIT counters of the calling thread or of the active
+    ///        device
+    ///
+    /// \param[in] thread selects the counters of the trees created by the
+    ///            calling thread instead of the ones of all the trees
+    ///            evaluated on the active device
+    ///
+    /// \returns the counters accumulated since the last call to
+    ///          resetJitStats
+    AFAPI af_jit_stats getJitStats(const bool thread = false);
+
+    /// \brief Resets the JIT counters of the calling thread and of the active
+    ///        device
+    AFAPI void resetJitStats();
+
+    /// \brief Allocates the arrays created by the calling thread from an
+    ///        arena while the object is alive
+    ///
+    /// The arena hands out the memory of large blocks without the
+    /// bookkeeping of the memory manager. The blocks are given back to the
+    /// memory manager when the scope ends. An array which outlives the scope
+    /// keeps its block allocated until it is released. The scopes can be
+    /// nested.
+    ///
+    /// \code
+    /// for (int i = 0; i < iterations; i++) {
+    ///     af::scope temporaries;
+    ///     x = x - alpha * matmul(A, x) + b;
+    /// }
+    /// \endcode
+    ///
+    /// \note Only the CPU backend allocates from the arena. The other
+    ///       backends use the memory manager as usual.
+    ///
+    /// \ingroup device_func_mem
+    class AFAPI scope {
+       public:
+        /// \param[in] block_bytes the size of the blocks of the arena. 0
+        ///                        selects the default size of 16 MiB. The
+        ///                        arrays larger than half a block are
+        ///                        allocated from the memory manager.
+        explicit scope(const size_t block_bytes = 0);
+        ~scope();
+
+        scope(const scope &)            = delete;
+        scope &operator=(const scope &) = delete;
+    };
+#endif
+
 #if AF_API_VERSION >= 33
     ///
     /// Prints buffer details from the ArrayFire Device Manager
@@ -289,6 +440,63 @@ namespace af
     ///
     /// \ingroup device_func_mem
     AFAPI size_t getMemStepSize();
+
+#if AF_API_VERSION >= 39
+    /// \brief Sets the number of threads used by the CPU backend kernels
+    ///
+    /// \param[in] num_threads the number of threads, including the thread
+    ///                        running the queue. Must be greater than zero
+    ///
+    /// \note This function performs a synchronization operation. It is only
+    ///       supported by the CPU backend
+    ///
+    /// \ingroup device_func_threads
+    AFAPI void setCpuThreads(const int num_threads);
+
+    /// \brief Gets the number of threads used by the CPU backend kernels
+    ///
+    /// \ingroup device_func_threads
+    AFAPI int getCpuThreads();
+
+    /// \brief Makes each host thread use its own CPU backend queue
+    ///
+    /// \param[in] enable true to give each host thread its own queue, false
+    ///                   to share a single queue between the threads
+    ///
+    /// \note This function performs a synchronization operation. It is only
+    ///       supported by the CPU backend
+    ///
+    /// \ingroup device_func_threads
+    AFAPI void setCpuThreadQueues(const bool enable);
+
+    /// \brief Returns true if each host thread uses its own CPU backend queue
+    ///
+    /// \ingroup device_func_threads
+    AFAPI bool getCpuThreadQueues();
+
+    /// \brief Sets how the CPU backend allocates its large buffers
+    ///
+    /// \param[in] huge_pages  the pages backing the large buffers
+    /// \param[in] numa        the NUMA nodes backing the large buffers
+    /// \param[in] large_bytes the size from which a buffer is large
+    ///
+    /// \note This function is only supported by the CPU backend on Linux
+    ///
+    /// \ingroup device_func_mem
+    AFAPI void setCpuAllocPolicy(const hugePages huge_pages,
+                                 const numaPolicy numa,
+                                 const size_t large_bytes);
+
+    /// \brief Gets how the CPU backend allocates its large buffers
+    ///
+    /// \param[out] huge_pages  the pages backing the large buffers
+    /// \param[out] numa        the NUMA nodes backing the large buffers
+    /// \param[out] large_bytes the size from which a buffer is large
+    ///
+    /// \ingroup device_func_mem
+    AFAPI void getCpuAllocPolicy(hugePages *huge_pages, numaPolicy *numa,
+                                 size_t *large_bytes);
+#endif
 }
 #endif
 
@@ -459,6 +667,133 @@ extern "C" {
     AFAPI af_err af_device_mem_info(size_t *alloc_bytes, size_t *alloc_buffers,
                                     size_t *lock_bytes, size_t *lock_buffers);
 
+#if AF_API_VERSION >= 39
+    /**
+       Gets the statistics of the memory manager for the active device
+
+       The statistics describe the allocation traffic: the sizes requested,
+       how often freed buffers are reused, the memory lost to rounding the
+       requests up to the memory step size, the garbage collections and the
+       time spent in the allocation functions of the device API.
+
+       \param[out] stats the statistics
+
+       \returns AF_SUCCESS if the statistics were read. AF_ERR_NOT_SUPPORTED
+                if a custom memory manager is set
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_get_memory_stats(af_memory_stats *stats);
+
+    /**
+       Resets the statistics of the memory manager for the active device
+
+       \returns AF_SUCCESS if the statistics were reset. AF_ERR_NOT_SUPPORTED
+                if a custom memory manager is set
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_reset_memory_stats();
+
+    /**
+       Sets the number of bytes the memory manager keeps in free buffers on
+       each device
+
+       The freed buffers are kept for reuse by later allocations. Once they
+       hold more than \p bytes bytes, the least recently freed buffers are
+       released to the device API until the cache fits the budget again.
+
+       The pages of the large free buffers idle for a couple of seconds are
+       also given back to the operating system by the CPU backend. This is
+       checked when a buffer is allocated or freed and when this function is
+       called, so an idle program can call it with the current budget to
+       release them.
+
+       \param[in] bytes the budget. SIZE_MAX, the default, keeps every free
+                  buffer until the next garbage collection and 0 releases
+                  the buffers as soon as they are freed
+
+       \returns AF_SUCCESS if the budget was set. AF_ERR_NOT_SUPPORTED if a
+                custom memory manager is set
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_set_mem_cache_budget(const size_t bytes);
+
+    /**
+       Gets the number of bytes the memory manager keeps in free buffers on
+       each device
+
+       \param[out] bytes the budget
+
+       \returns AF_SUCCESS if the budget was read. AF_ERR_NOT_SUPPORTED if a
+                custom memory manager is set
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_get_mem_cache_budget(size_t *bytes);
+
+    /**
+       Gets the JIT counters of the calling thread or of the active device
+
+       The kernels evaluating the trees are counted when they complete. Call
+       \ref af_sync before reading the counters to include the pending
+       evaluations.
+
+       \param[out] stats the counters accumulated since the last call to
+                   \ref af_reset_jit_stats
+       \param[in] thread selects the counters of the trees created by the
+                  calling thread instead of the ones of all the trees
+                  evaluated on the active device
+
+       \returns AF_SUCCESS or AF_ERR_ARG if \p stats is null
+
+       \ingroup device_func_info
+    */
+    AFAPI af_err af_get_jit_stats(af_jit_stats *stats, const bool thread);
+
+    /**
+       Resets the JIT counters of the calling thread and of the active device
+
+       \returns AF_SUCCESS
+
+       \ingroup device_func_info
+    */
+    AFAPI af_err af_reset_jit_stats();
+
+    /**
+       Opens an arena on the calling thread
+
+       Until the matching \ref af_pop_arena, the arrays created by the thread
+       are carved out of large blocks allocated from the memory manager, which
+       skips the bookkeeping of every allocation. The arenas can be nested.
+
+       \param[in] block_bytes the size of the blocks of the arena. 0 selects
+                  the default size of 16 MiB. The arrays larger than half a
+                  block are allocated from the memory manager.
+
+       \returns AF_SUCCESS. Only the CPU backend allocates from the arena,
+                the other backends use the memory manager as usual.
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_push_arena(const size_t block_bytes);
+
+    /**
+       Closes the innermost arena of the calling thread
+
+       The blocks of the arena are given back to the memory manager. An array
+       allocated from the arena which is still alive keeps its block allocated
+       until it is released.
+
+       \returns AF_SUCCESS if the arena was closed. AF_ERR_ARG if the thread
+                has no arena open
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_pop_arena();
+#endif
+
 #if AF_API_VERSION >= 33
     /**
        Prints buffer details from the ArrayFire Device Manager.
@@ -619,6 +954,116 @@ extern "C" {
 
 #endif
 
+#if AF_API_VERSION >= 39
+    /**
+       Sets the number of threads used by the CPU backend kernels
+
+       The threads are shared by all the kernels of the CPU backend. The
+       default is the value of the AF_CPU_THREADS environment variable or the
+       number of hardware threads if it is not set.
+
+       \param[in] num_threads the number of threads, including the thread
+                              running the queue. Must be greater than zero
+
+       \returns AF_SUCCESS if the number of threads was changed. AF_ERR_ARG if
+                \p num_threads is not positive. AF_ERR_NOT_SUPPORTED on
+                backends other than the CPU backend
+
+       \note This function waits for all the work in the queue to complete.
+       \ingroup device_func_threads
+    */
+    AFAPI af_err af_set_cpu_threads(const int num_threads);
+
+    /**
+       Gets the number of threads used by the CPU backend kernels
+
+       \param[out] num_threads the number of threads, including the thread
+                               running the queue
+
+       \returns AF_SUCCESS on the CPU backend. AF_ERR_NOT_SUPPORTED on other
+                backends
+       \ingroup device_func_threads
+    */
+    AFAPI af_err af_get_cpu_threads(int *num_threads);
+
+    /**
+       Makes each host thread use its own CPU backend queue
+
+       With per-thread queues, the functions called from different threads do
+       not wait for each other and af_sync only waits for the functions called
+       by the current thread. Use events to order work across threads. The
+       default is the value of the AF_CPU_THREAD_QUEUES environment variable.
+
+       \param[in] enable true to give each host thread its own queue, false
+                         to share a single queue between the threads
+
+       \returns AF_SUCCESS if the mode was set. AF_ERR_NOT_SUPPORTED on
+                backends other than the CPU backend
+
+       \note This function waits for the work of every queue to complete
+       \ingroup device_func_threads
+    */
+    AFAPI af_err af_set_cpu_thread_queues(const bool enable);
+
+    /**
+       Gets whether each host thread uses its own CPU backend queue
+
+       \param[out] enabled true if each host thread has its own queue
+
+       \returns AF_SUCCESS on the CPU backend. AF_ERR_NOT_SUPPORTED on other
+                backends
+       \ingroup device_func_threads
+    */
+    AFAPI af_err af_get_cpu_thread_queues(bool *enabled);
+
+    /**
+       Sets how the CPU backend allocates its large buffers
+
+       The buffers of at least \p large_bytes bytes are mapped directly from
+       the operating system. They can use huge pages, which reduce the TLB
+       misses of the kernels going through large arrays, and can be placed on
+       specific NUMA nodes. The smaller buffers are unaffected.
+
+       With \ref AF_NUMA_LOCAL, the pages are touched by the threads used by
+       the kernels when the buffer is allocated so that they are placed on the
+       nodes of these threads. The default is read from the AF_CPU_HUGE_PAGES,
+       AF_CPU_NUMA and AF_CPU_LARGE_ALLOC_BYTES environment variables.
+
+       The buffers which were already allocated are not moved. The memory
+       manager keeps reusing them until they are freed by the garbage
+       collection.
+
+       \param[in] huge_pages  the pages backing the large buffers
+       \param[in] numa        the NUMA nodes backing the large buffers
+       \param[in] large_bytes the size from which a buffer is large
+
+       \returns AF_SUCCESS if the policy was changed. AF_ERR_ARG if
+                \p huge_pages or \p numa is not valid. AF_ERR_NOT_SUPPORTED
+                on backends other than the CPU backend
+
+       \note The policy only has an effect on Linux
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_set_cpu_alloc_policy(const af_huge_pages huge_pages,
+                                         const af_numa_policy numa,
+                                         const size_t large_bytes);
+
+    /**
+       Gets how the CPU backend allocates its large buffers
+
+       \param[out] huge_pages  the pages backing the large buffers
+       \param[out] numa        the NUMA nodes backing the large buffers
+       \param[out] large_bytes the size from which a buffer is large
+
+       \returns AF_SUCCESS on the CPU backend. AF_ERR_NOT_SUPPORTED on other
+                backends
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_get_cpu_alloc_policy(af_huge_pages *huge_pages,
+                                         af_numa_policy *numa,
+                                         size_t *large_bytes);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
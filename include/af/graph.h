@@ -0,0 +1,137 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <af/defines.h>
+
+#if AF_API_VERSION >= 39
+
+/**
+    Handle to a graph of captured functions
+
+    \ingroup graph_api
+*/
+typedef void* af_graph;
+
+#ifdef __cplusplus
+namespace af {
+
+/**
+    C++ RAII interface for captured graphs
+    \ingroup arrayfire_class
+    \ingroup graph_api
+*/
+class AFAPI graph {
+    af_graph g_;
+
+   public:
+    /// Create a graph object owning the C af_graph handle
+    graph(af_graph g);
+
+#if AF_COMPILER_CXX_RVALUE_REFERENCES
+    /// Move constructor
+    graph(graph&& other);
+
+    /// Move assignment operator
+    graph& operator=(graph&& other);
+#endif
+
+    /// graph Destructor
+    ~graph();
+
+    /// Return the underlying C af_graph handle
+    af_graph get() const;
+
+    /// \brief Enqueues the captured functions on the active queue
+    void replay() const;
+
+   private:
+    graph& operator=(const graph& other);
+    graph(const graph& other);
+};
+
+/// \brief Starts capturing the functions called by the calling thread
+///
+/// \ingroup graph_api
+AFAPI void beginCapture();
+
+/// \brief Stops the capture started by \ref beginCapture and returns the
+///        captured graph
+///
+/// \ingroup graph_api
+AFAPI graph endCapture();
+
+}  // namespace af
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+   \brief Starts capturing the functions called by the calling thread
+
+   The functions called until \ref af_end_capture still run normally. The
+   work they enqueue is also recorded so that it can be replayed later with
+   \ref af_replay_graph without going through the ArrayFire API again.
+
+   \returns AF_SUCCESS if the capture started. AF_ERR_RUNTIME if the calling
+            thread is already capturing. AF_ERR_NOT_SUPPORTED on backends
+            other than the CPU backend
+
+   \ingroup graph_api
+*/
+AFAPI af_err af_begin_capture();
+
+/**
+   \brief Stops the capture of the calling thread and returns the captured
+          graph
+
+   \param[out] graphHandle the captured graph. It must be released with
+                           \ref af_release_graph
+
+   \returns AF_SUCCESS if the graph was created. AF_ERR_RUNTIME if the calling
+            thread is not capturing. AF_ERR_NOT_SUPPORTED if one of the
+            captured functions cannot be replayed, such as the functions
+            reading host memory or generating random numbers
+
+   \ingroup graph_api
+*/
+AFAPI af_err af_end_capture(af_graph* graphHandle);
+
+/**
+   \brief Enqueues the functions captured in a graph on the active queue
+
+   The functions read and write the same memory as when they were captured.
+   The arrays used during the capture are the inputs and outputs of the graph:
+   new inputs are written into them, for example with \ref af_write_array,
+   before the replay and the results are read from them after it. The arrays
+   which were not evaluated during the capture are not part of the graph.
+
+   \param[in] graphHandle the graph to replay
+
+   \ingroup graph_api
+*/
+AFAPI af_err af_replay_graph(const af_graph graphHandle);
+
+/**
+   \brief Releases the \ref af_graph handle and the memory it keeps alive
+
+   \param[in] graphHandle the graph to release
+
+   \ingroup graph_api
+*/
+AFAPI af_err af_release_graph(af_graph graphHandle);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // AF_API_VERSION >= 39
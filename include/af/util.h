@@ -14,6 +14,7 @@
 namespace af
 {
     class array;
+    class dim4;
 
     /**
         \param[in] exp is an expression, generally the name of the array
@@ -92,6 +93,30 @@ namespace af
     AFAPI int readArrayCheck(const char *filename, const char *key);
 #endif
 
+#if AF_API_VERSION >= 39
+    /**
+        Creates an array backed by a memory mapping of a raw file
+
+        \param[in] filename is the path of the file
+        \param[in] dims is the dimensions of the array
+        \param[in] ty is the type of the elements
+        \param[in] offset is the position of the first element in the file,
+                   in bytes
+        \param[in] copy_on_write if true, the array can be modified in
+                   place without copying all of it. The file is never
+                   modified.
+
+        \returns the array
+
+        \note Only the CPU backend supports it.
+
+        \ingroup stream_func_read
+    */
+    AFAPI array mapArray(const char *filename, const dim4 &dims,
+                         const dtype ty = f32, const size_t offset = 0,
+                         const bool copy_on_write = false);
+#endif
+
 #if AF_API_VERSION >= 31
     /**
         \param[out] output is the pointer to the c-string that will hold the data. The memory for
@@ -235,6 +260,43 @@ extern "C" {
     AFAPI af_err af_read_array_key_check(int *index, const char *filename, const char* key);
 #endif
 
+#if AF_API_VERSION >= 39
+    /**
+        Creates an array backed by a memory mapping of a raw file
+
+        The elements are read from the file when they are first accessed
+        instead of being copied in memory, which suits the datasets larger
+        than the memory. The file is never modified.
+
+        \param[out] arr is the array created
+        \param[in] filename is the path of the file
+        \param[in] offset is the position of the first element in the file,
+                   in bytes. It must be a multiple of the size of \p type.
+        \param[in] ndims is the number of dimensions
+        \param[in] dims is the dimensions of the array, stored in column
+                   major order in the file
+        \param[in] type is the type of the elements
+        \param[in] copy_on_write if true, the array can be modified in
+                   place and the modified pages are private copies. If
+                   false, the array is copied before being modified in
+                   place, for example by \ref af::array::device.
+
+        \returns \ref AF_SUCCESS or \ref AF_ERR_NOT_SUPPORTED on the
+                 backends other than CPU and on Windows
+
+        \note Unlike \ref af_read_array_index, the file holds the raw
+              elements only.
+
+        \ingroup stream_func_read
+    */
+    AFAPI af_err af_create_array_from_file(af_array *arr, const char *filename,
+                                           const size_t offset,
+                                           const unsigned ndims,
+                                           const dim_t *const dims,
+                                           const af_dtype type,
+                                           const bool copy_on_write);
+#endif
+
 #if AF_API_VERSION >= 31
     /**
         \param[out] output is the pointer to the c-string that will hold the data. The memory for
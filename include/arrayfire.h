@@ -165,6 +165,16 @@
       \brief af_create_event, af_mark_event, etc.
    @}
 
+   @defgroup graph Graphs
+   @{
+
+      \brief Capturing sequences of ArrayFire functions and replaying them
+              without the overhead of the API calls.
+
+      \defgroup graph_api Graph API
+      \brief af_begin_capture, af_end_capture, af_replay_graph, etc.
+   @}
+
    @defgroup linalg_mat Linear Algebra
    @{
 
@@ -386,6 +396,7 @@
 #include "af/exception.h"
 #include "af/features.h"
 #include "af/gfor.h"
+#include "af/graph.h"
 #include "af/graphics.h"
 #include "af/half.h"
 #include "af/image.h"
@@ -24,8 +24,14 @@
 #include <mkl_service.h>
 #endif
 
+#if defined(AF_CPU)
+#include <allocation_policy.hpp>
+#endif
+
+#include <algorithm>
 #include <cstring>
 #include <string>
+#include <vector>
 
 using af::dim4;
 using arrayfire::getSparseArray;
@@ -36,7 +42,6 @@ using arrayfire::common::JIT_KERNEL_CACHE_DIRECTORY_ENV_NAME;
 using detail::Array;
 using detail::cdouble;
 using detail::cfloat;
-using detail::createEmptyArray;
 using detail::devprop;
 using detail::evalFlag;
 using detail::getActiveDeviceId;
@@ -307,52 +312,112 @@ af_err af_eval(af_array arr) {
 }
 
 template<typename T>
-static inline void evalMultiple(int num, af_array* arrayPtrs) {
-    Array<T> empty = createEmptyArray<T>(dim4());
-    std::vector<Array<T>*> arrays(num, &empty);
-
-    for (int i = 0; i < num; i++) {
-        arrays[i] = reinterpret_cast<Array<T>*>(arrayPtrs[i]);
-    }
+static inline void evalMultiple(std::vector<af_array>& handles) {
+    std::vector<Array<T>*> arrays;
+    arrays.reserve(handles.size());
+    for (af_array& handle : handles) { arrays.push_back(&getArray<T>(handle)); }
 
     evalMultiple<T>(arrays);
 }
 
+#if defined(AF_CPU)
+template<typename T>
+static inline void prepareEval(af_array& handle,
+                               std::vector<detail::EvalTarget>& targets) {
+    detail::EvalTarget target;
+    if (detail::prepareEval(getArray<T>(handle), target)) {
+        targets.push_back(std::move(target));
+    }
+}
+#endif
+
 af_err af_eval_multiple(int num, af_array* arrays) {
     try {
-        const ArrayInfo& info = getInfo(arrays[0]);
-        af_dtype type         = info.getType();
-        const dim4& dims      = info.dims();
-
-        for (int i = 1; i < num; i++) {
-            const ArrayInfo& currInfo = getInfo(arrays[i]);
-
-            // FIXME: This needs to be removed when new functionality is added
-            if (type != currInfo.getType()) {
-                AF_ERROR("All arrays must be of same type", AF_ERR_TYPE);
+        ARG_ASSERT(0, num >= 0);
+        ARG_ASSERT(1, num == 0 || arrays != nullptr);
+
+#if defined(AF_CPU)
+        // The CPU backend evaluates the arrays of different types together
+        // and groups them by shape. The nodes of the arrays are moved to the
+        // targets, so all the handles are checked first.
+        std::vector<af_dtype> types(num);
+        for (int i = 0; i < num; i++) {
+            types[i] = getInfo(arrays[i]).getType();
+            switch (types[i]) {
+                case f32:
+                case f64:
+                case c32:
+                case c64:
+                case s32:
+                case u32:
+                case u8:
+                case b8:
+                case s64:
+                case u64:
+                case s16:
+                case u16:
+                case f16: break;
+                default: TYPE_ERROR(1, types[i]);
             }
+        }
 
-            if (dims != currInfo.dims()) {
-                AF_ERROR("All arrays must be of same size", AF_ERR_SIZE);
+        std::vector<detail::EvalTarget> targets;
+        for (int i = 0; i < num; i++) {
+            switch (types[i]) {
+                case f32: prepareEval<float>(arrays[i], targets); break;
+                case f64: prepareEval<double>(arrays[i], targets); break;
+                case c32: prepareEval<cfloat>(arrays[i], targets); break;
+                case c64: prepareEval<cdouble>(arrays[i], targets); break;
+                case s32: prepareEval<int>(arrays[i], targets); break;
+                case u32: prepareEval<uint>(arrays[i], targets); break;
+                case u8: prepareEval<uchar>(arrays[i], targets); break;
+                case b8: prepareEval<char>(arrays[i], targets); break;
+                case s64: prepareEval<intl>(arrays[i], targets); break;
+                case u64: prepareEval<uintl>(arrays[i], targets); break;
+                case s16: prepareEval<short>(arrays[i], targets); break;
+                case u16: prepareEval<ushort>(arrays[i], targets); break;
+                case f16: prepareEval<half>(arrays[i], targets); break;
+                default: break;
+            }
+        }
+        if (!targets.empty()) { detail::evalMultiple(std::move(targets)); }
+#else
+        // The arrays of each type are evaluated together. Arrays of
+        // different shapes are evaluated separately by the backend.
+        std::vector<af_dtype> types;
+        for (int i = 0; i < num; i++) {
+            const af_dtype type = getInfo(arrays[i]).getType();
+            if (std::find(begin(types), end(types), type) == end(types)) {
+                types.push_back(type);
             }
         }
 
-        switch (type) {
-            case f32: evalMultiple<float>(num, arrays); break;
-            case f64: evalMultiple<double>(num, arrays); break;
-            case c32: evalMultiple<cfloat>(num, arrays); break;
-            case c64: evalMultiple<cdouble>(num, arrays); break;
-            case s32: evalMultiple<int>(num, arrays); break;
-            case u32: evalMultiple<uint>(num, arrays); break;
-            case u8: evalMultiple<uchar>(num, arrays); break;
-            case b8: evalMultiple<char>(num, arrays); break;
-            case s64: evalMultiple<intl>(num, arrays); break;
-            case u64: evalMultiple<uintl>(num, arrays); break;
-            case s16: evalMultiple<short>(num, arrays); break;
-            case u16: evalMultiple<ushort>(num, arrays); break;
-            case f16: evalMultiple<half>(num, arrays); break;
-            default: TYPE_ERROR(0, type);
+        for (af_dtype type : types) {
+            std::vector<af_array> handles;
+            for (int i = 0; i < num; i++) {
+                if (getInfo(arrays[i]).getType() == type) {
+                    handles.push_back(arrays[i]);
+                }
+            }
+
+            switch (type) {
+                case f32: evalMultiple<float>(handles); break;
+                case f64: evalMultiple<double>(handles); break;
+                case c32: evalMultiple<cfloat>(handles); break;
+                case c64: evalMultiple<cdouble>(handles); break;
+                case s32: evalMultiple<int>(handles); break;
+                case u32: evalMultiple<uint>(handles); break;
+                case u8: evalMultiple<uchar>(handles); break;
+                case b8: evalMultiple<char>(handles); break;
+                case s64: evalMultiple<intl>(handles); break;
+                case u64: evalMultiple<uintl>(handles); break;
+                case s16: evalMultiple<short>(handles); break;
+                case u16: evalMultiple<ushort>(handles); break;
+                case f16: evalMultiple<half>(handles); break;
+                default: TYPE_ERROR(0, type);
+            }
         }
+#endif
     }
     CATCHALL;
 
@@ -412,3 +477,102 @@ af_err af_set_kernel_cache_directory(const char* path, int override_env) {
     CATCHALL
     return AF_SUCCESS;
 }
+
+af_err af_set_cpu_threads(const int num_threads) {
+    try {
+        ARG_ASSERT(0, num_threads > 0);
+#if defined(AF_CPU)
+        detail::setNumThreads(num_threads);
+#else
+        AF_ERROR("Setting the number of threads is only supported by the CPU "
+                 "backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
+    CATCHALL
+    return AF_SUCCESS;
+}
+
+af_err af_get_cpu_threads(int* num_threads) {
+    try {
+        ARG_ASSERT(0, num_threads != nullptr);
+#if defined(AF_CPU)
+        *num_threads = detail::getNumThreads();
+#else
+        AF_ERROR("Getting the number of threads is only supported by the CPU "
+                 "backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
+    CATCHALL
+    return AF_SUCCESS;
+}
+
+af_err af_set_cpu_thread_queues(const bool enable) {
+    try {
+#if defined(AF_CPU)
+        detail::setThreadQueueEnabled(enable);
+#else
+        UNUSED(enable);
+        AF_ERROR("Queues per thread are only supported by the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
+    CATCHALL
+    return AF_SUCCESS;
+}
+
+af_err af_get_cpu_thread_queues(bool* enabled) {
+    try {
+        ARG_ASSERT(0, enabled != nullptr);
+#if defined(AF_CPU)
+        *enabled = detail::isThreadQueueEnabled();
+#else
+        AF_ERROR("Queues per thread are only supported by the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
+    CATCHALL
+    return AF_SUCCESS;
+}
+
+af_err af_set_cpu_alloc_policy(const af_huge_pages huge_pages,
+                               const af_numa_policy numa,
+                               const size_t large_bytes) {
+    try {
+        ARG_ASSERT(0, huge_pages == AF_HUGE_PAGES_NONE ||
+                          huge_pages == AF_HUGE_PAGES_TRANSPARENT ||
+                          huge_pages == AF_HUGE_PAGES_EXPLICIT);
+        ARG_ASSERT(1, numa == AF_NUMA_DEFAULT || numa == AF_NUMA_LOCAL ||
+                          numa == AF_NUMA_INTERLEAVE);
+#if defined(AF_CPU)
+        detail::setAllocationPolicy({huge_pages, numa, large_bytes});
+#else
+        UNUSED(large_bytes);
+        AF_ERROR("The allocation policy is only supported by the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
+    CATCHALL
+    return AF_SUCCESS;
+}
+
+af_err af_get_cpu_alloc_policy(af_huge_pages* huge_pages,
+                               af_numa_policy* numa, size_t* large_bytes) {
+    try {
+#if defined(AF_CPU)
+        const detail::AllocationPolicy policy = detail::getAllocationPolicy();
+        if (huge_pages) { *huge_pages = policy.huge_pages; }
+        if (numa) { *numa = policy.numa; }
+        if (large_bytes) { *large_bytes = policy.large_bytes; }
+#else
+        UNUSED(huge_pages);
+        UNUSED(numa);
+        UNUSED(large_bytes);
+        AF_ERROR("The allocation policy is only supported by the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
+    CATCHALL
+    return AF_SUCCESS;
+}
@@ -0,0 +1,94 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <backend.hpp>
+#include <common/err_common.hpp>
+#include <platform.hpp>
+#include <af/device.h>
+#include <af/graph.h>
+
+#if defined(AF_CPU)
+#include <Graph.hpp>
+
+#include <memory>
+
+using detail::beginCapture;
+using detail::endCapture;
+using detail::getGraph;
+using detail::getHandle;
+using detail::getQueue;
+using detail::Graph;
+#endif
+
+af_err af_begin_capture() {
+    try {
+        AF_CHECK(af_init());
+#if defined(AF_CPU)
+        beginCapture();
+#else
+        AF_ERROR("Capturing graphs is only supported by the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_end_capture(af_graph *graphHandle) {
+    try {
+        ARG_ASSERT(0, graphHandle != nullptr);
+#if defined(AF_CPU)
+        std::unique_ptr<Graph> graph = endCapture();
+        if (!graph->isValid()) {
+            AF_ERROR(
+                "The captured functions access host memory or memory which "
+                "cannot be tracked and cannot be replayed",
+                AF_ERR_NOT_SUPPORTED);
+        }
+        *graphHandle = getHandle(*graph.release());
+#else
+        AF_ERROR("Capturing graphs is only supported by the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_replay_graph(const af_graph graphHandle) {
+    try {
+        ARG_ASSERT(0, graphHandle != nullptr);
+#if defined(AF_CPU)
+        getGraph(graphHandle).replay(getQueue());
+#else
+        AF_ERROR("Capturing graphs is only supported by the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_release_graph(af_graph graphHandle) {
+    try {
+        ARG_ASSERT(0, graphHandle != nullptr);
+#if defined(AF_CPU)
+        delete &getGraph(graphHandle);
+#else
+        AF_ERROR("Capturing graphs is only supported by the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
@@ -8,11 +8,21 @@
  ********************************************************/
 
 #include <jit_test_api.h>
+#include <af/device.h>
 
 #include <backend.hpp>
 #include <common/err_common.hpp>
+#include <common/jit/JitStats.hpp>
 #include <platform.hpp>
 
+#if defined(AF_CPU)
+#include <jit/Native.hpp>
+#endif
+
+using arrayfire::common::getDeviceJitStats;
+using arrayfire::common::getThreadJitStats;
+using arrayfire::common::JitStats;
+
 af_err af_get_max_jit_len(int *jitLen) {
     *jitLen = detail::getMaxJitSize();
     return AF_SUCCESS;
@@ -26,3 +36,51 @@ af_err af_set_max_jit_len(const int maxJitLen) {
     CATCHALL;
     return AF_SUCCESS;
 }
+
+af_err af_set_cpu_native_jit(const bool enable) {
+    try {
+#if defined(AF_CPU)
+        detail::jit::setNativeEnabled(enable);
+#else
+        UNUSED(enable);
+        AF_ERROR("Native JIT kernels are only supported by the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_get_jit_stats(af_jit_stats *stats, const bool thread) {
+    try {
+        ARG_ASSERT(0, stats != nullptr);
+        const JitStats &in =
+            thread ? *getThreadJitStats()
+                   : getDeviceJitStats(
+                         static_cast<int>(detail::getActiveDeviceId()));
+        stats->evaluations     = in.evaluations;
+        stats->height_evals    = in.height_evals;
+        stats->parameter_evals = in.parameter_evals;
+        stats->memory_evals    = in.memory_evals;
+        stats->nodes           = in.nodes;
+        stats->max_nodes       = in.max_nodes;
+        stats->heights         = in.heights;
+        stats->max_height      = in.max_height;
+        stats->buffers_read    = in.buffers_read;
+        stats->buffers_written = in.buffers_written;
+        stats->bytes_written   = in.bytes_written;
+        stats->eval_time_ns    = in.eval_time_ns;
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_reset_jit_stats() {
+    try {
+        getThreadJitStats()->reset();
+        getDeviceJitStats(static_cast<int>(detail::getActiveDeviceId()))
+            .reset();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
@@ -23,6 +23,12 @@ AFAPI int getMaxJitLen(void);
 /// \param[in] jit_len is the maximum length of jit tree from root to any
 /// leaf
 AFAPI void setMaxJitLen(const int jitLen);
+
+/// Compile the CPU JIT trees into native kernels
+///
+/// \param[in] enable is true to use native kernels, false to use the
+/// interpreter
+AFAPI void setCpuNativeJit(const bool enable);
 }  // namespace af
 #endif  //__cplusplus
 
@@ -46,6 +52,14 @@ AFAPI af_err af_get_max_jit_len(int *jit_len);
 /// \returns Always returns AF_SUCCESS
 AFAPI af_err af_set_max_jit_len(const int jit_len);
 
+/// Compile the CPU JIT trees into native kernels
+///
+/// \param[in] enable is true to use native kernels, false to use the
+/// interpreter
+///
+/// \returns AF_ERR_NOT_SUPPORTED on backends other than the CPU backend
+AFAPI af_err af_set_cpu_native_jit(const bool enable);
+
 #ifdef __cplusplus
 }
 #endif
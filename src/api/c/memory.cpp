@@ -23,6 +23,10 @@
 #include <af/memory.h>
 #include <af/version.h>
 
+#if defined(AF_CPU)
+#include <arena.hpp>
+#endif
+
 #include <utility>
 
 using af::dim4;
@@ -351,6 +355,23 @@ af_err af_device_mem_info(size_t *alloc_bytes, size_t *alloc_buffers,
     return AF_SUCCESS;
 }
 
+af_err af_get_memory_stats(af_memory_stats *stats) {
+    try {
+        ARG_ASSERT(0, stats != nullptr);
+        detail::deviceMemoryStats(stats);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_reset_memory_stats() {
+    try {
+        detail::resetMemoryStats();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
 af_err af_set_mem_step_size(const size_t step_bytes) {
     try {
         detail::setMemStepSize(step_bytes);
@@ -367,6 +388,46 @@ af_err af_get_mem_step_size(size_t *step_bytes) {
     return AF_SUCCESS;
 }
 
+af_err af_set_mem_cache_budget(const size_t bytes) {
+    try {
+        detail::setMemCacheBudget(bytes);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_get_mem_cache_budget(size_t *bytes) {
+    try {
+        ARG_ASSERT(0, bytes != nullptr);
+        *bytes = detail::getMemCacheBudget();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_push_arena(const size_t block_bytes) {
+    try {
+#if defined(AF_CPU)
+        detail::pushArena(block_bytes);
+#else
+        // The other backends allocate from the memory manager as usual
+        UNUSED(block_bytes);
+#endif
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_pop_arena() {
+    try {
+#if defined(AF_CPU)
+        detail::popArena();
+#endif
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Memory Manager API
 ////////////////////////////////////////////////////////////////////////////////
@@ -784,6 +845,29 @@ void MemoryManagerFunctionWrapper::usageInfo(size_t * /*alloc_bytes*/,
         AF_ERR_NOT_SUPPORTED);
 }
 
+void MemoryManagerFunctionWrapper::memoryStats(af_memory_stats * /*stats*/) {
+    // Not part of the public memory manager API. The custom memory managers
+    // keep their own statistics.
+    AF_ERROR("Memory statistics not supported for custom memory manager",
+             AF_ERR_NOT_SUPPORTED);
+}
+
+void MemoryManagerFunctionWrapper::resetMemoryStats() {
+    AF_ERROR("Memory statistics not supported for custom memory manager",
+             AF_ERR_NOT_SUPPORTED);
+}
+
+void MemoryManagerFunctionWrapper::setCacheBudget(size_t /*bytes*/) {
+    // The custom memory managers decide themselves which buffers they keep
+    AF_ERROR("Memory cache budget not supported for custom memory manager",
+             AF_ERR_NOT_SUPPORTED);
+}
+
+size_t MemoryManagerFunctionWrapper::getCacheBudget() {
+    AF_ERROR("Memory cache budget not supported for custom memory manager",
+             AF_ERR_NOT_SUPPORTED);
+}
+
 float MemoryManagerFunctionWrapper::getMemoryPressure() {
     float out;
     AF_CHECK(getMemoryManager(handle_).get_memory_pressure_fn(handle_, &out));
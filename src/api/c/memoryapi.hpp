@@ -43,6 +43,10 @@ class MemoryManagerFunctionWrapper final
     bool isUserLocked(const void *ptr) override;
     size_t getMemStepSize() override;
     void setMemStepSize(size_t new_step_size) override;
+    void memoryStats(af_memory_stats *stats) override;
+    void resetMemoryStats() override;
+    void setCacheBudget(size_t bytes) override;
+    size_t getCacheBudget() override;
     float getMemoryPressure() override;
     bool jitTreeExceedsMemoryPressure(size_t bytes) override;
 
@@ -10,6 +10,7 @@
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
+#include <common/half.hpp>
 #include <handle.hpp>
 #include <type_util.hpp>
 
@@ -24,6 +25,7 @@ using std::string;
 using std::vector;
 
 using af::dim4;
+using arrayfire::common::half;
 using detail::cdouble;
 using detail::cfloat;
 using detail::createHostDataArray;
@@ -373,3 +375,88 @@ af_err af_read_array_key_check(int *index, const char *filename,
     CATCHALL;
     return AF_SUCCESS;
 }
+
+#if AF_API_VERSION >= 39
+#if defined(AF_CPU)
+template<typename T>
+static af_array createMappedHandle(const dim4 &dims, const char *filename,
+                                   const size_t offset,
+                                   const bool copy_on_write) {
+    ARG_ASSERT(2, offset % sizeof(T) == 0);
+    return getHandle(
+        detail::createMappedArray<T>(dims, filename, offset, copy_on_write));
+}
+#endif
+
+af_err af_create_array_from_file(af_array *arr, const char *filename,
+                                 const size_t offset, const unsigned ndims,
+                                 const dim_t *const dims, const af_dtype type,
+                                 const bool copy_on_write) {
+    try {
+        AF_CHECK(af_init());
+        ARG_ASSERT(1, filename != NULL);
+        DIM_ASSERT(3, ndims > 0 && ndims <= 4);
+        ARG_ASSERT(4, dims != NULL);
+
+        dim4 d(1);
+        for (unsigned i = 0; i < ndims; i++) { d[i] = dims[i]; }
+
+#if defined(AF_CPU)
+        af_array out = 0;
+        const bool cow = copy_on_write;
+        switch (type) {
+            case f32:
+                out = createMappedHandle<float>(d, filename, offset, cow);
+                break;
+            case c32:
+                out = createMappedHandle<cfloat>(d, filename, offset, cow);
+                break;
+            case f64:
+                out = createMappedHandle<double>(d, filename, offset, cow);
+                break;
+            case c64:
+                out = createMappedHandle<cdouble>(d, filename, offset, cow);
+                break;
+            case b8:
+                out = createMappedHandle<char>(d, filename, offset, cow);
+                break;
+            case s32:
+                out = createMappedHandle<int>(d, filename, offset, cow);
+                break;
+            case u32:
+                out = createMappedHandle<uint>(d, filename, offset, cow);
+                break;
+            case u8:
+                out = createMappedHandle<uchar>(d, filename, offset, cow);
+                break;
+            case s64:
+                out = createMappedHandle<intl>(d, filename, offset, cow);
+                break;
+            case u64:
+                out = createMappedHandle<uintl>(d, filename, offset, cow);
+                break;
+            case s16:
+                out = createMappedHandle<short>(d, filename, offset, cow);
+                break;
+            case u16:
+                out = createMappedHandle<ushort>(d, filename, offset, cow);
+                break;
+            case f16:
+                out = createMappedHandle<half>(d, filename, offset, cow);
+                break;
+            default: TYPE_ERROR(5, type);
+        }
+        std::swap(*arr, out);
+#else
+        UNUSED(arr);
+        UNUSED(offset);
+        UNUSED(type);
+        UNUSED(copy_on_write);
+        AF_ERROR("Mapping files is only supported by the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+#endif
@@ -171,6 +171,57 @@ size_t getMemStepSize() {
     return size_bytes;
 }
 
+void setCpuThreads(const int num_threads) {
+    AF_THROW(af_set_cpu_threads(num_threads));
+}
+
+int getCpuThreads() {
+    int num_threads = 0;
+    AF_THROW(af_get_cpu_threads(&num_threads));
+    return num_threads;
+}
+
+void setCpuThreadQueues(const bool enable) {
+    AF_THROW(af_set_cpu_thread_queues(enable));
+}
+
+bool getCpuThreadQueues() {
+    bool enabled = false;
+    AF_THROW(af_get_cpu_thread_queues(&enabled));
+    return enabled;
+}
+
+void deviceMemStats(af_memory_stats *stats) {
+    AF_THROW(af_get_memory_stats(stats));
+}
+
+void resetDeviceMemStats() { AF_THROW(af_reset_memory_stats()); }
+
+void setMemCacheBudget(const size_t bytes) {
+    AF_THROW(af_set_mem_cache_budget(bytes));
+}
+
+size_t getMemCacheBudget() {
+    size_t bytes = 0;
+    AF_THROW(af_get_mem_cache_budget(&bytes));
+    return bytes;
+}
+
+scope::scope(const size_t block_bytes) { AF_THROW(af_push_arena(block_bytes)); }
+
+// Destructors do not throw. The arena was opened by the constructor.
+scope::~scope() { af_pop_arena(); }
+
+void setCpuAllocPolicy(const hugePages huge_pages, const numaPolicy numa,
+                       const size_t large_bytes) {
+    AF_THROW(af_set_cpu_alloc_policy(huge_pages, numa, large_bytes));
+}
+
+void getCpuAllocPolicy(hugePages *huge_pages, numaPolicy *numa,
+                       size_t *large_bytes) {
+    AF_THROW(af_get_cpu_alloc_policy(huge_pages, numa, large_bytes));
+}
+
 AF_DEPRECATED_WARNINGS_OFF
 #define INSTANTIATE(T)                                                        \
     template<>                                                                \
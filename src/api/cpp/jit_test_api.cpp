@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <jit_test_api.h>
+#include <af/device.h>
 #include "error.hpp"
 
 namespace af {
@@ -18,4 +19,16 @@ int getMaxJitLen(void) {
 }
 
 void setMaxJitLen(const int jitLen) { AF_THROW(af_set_max_jit_len(jitLen)); }
+
+void setCpuNativeJit(const bool enable) {
+    AF_THROW(af_set_cpu_native_jit(enable));
+}
+
+af_jit_stats getJitStats(const bool thread) {
+    af_jit_stats stats{};
+    AF_THROW(af_get_jit_stats(&stats, thread));
+    return stats;
+}
+
+void resetJitStats(void) { AF_THROW(af_reset_jit_stats()); }
 }  // namespace af
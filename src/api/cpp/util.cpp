@@ -48,6 +48,14 @@ int readArrayCheck(const char *filename, const char *key) {
     return out;
 }
 
+array mapArray(const char *filename, const dim4 &dims, const dtype ty,
+               const size_t offset, const bool copy_on_write) {
+    af_array out = 0;
+    AF_THROW(af_create_array_from_file(&out, filename, offset, dims.ndims(),
+                                       dims.get(), ty, copy_on_write));
+    return array(out);
+}
+
 void toString(char **output, const char *exp, const array &arr,
               const int precision, const bool transpose) {
     AF_THROW(af_array_to_string(output, exp, arr.get(), precision, transpose));
@@ -189,3 +189,50 @@ af_err af_set_kernel_cache_directory(const char *path, int override_eval) {
 af_err af_get_kernel_cache_directory(size_t *length, char *path) {
     CALL(af_get_kernel_cache_directory, length, path);
 }
+
+af_err af_set_cpu_threads(const int num_threads) {
+    CALL(af_set_cpu_threads, num_threads);
+}
+
+af_err af_get_cpu_threads(int *num_threads) {
+    CALL(af_get_cpu_threads, num_threads);
+}
+
+af_err af_set_cpu_thread_queues(const bool enable) {
+    CALL(af_set_cpu_thread_queues, enable);
+}
+
+af_err af_get_cpu_thread_queues(bool *enabled) {
+    CALL(af_get_cpu_thread_queues, enabled);
+}
+
+af_err af_set_cpu_alloc_policy(const af_huge_pages huge_pages,
+                               const af_numa_policy numa,
+                               const size_t large_bytes) {
+    CALL(af_set_cpu_alloc_policy, huge_pages, numa, large_bytes);
+}
+
+af_err af_get_cpu_alloc_policy(af_huge_pages *huge_pages, af_numa_policy *numa,
+                               size_t *large_bytes) {
+    CALL(af_get_cpu_alloc_policy, huge_pages, numa, large_bytes);
+}
+
+af_err af_get_memory_stats(af_memory_stats *stats) {
+    CALL(af_get_memory_stats, stats);
+}
+
+af_err af_reset_memory_stats() { CALL_NO_PARAMS(af_reset_memory_stats); }
+
+af_err af_set_mem_cache_budget(const size_t bytes) {
+    CALL(af_set_mem_cache_budget, bytes);
+}
+
+af_err af_get_mem_cache_budget(size_t *bytes) {
+    CALL(af_get_mem_cache_budget, bytes);
+}
+
+af_err af_push_arena(const size_t block_bytes) {
+    CALL(af_push_arena, block_bytes);
+}
+
+af_err af_pop_arena() { CALL_NO_PARAMS(af_pop_arena); }
@@ -0,0 +1,25 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/graph.h>
+#include "symbol_manager.hpp"
+
+af_err af_begin_capture() { CALL_NO_PARAMS(af_begin_capture); }
+
+af_err af_end_capture(af_graph* graphHandle) {
+    CALL(af_end_capture, graphHandle);
+}
+
+af_err af_replay_graph(const af_graph graphHandle) {
+    CALL(af_replay_graph, graphHandle);
+}
+
+af_err af_release_graph(af_graph graphHandle) {
+    CALL(af_release_graph, graphHandle);
+}
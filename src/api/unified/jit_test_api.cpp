@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <jit_test_api.h>
+#include <af/device.h>
 
 #include "symbol_manager.hpp"
 
@@ -16,3 +17,13 @@ af_err af_get_max_jit_len(int *jitLen) { CALL(af_get_max_jit_len, jitLen); }
 af_err af_set_max_jit_len(const int jitLen) {
     CALL(af_set_max_jit_len, jitLen);
 }
+
+af_err af_set_cpu_native_jit(const bool enable) {
+    CALL(af_set_cpu_native_jit, enable);
+}
+
+af_err af_get_jit_stats(af_jit_stats *stats, const bool thread) {
+    CALL(af_get_jit_stats, stats, thread);
+}
+
+af_err af_reset_jit_stats() { CALL_NO_PARAMS(af_reset_jit_stats); }
@@ -42,6 +42,14 @@ af_err af_read_array_key_check(int *index, const char *filename,
     CALL(af_read_array_key_check, index, filename, key);
 }
 
+af_err af_create_array_from_file(af_array *arr, const char *filename,
+                                 const size_t offset, const unsigned ndims,
+                                 const dim_t *const dims, const af_dtype type,
+                                 const bool copy_on_write) {
+    CALL(af_create_array_from_file, arr, filename, offset, ndims, dims, type,
+         copy_on_write);
+}
+
 af_err af_array_to_string(char **output, const char *exp, const af_array arr,
                           const int precision, const bool transpose) {
     CHECK_ARRAYS(arr);
@@ -33,6 +33,18 @@ class AllocatorInterface {
     virtual size_t getMaxMemorySize(int id)       = 0;
     virtual void *nativeAlloc(const size_t bytes) = 0;
     virtual void nativeFree(void *ptr)            = 0;
+
+    /// Tells the device API the content of the free buffer \p ptr of
+    /// \p bytes bytes is not needed anymore. The buffer stays allocated but
+    /// its pages can be given back to the system. Called without the memory
+    /// manager lock. The buffer is not reused or freed until it returns.
+    /// Does nothing by default.
+    virtual void nativeDecommit(void * /*ptr*/, const size_t /*bytes*/) {}
+
+    /// Called before a buffer decommitted by \ref nativeDecommit is reused.
+    /// Does nothing by default.
+    virtual void nativeRecommit(void * /*ptr*/) {}
+
     virtual spdlog::logger *getLogger() final { return this->logger.get(); }
 
    protected:
@@ -17,7 +17,9 @@
 #include <af/memory.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -25,17 +27,35 @@
 using std::max;
 using std::move;
 using std::stoi;
+using std::stoull;
 using std::string;
 using std::vector;
+using std::chrono::steady_clock;
 
 namespace arrayfire {
 namespace common {
 
+namespace {
+
+/// The smallest free buffers decommitted when they stay idle
+constexpr size_t DECOMMIT_BYTES = 1 << 20;
+
+/// How long a large buffer stays free before it is decommitted
+constexpr steady_clock::duration DECOMMIT_DELAY = std::chrono::seconds(2);
+
+}  // namespace
+
 DefaultMemoryManager::memory_info &
 DefaultMemoryManager::getCurrentMemoryInfo() {
     return memory[this->getActiveDeviceId()];
 }
 
+void DefaultMemoryManager::timedNativeFree(void *ptr, int device) {
+    NativeTimer timer;
+    this->nativeFree(ptr);
+    memory[device].stats.recordNativeFree(timer.elapsed());
+}
+
 void DefaultMemoryManager::cleanDeviceMemoryManager(int device) {
     if (this->debug_mode) { return; }
 
@@ -48,7 +68,10 @@ void DefaultMemoryManager::cleanDeviceMemoryManager(int device) {
     {
         lock_guard_t lock(this->memory_mutex);
         // Return if all buffers are locked
-        if (current.total_buffers == current.lock_buffers) { return; }
+        if (current.total_buffers == current.lock_buffers) {
+            current.stats.recordGarbageCollection(0, 0);
+            return;
+        }
         free_ptrs.reserve(current.free_map.size());
 
         for (auto &kv : current.free_map) {
@@ -63,18 +86,23 @@ void DefaultMemoryManager::cleanDeviceMemoryManager(int device) {
             current.total_buffers -= num_ptrs;
         }
         current.free_map.clear();
+        current.free_lru.clear();
+        current.lru_map.clear();
+        current.idle_queue.clear();
+        current.stats.recordGarbageCollection(free_ptrs.size(), bytes_freed);
     }
 
     AF_TRACE("GC: Clearing {} buffers {}", free_ptrs.size(),
              bytesToString(bytes_freed));
     // Free memory outside of the lock
-    for (auto *ptr : free_ptrs) { this->nativeFree(ptr); }
+    for (auto *ptr : free_ptrs) { timedNativeFree(ptr, device); }
 }
 
 DefaultMemoryManager::DefaultMemoryManager(int num_devices,
                                            unsigned max_buffers, bool debug)
     : mem_step_size(1024)
     , max_buffers(max_buffers)
+    , cache_budget(std::numeric_limits<size_t>::max())
     , debug_mode(debug)
     , memory(num_devices) {
     // Check for environment variables
@@ -87,6 +115,10 @@ DefaultMemoryManager::DefaultMemoryManager(int num_devices,
     // Max Buffer count
     env_var = getEnvVar("AF_MAX_BUFFERS");
     if (!env_var.empty()) { this->max_buffers = max(1, stoi(env_var)); }
+
+    // Bytes kept in the free buffers of each device
+    env_var = getEnvVar("AF_MEM_CACHE_BUDGET");
+    if (!env_var.empty()) { this->cache_budget = stoull(env_var); }
 }
 
 void DefaultMemoryManager::initialize() { this->setMaxMemorySize(); }
@@ -129,6 +161,41 @@ void DefaultMemoryManager::setMaxMemorySize() {
     }
 }
 
+void DefaultMemoryManager::memoryStats(af_memory_stats *stats) {
+    lock_guard_t lock(this->memory_mutex);
+    const memory_info &current = this->getCurrentMemoryInfo();
+    current.stats.read(stats, current.total_bytes, current.total_buffers,
+                       current.lock_bytes, current.lock_buffers);
+}
+
+void DefaultMemoryManager::resetMemoryStats() {
+    lock_guard_t lock(this->memory_mutex);
+    memory_info &current = this->getCurrentMemoryInfo();
+    current.stats.reset(current.total_bytes, current.lock_bytes);
+}
+
+void DefaultMemoryManager::setCacheBudget(size_t bytes) {
+    // The other devices fit the budget the next time they release a buffer
+    const int device = this->getActiveDeviceId();
+    vector<void *> evicted;
+    vector<free_info> idle;
+    {
+        lock_guard_t lock(this->memory_mutex);
+        this->cache_budget = bytes;
+        if (!this->debug_mode) {
+            evictFreeBuffers(memory[device], evicted);
+            decommitIdleBuffers(memory[device], idle);
+        }
+    }
+    for (void *ptr : evicted) { timedNativeFree(ptr, device); }
+    decommitBuffers(memory[device], idle);
+}
+
+size_t DefaultMemoryManager::getCacheBudget() {
+    lock_guard_t lock(this->memory_mutex);
+    return this->cache_budget;
+}
+
 float DefaultMemoryManager::getMemoryPressure() {
     lock_guard_t lock(this->memory_mutex);
     memory_info &current = this->getCurrentMemoryInfo();
@@ -161,6 +228,8 @@ void *DefaultMemoryManager::alloc(bool user_lock, const unsigned ndims,
     for (unsigned i = 0; i < ndims; ++i) { bytes *= dims[i]; }
 
     void *ptr          = nullptr;
+    bool recommit      = false;
+    vector<free_info> idle;
     size_t alloc_bytes = this->debug_mode
                              ? bytes
                              : (divup(bytes, mem_step_size) * mem_step_size);
@@ -194,23 +263,39 @@ void *DefaultMemoryManager::alloc(bool user_lock, const unsigned ndims,
                 vector<void *> &free_buffer_vector = free_buffer_iter->second;
                 ptr                                = free_buffer_vector.back();
                 free_buffer_vector.pop_back();
+                auto lru_iter = current.lru_map.find(ptr);
+                recommit      = lru_iter->second->decommitted;
+                current.free_lru.erase(lru_iter->second);
+                current.lru_map.erase(lru_iter);
                 current.locked_map[ptr] = info;
                 current.lock_bytes += alloc_bytes;
                 current.lock_buffers++;
+                current.stats.recordAlloc(bytes, alloc_bytes, true);
+                current.stats.updatePeaks(current.total_bytes,
+                                          current.lock_bytes);
             }
+            decommitIdleBuffers(current, idle);
         }
+        decommitBuffers(current, idle);
+
+        // Called outside of the lock as the allocator can wait for the pages
+        // of the buffer being released
+        if (recommit) { this->nativeRecommit(ptr); }
 
         // Only comes here if buffer size not found or in debug mode
         if (ptr == nullptr) {
             // Perform garbage collection if memory can not be allocated
+            NativeTimer timer;
             try {
                 ptr = this->nativeAlloc(alloc_bytes);
             } catch (const AfError &ex) {
                 // If out of memory, run garbage collect and try again
                 if (ex.getError() != AF_ERR_NO_MEM) { throw; }
                 this->signalMemoryCleanup();
-                ptr = this->nativeAlloc(alloc_bytes);
+                timer = NativeTimer();
+                ptr   = this->nativeAlloc(alloc_bytes);
             }
+            current.stats.recordNativeAlloc(timer.elapsed());
             lock_guard_t lock(this->memory_mutex);
             // Increment these two only when it succeeds to come here.
             current.total_bytes += alloc_bytes;
@@ -218,6 +303,8 @@ void *DefaultMemoryManager::alloc(bool user_lock, const unsigned ndims,
             current.locked_map[ptr] = info;
             current.lock_bytes += alloc_bytes;
             current.lock_buffers++;
+            current.stats.recordAlloc(bytes, alloc_bytes, false);
+            current.stats.updatePeaks(current.total_bytes, current.lock_bytes);
         }
     }
 
@@ -226,6 +313,7 @@ void *DefaultMemoryManager::alloc(bool user_lock, const unsigned ndims,
 
 size_t DefaultMemoryManager::allocated(void *ptr) {
     if (!ptr) { return 0; }
+    lock_guard_t lock(this->memory_mutex);
     memory_info &current = this->getCurrentMemoryInfo();
     auto locked_iter     = current.locked_map.find(ptr);
     if (locked_iter == current.locked_map.end()) { return 0; }
@@ -237,11 +325,14 @@ void DefaultMemoryManager::unlock(void *ptr, bool user_unlock) {
     if (!ptr) { return; }
 
     // Frees the pointer outside the lock.
-    uptr_t freed_ptr(nullptr, [this](void *p) { this->nativeFree(p); });
+    const int device = this->getActiveDeviceId();
+    uptr_t freed_ptr(nullptr,
+                     [this, device](void *p) { timedNativeFree(p, device); });
+    vector<void *> evicted;
+    vector<free_info> idle;
+    memory_info &current = this->getCurrentMemoryInfo();
     {
         lock_guard_t lock(this->memory_mutex);
-        memory_info &current = this->getCurrentMemoryInfo();
-
         auto locked_buffer_iter = current.locked_map.find(ptr);
         if (locked_buffer_iter == current.locked_map.end()) {
             // Pointer not found in locked map
@@ -275,10 +366,78 @@ void DefaultMemoryManager::unlock(void *ptr, bool user_unlock) {
                 current.total_bytes -= locked_buffer_info.bytes;
             }
         } else {
+            const auto now = steady_clock::now();
             current.free_map[bytes].emplace_back(ptr);
+            current.free_lru.push_front({ptr, bytes, now, false});
+            current.lru_map[ptr] = current.free_lru.begin();
+            if (bytes >= DECOMMIT_BYTES) {
+                current.idle_queue.emplace_back(ptr, now);
+            }
+            evictFreeBuffers(current, evicted);
+            decommitIdleBuffers(current, idle);
         }
         current.locked_map.erase(locked_buffer_iter);
     }
+    for (void *p : evicted) { timedNativeFree(p, device); }
+    decommitBuffers(current, idle);
+}
+
+void DefaultMemoryManager::evictFreeBuffers(memory_info &current,
+                                            vector<void *> &evicted) {
+    while (!current.free_lru.empty() &&
+           current.total_bytes - current.lock_bytes > this->cache_budget) {
+        const free_info &oldest = current.free_lru.back();
+        vector<void *> &buffers = current.free_map[oldest.bytes];
+        buffers.erase(std::find(begin(buffers), end(buffers), oldest.ptr));
+        current.total_bytes -= oldest.bytes;
+        current.total_buffers--;
+        evicted.push_back(oldest.ptr);
+        current.lru_map.erase(oldest.ptr);
+        current.free_lru.pop_back();
+    }
+}
+
+void DefaultMemoryManager::decommitIdleBuffers(memory_info &current,
+                                               vector<free_info> &idle) {
+    const auto now = steady_clock::now();
+    while (!current.idle_queue.empty() &&
+           now - current.idle_queue.front().second >= DECOMMIT_DELAY) {
+        const auto released = current.idle_queue.front();
+        current.idle_queue.pop_front();
+
+        // Skips the buffers which were freed or reused since
+        auto lru_iter = current.lru_map.find(released.first);
+        if (lru_iter == current.lru_map.end()) { continue; }
+        const free_info &buffer = *lru_iter->second;
+        if (buffer.released != released.second || buffer.decommitted) {
+            continue;
+        }
+
+        // The buffer leaves the cache until it has been decommitted so no
+        // other thread reuses or frees it in the meantime
+        idle.push_back(buffer);
+        idle.back().decommitted = true;
+        vector<void *> &buffers = current.free_map[buffer.bytes];
+        buffers.erase(std::find(begin(buffers), end(buffers), buffer.ptr));
+        current.free_lru.erase(lru_iter->second);
+        current.lru_map.erase(lru_iter);
+    }
+}
+
+void DefaultMemoryManager::decommitBuffers(memory_info &current,
+                                           vector<free_info> &idle) {
+    if (idle.empty()) { return; }
+    for (const free_info &buffer : idle) {
+        this->nativeDecommit(buffer.ptr, buffer.bytes);
+    }
+
+    // The decommitted buffers are the first ones evicted
+    lock_guard_t lock(this->memory_mutex);
+    for (const free_info &buffer : idle) {
+        current.free_map[buffer.bytes].push_back(buffer.ptr);
+        current.free_lru.push_back(buffer);
+        current.lru_map[buffer.ptr] = std::prev(current.free_lru.end());
+    }
 }
 
 void DefaultMemoryManager::signalMemoryCleanup() {
@@ -10,10 +10,15 @@
 #pragma once
 
 #include <common/MemoryManagerBase.hpp>
+#include <common/MemoryStats.hpp>
 #include <common/defines.hpp>
 
+#include <chrono>
+#include <deque>
 #include <functional>
+#include <list>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace arrayfire {
@@ -27,6 +32,7 @@ using uptr_t = std::unique_ptr<void, std::function<void(void *)>>;
 class DefaultMemoryManager final : public common::MemoryManagerBase {
     size_t mem_step_size;
     unsigned max_buffers;
+    size_t cache_budget;
 
     bool debug_mode;
 
@@ -36,19 +42,38 @@ class DefaultMemoryManager final : public common::MemoryManagerBase {
         size_t bytes;
     };
 
+    using time_point = std::chrono::steady_clock::time_point;
+
+    struct free_info {
+        void *ptr;
+        size_t bytes;
+        time_point released;
+        bool decommitted;
+    };
+
     using locked_t = typename std::unordered_map<void *, locked_info>;
     using free_t   = std::unordered_map<size_t, std::vector<void *>>;
+    using lru_t    = std::list<free_info>;
 
     struct memory_info {
         locked_t locked_map;
         free_t free_map;
 
+        // The free buffers, the most recently released first
+        lru_t free_lru;
+        std::unordered_map<void *, lru_t::iterator> lru_map;
+        // The large buffers in the order they were released. The ones reused
+        // since are skipped when they are popped.
+        std::deque<std::pair<void *, time_point>> idle_queue;
+
         size_t max_bytes;
         size_t total_bytes;
         size_t total_buffers;
         size_t lock_bytes;
         size_t lock_buffers;
 
+        MemoryStats stats;
+
         memory_info()
             // Calling getMaxMemorySize() here calls the virtual function
             // that returns 0 Call it from outside the constructor.
@@ -66,6 +91,25 @@ class DefaultMemoryManager final : public common::MemoryManagerBase {
 
     memory_info &getCurrentMemoryInfo();
 
+    /// Calls nativeFree and records the time it took for \p device
+    void timedNativeFree(void *ptr, int device);
+
+    /// Removes the least recently released free buffers of \p current until
+    /// the cache fits the budget. The buffers are appended to \p evicted to be
+    /// freed once the lock is released.
+    void evictFreeBuffers(memory_info &current, std::vector<void *> &evicted);
+
+    /// Takes the large buffers of \p current which have stayed free for long
+    /// out of the cache and appends them to \p idle. Called with the lock
+    /// held when a buffer is allocated or released and when the cache budget
+    /// is set.
+    void decommitIdleBuffers(memory_info &current,
+                             std::vector<free_info> &idle);
+
+    /// Decommits the buffers taken by decommitIdleBuffers and returns them to
+    /// the cache of \p current. Called without the lock.
+    void decommitBuffers(memory_info &current, std::vector<free_info> &idle);
+
    public:
     DefaultMemoryManager(int num_devices, unsigned max_buffers, bool debug);
 
@@ -116,6 +160,10 @@ class DefaultMemoryManager final : public common::MemoryManagerBase {
     bool isUserLocked(const void *ptr) override;
     size_t getMemStepSize() override;
     void setMemStepSize(size_t new_step_size) override;
+    void memoryStats(af_memory_stats *stats) override;
+    void resetMemoryStats() override;
+    void setCacheBudget(size_t bytes) override;
+    size_t getCacheBudget() override;
     float getMemoryPressure() override;
     bool jitTreeExceedsMemoryPressure(size_t bytes) override;
 
@@ -11,6 +11,7 @@
 
 #include <common/AllocatorInterface.hpp>
 #include <af/defines.h>
+#include <af/device.h>
 
 #include <cstddef>
 #include <memory>
@@ -53,6 +54,10 @@ class MemoryManagerBase {
     virtual bool isUserLocked(const void *ptr)                       = 0;
     virtual size_t getMemStepSize()                                  = 0;
     virtual void setMemStepSize(size_t new_step_size)                = 0;
+    virtual void memoryStats(af_memory_stats *stats)                 = 0;
+    virtual void resetMemoryStats()                                  = 0;
+    virtual void setCacheBudget(size_t bytes)                        = 0;
+    virtual size_t getCacheBudget()                                  = 0;
 
     /// Backend-specific functions
     // OpenCL
@@ -63,6 +68,10 @@ class MemoryManagerBase {
     size_t getMaxMemorySize(int id) { return nmi_->getMaxMemorySize(id); }
     void *nativeAlloc(const size_t bytes) { return nmi_->nativeAlloc(bytes); }
     void nativeFree(void *ptr) { nmi_->nativeFree(ptr); }
+    void nativeDecommit(void *ptr, const size_t bytes) {
+        nmi_->nativeDecommit(ptr, bytes);
+    }
+    void nativeRecommit(void *ptr) { nmi_->nativeRecommit(ptr); }
     virtual spdlog::logger *getLogger() final { return nmi_->getLogger(); }
     virtual void setAllocator(std::unique_ptr<AllocatorInterface> nmi) {
         nmi_ = std::move(nmi);
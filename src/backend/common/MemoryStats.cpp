@@ -0,0 +1,141 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/MemoryStats.hpp>
+
+#include <cstring>
+#include <utility>
+
+using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+
+namespace arrayfire {
+namespace common {
+
+namespace {
+
+void raise(std::atomic<std::uint64_t> &peak, size_t value) {
+    std::uint64_t current = peak.load(std::memory_order_relaxed);
+    while (current < value &&
+           !peak.compare_exchange_weak(current, value,
+                                       std::memory_order_relaxed)) {}
+}
+
+void add(std::atomic<std::uint64_t> &counter, std::uint64_t value) {
+    counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+std::uint64_t load(const std::atomic<std::uint64_t> &counter) {
+    return counter.load(std::memory_order_relaxed);
+}
+
+}  // namespace
+
+MemoryStats::MemoryStats(MemoryStats &&other) noexcept {
+    *this = std::move(other);
+}
+
+MemoryStats &MemoryStats::operator=(MemoryStats &&other) noexcept {
+    peak_alloc_bytes   = load(other.peak_alloc_bytes);
+    peak_lock_bytes    = load(other.peak_lock_bytes);
+    alloc_count        = load(other.alloc_count);
+    cache_hits         = load(other.cache_hits);
+    requested_bytes    = load(other.requested_bytes);
+    rounding_bytes     = load(other.rounding_bytes);
+    gc_count           = load(other.gc_count);
+    gc_buffers         = load(other.gc_buffers);
+    gc_bytes           = load(other.gc_bytes);
+    native_alloc_count = load(other.native_alloc_count);
+    native_alloc_ns    = load(other.native_alloc_ns);
+    native_free_count  = load(other.native_free_count);
+    native_free_ns     = load(other.native_free_ns);
+    for (size_t i = 0; i < size_histogram.size(); i++) {
+        size_histogram[i] = load(other.size_histogram[i]);
+    }
+    return *this;
+}
+
+unsigned MemoryStats::histogramBin(size_t bytes) {
+    unsigned bin = 0;
+    for (size_t limit = 1024; bytes >= limit && bin + 1 < AF_MEMORY_STATS_BINS;
+         limit <<= 1) {
+        bin++;
+    }
+    return bin;
+}
+
+void MemoryStats::recordAlloc(size_t requested, size_t bytes, bool hit) {
+    add(alloc_count, 1);
+    if (hit) { add(cache_hits, 1); }
+    add(requested_bytes, requested);
+    add(rounding_bytes, bytes - requested);
+    add(size_histogram[histogramBin(requested)], 1);
+}
+
+void MemoryStats::recordGarbageCollection(size_t buffers, size_t bytes) {
+    add(gc_count, 1);
+    add(gc_buffers, buffers);
+    add(gc_bytes, bytes);
+}
+
+void MemoryStats::recordNativeAlloc(steady_clock::duration time) {
+    add(native_alloc_count, 1);
+    add(native_alloc_ns, duration_cast<nanoseconds>(time).count());
+}
+
+void MemoryStats::recordNativeFree(steady_clock::duration time) {
+    add(native_free_count, 1);
+    add(native_free_ns, duration_cast<nanoseconds>(time).count());
+}
+
+void MemoryStats::updatePeaks(size_t alloc_bytes, size_t lock_bytes) {
+    raise(peak_alloc_bytes, alloc_bytes);
+    raise(peak_lock_bytes, lock_bytes);
+}
+
+void MemoryStats::reset(size_t alloc_bytes, size_t lock_bytes) {
+    *this            = MemoryStats();
+    peak_alloc_bytes = alloc_bytes;
+    peak_lock_bytes  = lock_bytes;
+}
+
+void MemoryStats::read(af_memory_stats *stats, size_t alloc_bytes,
+                       size_t alloc_buffers, size_t lock_bytes,
+                       size_t lock_buffers) const {
+    std::memset(stats, 0, sizeof(*stats));
+    stats->alloc_bytes      = alloc_bytes;
+    stats->alloc_buffers    = alloc_buffers;
+    stats->lock_bytes       = lock_bytes;
+    stats->lock_buffers     = lock_buffers;
+    stats->peak_alloc_bytes = load(peak_alloc_bytes);
+    stats->peak_lock_bytes  = load(peak_lock_bytes);
+
+    stats->alloc_count     = load(alloc_count);
+    stats->cache_hits      = load(cache_hits);
+    stats->cache_misses    = stats->alloc_count - stats->cache_hits;
+    stats->requested_bytes = load(requested_bytes);
+    stats->rounding_bytes  = load(rounding_bytes);
+
+    stats->gc_count   = load(gc_count);
+    stats->gc_buffers = load(gc_buffers);
+    stats->gc_bytes   = load(gc_bytes);
+
+    stats->native_alloc_count = load(native_alloc_count);
+    stats->native_alloc_time  = load(native_alloc_ns) * 1e-9;
+    stats->native_free_count  = load(native_free_count);
+    stats->native_free_time   = load(native_free_ns) * 1e-9;
+
+    for (unsigned i = 0; i < AF_MEMORY_STATS_BINS; i++) {
+        stats->size_histogram[i] = load(size_histogram[i]);
+    }
+}
+
+}  // namespace common
+}  // namespace arrayfire
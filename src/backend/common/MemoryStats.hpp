@@ -0,0 +1,93 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <af/device.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace arrayfire {
+namespace common {
+
+/// The statistics of a memory manager for one device
+///
+/// The counters can be updated concurrently without locks. The usage totals
+/// are not stored here: the memory managers pass them to \ref updatePeaks
+/// and \ref read.
+class MemoryStats {
+   public:
+    MemoryStats() = default;
+
+    /// Copies the counters. Used when the memory managers grow their list of
+    /// devices.
+    MemoryStats(MemoryStats &&other) noexcept;
+    MemoryStats &operator=(MemoryStats &&other) noexcept;
+
+    /// Records a request of \p requested bytes served by a buffer of
+    /// \p bytes bytes. \p hit is true if the buffer was reused.
+    void recordAlloc(size_t requested, size_t bytes, bool hit);
+
+    /// Records a garbage collection releasing \p buffers buffers of \p bytes
+    /// bytes in total
+    void recordGarbageCollection(size_t buffers, size_t bytes);
+
+    void recordNativeAlloc(std::chrono::steady_clock::duration time);
+    void recordNativeFree(std::chrono::steady_clock::duration time);
+
+    /// Raises the peaks to the current usage
+    void updatePeaks(size_t alloc_bytes, size_t lock_bytes);
+
+    /// Clears the counters. The peaks restart from the current usage.
+    void reset(size_t alloc_bytes, size_t lock_bytes);
+
+    /// Fills \p stats with the counters and the current usage
+    void read(af_memory_stats *stats, size_t alloc_bytes, size_t alloc_buffers,
+              size_t lock_bytes, size_t lock_buffers) const;
+
+    /// Returns the bin of the size histogram counting \p bytes
+    static unsigned histogramBin(size_t bytes);
+
+   private:
+    using counter_t = std::atomic<std::uint64_t>;
+
+    counter_t peak_alloc_bytes{0};
+    counter_t peak_lock_bytes{0};
+    counter_t alloc_count{0};
+    counter_t cache_hits{0};
+    counter_t requested_bytes{0};
+    counter_t rounding_bytes{0};
+    counter_t gc_count{0};
+    counter_t gc_buffers{0};
+    counter_t gc_bytes{0};
+    counter_t native_alloc_count{0};
+    counter_t native_alloc_ns{0};
+    counter_t native_free_count{0};
+    counter_t native_free_ns{0};
+    std::array<counter_t, AF_MEMORY_STATS_BINS> size_histogram{};
+};
+
+/// Measures the time spent in a call to the device API
+class NativeTimer {
+    std::chrono::steady_clock::time_point start;
+
+   public:
+    NativeTimer() : start(std::chrono::steady_clock::now()) {}
+
+    std::chrono::steady_clock::duration elapsed() const {
+        return std::chrono::steady_clock::now() - start;
+    }
+};
+
+}  // namespace common
+}  // namespace arrayfire
@@ -0,0 +1,543 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/SizeClassMemoryManager.hpp>
+
+#include <common/Logger.hpp>
+#include <common/dispatch.hpp>
+#include <common/err_common.hpp>
+#include <common/util.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <utility>
+
+using std::make_shared;
+using std::make_unique;
+using std::max;
+using std::shared_ptr;
+using std::stoi;
+using std::stoull;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace arrayfire {
+namespace common {
+
+namespace {
+
+/// The largest buffers kept in the thread caches
+constexpr size_t MAX_THREAD_CACHED_BYTES = 1 << 20;
+
+/// The maximum number of buffers of a class in a thread cache
+constexpr size_t MAX_THREAD_CACHED_BUFFERS = 16;
+
+/// The maximum number of bytes in a thread cache of a device
+constexpr size_t MAX_THREAD_CACHE_BYTES = 16 << 20;
+
+std::atomic<std::uint64_t> next_manager_id{1};
+
+unsigned floorLog2(size_t value) {
+    unsigned result = 0;
+    while (value >>= 1) { result++; }
+    return result;
+}
+
+template<typename T>
+vector<T> &getList(vector<vector<T>> &lists, unsigned index) {
+    if (lists.size() <= index) { lists.resize(index + 1); }
+    return lists[index];
+}
+
+}  // namespace
+
+SizeClassMemoryManager::SizeClassMemoryManager(int num_devices,
+                                               unsigned max_buffers, bool debug)
+    : id(next_manager_id++)
+    , max_buffers([max_buffers] {
+        const string env_var = getEnvVar("AF_MAX_BUFFERS");
+        return env_var.empty() ? max_buffers
+                               : static_cast<unsigned>(max(1, stoi(env_var)));
+    }())
+    , mem_step_size(1024)
+    , cache_budget(std::numeric_limits<size_t>::max())
+    , debug_mode(debug) {
+    string env_var = getEnvVar("AF_MEM_DEBUG");
+    if (!env_var.empty()) { debug_mode = env_var[0] != '0'; }
+    if (debug_mode) { mem_step_size = 1; }
+
+    env_var = getEnvVar("AF_MEM_CACHE_BUDGET");
+    if (!env_var.empty()) { cache_budget = stoull(env_var); }
+
+    memory.reserve(num_devices);
+    for (int i = 0; i < num_devices; i++) {
+        memory.push_back(make_unique<memory_info>());
+    }
+}
+
+SizeClassMemoryManager::~SizeClassMemoryManager() = default;
+
+unsigned SizeClassMemoryManager::sizeClass(size_t bytes, size_t step_size,
+                                           size_t *class_bytes) {
+    const size_t units = max<size_t>(1, divup(bytes, step_size));
+    if (units <= 4) {
+        *class_bytes = units * step_size;
+        return static_cast<unsigned>(units - 1);
+    }
+
+    // The classes between 2^p and 2^(p+1) units are 2^(p-2) units apart
+    const unsigned p      = floorLog2(units - 1);
+    const size_t spacing  = size_t(1) << (p - 2);
+    const size_t multiple = divup(units, spacing);
+    *class_bytes          = multiple * spacing * step_size;
+    return static_cast<unsigned>(4 * (p - 1) + multiple - 5);
+}
+
+size_t SizeClassMemoryManager::classBytes(unsigned size_class,
+                                          size_t step_size) {
+    if (size_class < 4) { return (size_class + 1) * step_size; }
+    const unsigned p      = 2 + (size_class - 4) / 4;
+    const size_t multiple = 5 + (size_class - 4) % 4;
+    return multiple * (size_t(1) << (p - 2)) * step_size;
+}
+
+SizeClassMemoryManager::Shard &SizeClassMemoryManager::getShard(
+    const void *ptr) {
+    const auto bits = reinterpret_cast<std::uintptr_t>(ptr);
+    return shards[((bits >> 6) ^ (bits >> 12) ^ (bits >> 20)) % NUM_SHARDS];
+}
+
+SizeClassMemoryManager::memory_info &SizeClassMemoryManager::getMemoryInfo(
+    int device) {
+    return *memory[device];
+}
+
+SizeClassMemoryManager::ThreadCache &SizeClassMemoryManager::getThreadCache(
+    int device) {
+    struct Slot {
+        std::uint64_t manager;
+        int device;
+        shared_ptr<ThreadCache> cache;
+    };
+    // The slots of destroyed managers are never matched again
+    thread_local vector<Slot> slots;
+    for (Slot &slot : slots) {
+        if (slot.manager == id && slot.device == device) { return *slot.cache; }
+    }
+
+    auto cache           = make_shared<ThreadCache>();
+    memory_info &current = getMemoryInfo(device);
+    {
+        lock_guard_t lock(current.memory_mutex);
+        current.caches.push_back(cache);
+    }
+    slots.push_back({id, device, cache});
+    return *cache;
+}
+
+void SizeClassMemoryManager::initialize() {
+    for (unsigned n = 0; n < memory.size(); n++) {
+        // Same limits as DefaultMemoryManager::setMaxMemorySize
+        size_t memsize       = this->getMaxMemorySize(static_cast<int>(n));
+        memory_info &current = getMemoryInfo(n);
+        lock_guard_t lock(current.memory_mutex);
+        current.max_bytes =
+            memsize == 0
+                ? ONE_GB
+                : max(memsize * 0.75, static_cast<double>(memsize - ONE_GB));
+        AF_TRACE("memory[{}].max_bytes: {}", n,
+                 bytesToString(current.max_bytes));
+    }
+}
+
+void SizeClassMemoryManager::shutdown() { signalMemoryCleanup(); }
+
+void SizeClassMemoryManager::addMemoryManagement(int device) {
+    if (static_cast<size_t>(device) < memory.size()) { return; }
+    const size_t count = memory.size() + device + 1;
+    while (memory.size() < count) {
+        memory.push_back(make_unique<memory_info>());
+    }
+}
+
+void SizeClassMemoryManager::removeMemoryManagement(int device) {
+    if (static_cast<size_t>(device) >= memory.size()) {
+        AF_ERROR("No matching device found", AF_ERR_ARG);
+    }
+    cleanDeviceMemoryManager(device);
+}
+
+void *SizeClassMemoryManager::nativeAllocOrCollect(size_t bytes,
+                                                   MemoryStats &stats) {
+    NativeTimer timer;
+    void *ptr = nullptr;
+    try {
+        ptr = this->nativeAlloc(bytes);
+    } catch (const AfError &ex) {
+        // If out of memory, run garbage collect and try again
+        if (ex.getError() != AF_ERR_NO_MEM) { throw; }
+        this->signalMemoryCleanup();
+        timer = NativeTimer();
+        ptr   = this->nativeAlloc(bytes);
+    }
+    stats.recordNativeAlloc(timer.elapsed());
+    return ptr;
+}
+
+void SizeClassMemoryManager::timedNativeFree(void *ptr, MemoryStats &stats) {
+    NativeTimer timer;
+    this->nativeFree(ptr);
+    stats.recordNativeFree(timer.elapsed());
+}
+
+void *SizeClassMemoryManager::alloc(bool user_lock, const unsigned ndims,
+                                    dim_t *dims, const unsigned element_size) {
+    size_t bytes = element_size;
+    for (unsigned i = 0; i < ndims; ++i) { bytes *= dims[i]; }
+    if (bytes == 0) { return nullptr; }
+
+    const int device     = this->getActiveDeviceId();
+    memory_info &current = getMemoryInfo(device);
+    void *ptr            = nullptr;
+    size_t alloc_bytes   = bytes;
+    unsigned size_class  = 0;
+
+    // There is no memory cache in debug mode
+    if (!debug_mode) {
+        size_class = sizeClass(bytes, mem_step_size, &alloc_bytes);
+        if (current.lock_bytes >= current.max_bytes ||
+            current.total_buffers >= max_buffers) {
+            AF_TRACE(
+                "Running GC: current.lock_bytes({}) >= "
+                "current.max_bytes({}) || current.total_buffers({}) >= "
+                "this->max_buffers({})\n",
+                current.lock_bytes.load(), current.max_bytes,
+                current.total_buffers.load(), max_buffers);
+            this->signalMemoryCleanup();
+        }
+
+        if (alloc_bytes <= MAX_THREAD_CACHED_BYTES) {
+            ThreadCache &cache = getThreadCache(device);
+            lock_guard_t lock(cache.cache_mutex);
+            vector<void *> &list = getList(cache.buffers, size_class);
+            if (!list.empty()) {
+                ptr = list.back();
+                list.pop_back();
+                cache.bytes -= alloc_bytes;
+            }
+        }
+        if (ptr == nullptr) {
+            lock_guard_t lock(current.memory_mutex);
+            vector<void *> &list = getList(current.free_lists, size_class);
+            if (!list.empty()) {
+                ptr = list.back();
+                list.pop_back();
+            }
+        }
+    }
+
+    const bool hit = ptr != nullptr;
+    if (!hit) {
+        ptr = nativeAllocOrCollect(alloc_bytes, current.stats);
+        current.total_bytes += alloc_bytes;
+        current.total_buffers++;
+    }
+
+    {
+        Shard &shard = getShard(ptr);
+        lock_guard_t lock(shard.shard_mutex);
+        shard.locked_map[ptr] = {!user_lock, user_lock, device, size_class,
+                                 alloc_bytes};
+    }
+    current.lock_bytes += alloc_bytes;
+    current.lock_buffers++;
+    current.stats.recordAlloc(bytes, alloc_bytes, hit);
+    current.stats.updatePeaks(current.total_bytes, current.lock_bytes);
+    return ptr;
+}
+
+size_t SizeClassMemoryManager::allocated(void *ptr) {
+    if (!ptr) { return 0; }
+    Shard &shard = getShard(ptr);
+    lock_guard_t lock(shard.shard_mutex);
+    auto locked_iter = shard.locked_map.find(ptr);
+    if (locked_iter == shard.locked_map.end()) { return 0; }
+    return locked_iter->second.bytes;
+}
+
+void SizeClassMemoryManager::unlock(void *ptr, bool user_unlock) {
+    // Shortcut for empty arrays
+    if (!ptr) { return; }
+
+    locked_info info{};
+    {
+        Shard &shard = getShard(ptr);
+        lock_guard_t lock(shard.shard_mutex);
+        auto locked_iter = shard.locked_map.find(ptr);
+        if (locked_iter == shard.locked_map.end()) {
+            // Pointer not found in locked map. Probably came from user, just
+            // free it
+            info.bytes = 0;
+        } else {
+            locked_info &locked = locked_iter->second;
+            (user_unlock ? locked.user_lock : locked.manager_lock) = false;
+
+            // Return early if either one is locked
+            if (locked.user_lock || locked.manager_lock) { return; }
+            info = locked;
+            shard.locked_map.erase(locked_iter);
+        }
+    }
+
+    // The buffers locked by userLock without being allocated here belong to
+    // the user
+    if (info.bytes == 0) {
+        timedNativeFree(ptr, getMemoryInfo(this->getActiveDeviceId()).stats);
+        return;
+    }
+    release(ptr, info);
+}
+
+void SizeClassMemoryManager::release(void *ptr, const locked_info &info) {
+    memory_info &current = getMemoryInfo(info.device);
+    current.lock_bytes -= info.bytes;
+    current.lock_buffers--;
+
+    if (debug_mode) {
+        current.total_bytes -= info.bytes;
+        current.total_buffers--;
+        timedNativeFree(ptr, current.stats);
+        return;
+    }
+
+    if (info.bytes <= MAX_THREAD_CACHED_BYTES) {
+        ThreadCache &cache = getThreadCache(info.device);
+        lock_guard_t lock(cache.cache_mutex);
+        vector<void *> &list = getList(cache.buffers, info.size_class);
+        if (list.size() < MAX_THREAD_CACHED_BUFFERS &&
+            cache.bytes + info.bytes <= MAX_THREAD_CACHE_BYTES) {
+            list.push_back(ptr);
+            cache.bytes += info.bytes;
+            return;
+        }
+    }
+
+    vector<void *> evicted;
+    {
+        lock_guard_t lock(current.memory_mutex);
+        getList(current.free_lists, info.size_class).push_back(ptr);
+        evictFreeBuffers(current, evicted);
+    }
+    for (void *p : evicted) { timedNativeFree(p, current.stats); }
+}
+
+void SizeClassMemoryManager::evictFreeBuffers(memory_info &current,
+                                              vector<void *> &evicted) {
+    const size_t step = mem_step_size;
+    auto size_class   = static_cast<unsigned>(current.free_lists.size());
+    while (size_class > 0 &&
+           current.total_bytes - current.lock_bytes > cache_budget) {
+        vector<void *> &list = current.free_lists[size_class - 1];
+        if (list.empty()) {
+            size_class--;
+            continue;
+        }
+        evicted.push_back(list.back());
+        list.pop_back();
+        current.total_bytes -= classBytes(size_class - 1, step);
+        current.total_buffers--;
+    }
+}
+
+void SizeClassMemoryManager::cleanDeviceMemoryManager(int device) {
+    if (debug_mode) { return; }
+
+    // The buffers are freed outside of the locks because the CPU backend
+    // calls sync
+    vector<void *> free_ptrs;
+    size_t bytes_freed   = 0;
+    const size_t step    = mem_step_size;
+    memory_info &current = getMemoryInfo(device);
+    auto collect         = [&](vector<vector<void *>> &lists) {
+        for (unsigned c = 0; c < lists.size(); c++) {
+            if (lists[c].empty()) { continue; }
+            bytes_freed += lists[c].size() * classBytes(c, step);
+            std::move(begin(lists[c]), end(lists[c]),
+                      back_inserter(free_ptrs));
+            lists[c].clear();
+        }
+    };
+
+    {
+        lock_guard_t lock(current.memory_mutex);
+        collect(current.free_lists);
+        for (shared_ptr<ThreadCache> &cache : current.caches) {
+            lock_guard_t cache_lock(cache->cache_mutex);
+            collect(cache->buffers);
+            cache->bytes = 0;
+        }
+        // The caches of the threads which exited are not used anymore
+        current.caches.erase(
+            std::remove_if(current.caches.begin(), current.caches.end(),
+                           [](const shared_ptr<ThreadCache> &cache) {
+                               return cache.use_count() == 1;
+                           }),
+            current.caches.end());
+    }
+    current.total_bytes -= bytes_freed;
+    current.total_buffers -= free_ptrs.size();
+    current.stats.recordGarbageCollection(free_ptrs.size(), bytes_freed);
+
+    AF_TRACE("GC: Clearing {} buffers {}", free_ptrs.size(),
+             bytesToString(bytes_freed));
+    for (void *ptr : free_ptrs) { timedNativeFree(ptr, current.stats); }
+}
+
+void SizeClassMemoryManager::signalMemoryCleanup() {
+    cleanDeviceMemoryManager(this->getActiveDeviceId());
+}
+
+void SizeClassMemoryManager::printInfo(const char *msg, const int device) {
+    UNUSED(device);
+    const int active = this->getActiveDeviceId();
+
+    printf("%s\n", msg);
+    printf(
+        "---------------------------------------------------------\n"
+        "|     POINTER      |    SIZE    |  AF LOCK  | USER LOCK |\n"
+        "---------------------------------------------------------\n");
+
+    for (Shard &shard : shards) {
+        lock_guard_t lock(shard.shard_mutex);
+        for (const auto &kv : shard.locked_map) {
+            if (kv.second.device != active) { continue; }
+            const char *unit = "KB";
+            double size      = static_cast<double>(kv.second.bytes) / 1024;
+            if (size >= 1024) {
+                size = size / 1024;
+                unit = "MB";
+            }
+            printf("|  %14p  |  %6.f %s | %9s | %9s |\n", kv.first, size, unit,
+                   kv.second.manager_lock ? "Yes" : " No",
+                   kv.second.user_lock ? "Yes" : " No");
+        }
+    }
+
+    printf("---------------------------------------------------------\n");
+}
+
+void SizeClassMemoryManager::usageInfo(size_t *alloc_bytes,
+                                       size_t *alloc_buffers,
+                                       size_t *lock_bytes,
+                                       size_t *lock_buffers) {
+    const memory_info &current = getMemoryInfo(this->getActiveDeviceId());
+    if (alloc_bytes) { *alloc_bytes = current.total_bytes; }
+    if (alloc_buffers) { *alloc_buffers = current.total_buffers; }
+    if (lock_bytes) { *lock_bytes = current.lock_bytes; }
+    if (lock_buffers) { *lock_buffers = current.lock_buffers; }
+}
+
+void SizeClassMemoryManager::userLock(const void *ptr) {
+    void *key    = const_cast<void *>(ptr);
+    Shard &shard = getShard(key);
+    lock_guard_t lock(shard.shard_mutex);
+    auto locked_iter = shard.locked_map.find(key);
+    if (locked_iter != shard.locked_map.end()) {
+        locked_iter->second.user_lock = true;
+    } else {
+        shard.locked_map[key] = {false, true, this->getActiveDeviceId(), 0, 0};
+    }
+}
+
+void SizeClassMemoryManager::userUnlock(const void *ptr) {
+    this->unlock(const_cast<void *>(ptr), true);
+}
+
+bool SizeClassMemoryManager::isUserLocked(const void *ptr) {
+    void *key    = const_cast<void *>(ptr);
+    Shard &shard = getShard(key);
+    lock_guard_t lock(shard.shard_mutex);
+    auto locked_iter = shard.locked_map.find(key);
+    if (locked_iter == shard.locked_map.end()) { return false; }
+    return locked_iter->second.user_lock;
+}
+
+size_t SizeClassMemoryManager::getMemStepSize() { return mem_step_size; }
+
+void SizeClassMemoryManager::setMemStepSize(size_t new_step_size) {
+    // The cached buffers were sized with the previous step size
+    for (unsigned n = 0; n < memory.size(); n++) {
+        cleanDeviceMemoryManager(static_cast<int>(n));
+    }
+    mem_step_size = max<size_t>(1, new_step_size);
+}
+
+void SizeClassMemoryManager::memoryStats(af_memory_stats *stats) {
+    const memory_info &current = getMemoryInfo(this->getActiveDeviceId());
+    current.stats.read(stats, current.total_bytes, current.total_buffers,
+                       current.lock_bytes, current.lock_buffers);
+}
+
+void SizeClassMemoryManager::resetMemoryStats() {
+    memory_info &current = getMemoryInfo(this->getActiveDeviceId());
+    current.stats.reset(current.total_bytes, current.lock_bytes);
+}
+
+void SizeClassMemoryManager::setCacheBudget(size_t bytes) {
+    // The other devices fit the budget the next time they release a buffer
+    cache_budget         = bytes;
+    memory_info &current = getMemoryInfo(this->getActiveDeviceId());
+    if (debug_mode) { return; }
+
+    vector<void *> evicted;
+    {
+        lock_guard_t lock(current.memory_mutex);
+        evictFreeBuffers(current, evicted);
+    }
+    for (void *ptr : evicted) { timedNativeFree(ptr, current.stats); }
+}
+
+size_t SizeClassMemoryManager::getCacheBudget() { return cache_budget; }
+
+float SizeClassMemoryManager::getMemoryPressure() {
+    const memory_info &current = getMemoryInfo(this->getActiveDeviceId());
+    if (current.lock_bytes > current.max_bytes ||
+        current.lock_buffers > max_buffers) {
+        return 1.0;
+    } else {
+        return 0.0;
+    }
+}
+
+bool SizeClassMemoryManager::jitTreeExceedsMemoryPressure(
+    size_t jit_tree_buffer_bytes) {
+    const memory_info &current = getMemoryInfo(this->getActiveDeviceId());
+    const size_t lock_bytes    = current.lock_bytes;
+    if (lock_bytes > 0.25f * current.max_bytes) {
+        return jit_tree_buffer_bytes > lock_bytes * 0.5f;
+    } else {
+        return jit_tree_buffer_bytes > 0.10f * current.max_bytes;
+    }
+}
+
+unique_ptr<MemoryManagerBase> createDefaultMemoryManager(int num_devices,
+                                                         unsigned max_buffers,
+                                                         bool debug) {
+    if (getEnvVar("AF_MEM_SIZE_CLASSES") == "1") {
+        return make_unique<SizeClassMemoryManager>(num_devices, max_buffers,
+                                                   debug);
+    }
+    return make_unique<DefaultMemoryManager>(num_devices, max_buffers, debug);
+}
+
+}  // namespace common
+}  // namespace arrayfire
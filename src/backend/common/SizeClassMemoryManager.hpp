@@ -0,0 +1,148 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/DefaultMemoryManager.hpp>
+#include <common/MemoryManagerBase.hpp>
+#include <common/MemoryStats.hpp>
+#include <common/defines.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace arrayfire {
+namespace common {
+
+/// A memory manager caching the free buffers by size class
+///
+/// The requested sizes are rounded up to a class. There are four classes
+/// between consecutive powers of two of the memory step size so a buffer is
+/// reused by any request at most 25% smaller than it. Each thread keeps the
+/// free buffers of the small classes it released in a cache of its own, so
+/// most allocations of a thread do not touch the state shared with other
+/// threads. The buffers in use are tracked by maps split in shards with their
+/// own locks.
+///
+/// The usage information and the garbage collection behave like the ones of
+/// DefaultMemoryManager. The buffers in the thread caches are allocated but
+/// not locked. The recency of the free buffers is not tracked, so the cache
+/// budget evicts the largest buffers of the shared free lists first. The
+/// thread caches are bounded on their own and are not evicted.
+class SizeClassMemoryManager final : public common::MemoryManagerBase {
+   public:
+    SizeClassMemoryManager(int num_devices, unsigned max_buffers, bool debug);
+    ~SizeClassMemoryManager();
+
+    void initialize() override;
+    void shutdown() override;
+    void addMemoryManagement(int device) override;
+    void removeMemoryManagement(int device) override;
+
+    void *alloc(bool user_lock, const unsigned ndims, dim_t *dims,
+                const unsigned element_size) override;
+    size_t allocated(void *ptr) override;
+    void unlock(void *ptr, bool user_unlock) override;
+    void signalMemoryCleanup() override;
+    void printInfo(const char *msg, const int device) override;
+    void usageInfo(size_t *alloc_bytes, size_t *alloc_buffers,
+                   size_t *lock_bytes, size_t *lock_buffers) override;
+    void userLock(const void *ptr) override;
+    void userUnlock(const void *ptr) override;
+    bool isUserLocked(const void *ptr) override;
+    size_t getMemStepSize() override;
+    void setMemStepSize(size_t new_step_size) override;
+    void memoryStats(af_memory_stats *stats) override;
+    void resetMemoryStats() override;
+    void setCacheBudget(size_t bytes) override;
+    size_t getCacheBudget() override;
+    float getMemoryPressure() override;
+    bool jitTreeExceedsMemoryPressure(size_t bytes) override;
+
+    /// Returns the size class of a request of \p bytes bytes and stores the
+    /// size of the buffers of the class in \p class_bytes
+    static unsigned sizeClass(size_t bytes, size_t step_size,
+                              size_t *class_bytes);
+
+    /// Returns the size of the buffers of \p size_class
+    static size_t classBytes(unsigned size_class, size_t step_size);
+
+   private:
+    /// The free buffers of a thread for one device, indexed by size class
+    struct ThreadCache {
+        // Only contended when the garbage collection drains the cache
+        mutex_t cache_mutex;
+        std::vector<std::vector<void *>> buffers;
+        size_t bytes = 0;
+    };
+
+    struct locked_info {
+        bool manager_lock;
+        bool user_lock;
+        int device;
+        unsigned size_class;
+        size_t bytes;
+    };
+
+    struct Shard {
+        mutex_t shard_mutex;
+        std::unordered_map<void *, locked_info> locked_map;
+    };
+
+    struct memory_info {
+        // Guards free_lists, caches and max_bytes
+        mutex_t memory_mutex;
+        std::vector<std::vector<void *>> free_lists;
+        std::vector<std::shared_ptr<ThreadCache>> caches;
+        size_t max_bytes = ONE_GB;
+
+        std::atomic<size_t> total_bytes{0};
+        std::atomic<size_t> total_buffers{0};
+        std::atomic<size_t> lock_bytes{0};
+        std::atomic<size_t> lock_buffers{0};
+
+        MemoryStats stats;
+    };
+
+    static constexpr size_t NUM_SHARDS = 16;
+
+    Shard &getShard(const void *ptr);
+    memory_info &getMemoryInfo(int device);
+    ThreadCache &getThreadCache(int device);
+    void *nativeAllocOrCollect(size_t bytes, MemoryStats &stats);
+    void timedNativeFree(void *ptr, MemoryStats &stats);
+    void release(void *ptr, const locked_info &info);
+    void evictFreeBuffers(memory_info &current, std::vector<void *> &evicted);
+    void cleanDeviceMemoryManager(int device);
+
+    /// Identifies the manager in the thread caches. Unlike the address of
+    /// the manager it is never reused.
+    const std::uint64_t id;
+    const unsigned max_buffers;
+    std::atomic<size_t> mem_step_size;
+    std::atomic<size_t> cache_budget;
+    bool debug_mode;
+
+    std::array<Shard, NUM_SHARDS> shards;
+    std::vector<std::unique_ptr<memory_info>> memory;
+};
+
+/// Creates the memory manager used when no custom memory manager is set
+///
+/// A SizeClassMemoryManager is created when the AF_MEM_SIZE_CLASSES
+/// environment variable is set to 1 and a DefaultMemoryManager otherwise.
+std::unique_ptr<MemoryManagerBase> createDefaultMemoryManager(
+    int num_devices, unsigned max_buffers, bool debug);
+
+}  // namespace common
+}  // namespace arrayfire
@@ -9,8 +9,6 @@
 
 #pragma once
 
-#if !defined(AF_CPU)
-
 #include <Module.hpp>
 #include <backend.hpp>
 
@@ -65,5 +63,3 @@ detail::Module loadModuleFromDisk(const int device,
 
 }  // namespace common
 }  // namespace arrayfire
-
-#endif
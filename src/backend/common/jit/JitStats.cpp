@@ -0,0 +1,96 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/jit/JitStats.hpp>
+
+#include <backend.hpp>
+#include <platform.hpp>
+
+#include <memory>
+
+using std::atomic;
+using std::make_shared;
+using std::shared_ptr;
+using std::unique_ptr;
+
+namespace arrayfire {
+namespace common {
+
+namespace {
+
+void updateMax(atomic<uint64_t> &value, uint64_t candidate) {
+    uint64_t current = value.load(std::memory_order_relaxed);
+    while (current < candidate &&
+           !value.compare_exchange_weak(current, candidate,
+                                        std::memory_order_relaxed)) {}
+}
+
+void add(atomic<uint64_t> &value, uint64_t increment) {
+    value.fetch_add(increment, std::memory_order_relaxed);
+}
+
+void record(JitStats &stats, const JitEvalInfo &info) {
+    add(stats.evaluations, 1);
+    add(stats.nodes, info.nodes);
+    updateMax(stats.max_nodes, info.nodes);
+    add(stats.heights, info.height);
+    updateMax(stats.max_height, info.height);
+    add(stats.buffers_read, info.buffers_read);
+    add(stats.buffers_written, info.buffers_written);
+    add(stats.bytes_written, info.bytes_written);
+    add(stats.eval_time_ns, info.time_ns);
+}
+
+void record(JitStats &stats, kJITHeuristics reason) {
+    switch (reason) {
+        case kJITHeuristics::Pass: break;
+        case kJITHeuristics::TreeHeight: add(stats.height_evals, 1); break;
+        case kJITHeuristics::KernelParameterSize:
+            add(stats.parameter_evals, 1);
+            break;
+        case kJITHeuristics::MemoryPressure: add(stats.memory_evals, 1); break;
+    }
+}
+
+}  // namespace
+
+void JitStats::reset() {
+    for (atomic<uint64_t> *value :
+         {&evaluations, &height_evals, &parameter_evals, &memory_evals, &nodes,
+          &max_nodes, &heights, &max_height, &buffers_read, &buffers_written,
+          &bytes_written, &eval_time_ns}) {
+        value->store(0, std::memory_order_relaxed);
+    }
+}
+
+const shared_ptr<JitStats> &getThreadJitStats() {
+    thread_local shared_ptr<JitStats> stats = make_shared<JitStats>();
+    return stats;
+}
+
+JitStats &getDeviceJitStats(int device) {
+    static unique_ptr<JitStats[]> stats(
+        new JitStats[detail::getDeviceCount()]);
+    return stats[device];
+}
+
+void recordJitHeuristic(kJITHeuristics reason) {
+    record(*getThreadJitStats(), reason);
+    record(getDeviceJitStats(static_cast<int>(detail::getActiveDeviceId())),
+           reason);
+}
+
+void recordJitEval(JitStats *thread_stats, int device,
+                   const JitEvalInfo &info) {
+    if (thread_stats) { record(*thread_stats, info); }
+    record(getDeviceJitStats(device), info);
+}
+
+}  // namespace common
+}  // namespace arrayfire
@@ -0,0 +1,84 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <common/jit/Node.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace arrayfire {
+namespace common {
+
+/// Counters describing how the JIT trees are evaluated. Kernels can run on
+/// other threads than the one which created their trees so the counters are
+/// atomic.
+struct JitStats {
+    /// The kernels evaluating JIT trees
+    std::atomic<uint64_t> evaluations{0};
+
+    /// The trees evaluated early because they reached the maximum height
+    std::atomic<uint64_t> height_evals{0};
+
+    /// The trees evaluated early because of the size of the kernel parameters
+    std::atomic<uint64_t> parameter_evals{0};
+
+    /// The trees evaluated early because of memory pressure
+    std::atomic<uint64_t> memory_evals{0};
+
+    /// The nodes evaluated by all the kernels and by the largest one
+    std::atomic<uint64_t> nodes{0};
+    std::atomic<uint64_t> max_nodes{0};
+
+    /// The sum of the heights of the evaluated trees and the largest height
+    std::atomic<uint64_t> heights{0};
+    std::atomic<uint64_t> max_height{0};
+
+    /// The buffers read and written by all the kernels
+    std::atomic<uint64_t> buffers_read{0};
+    std::atomic<uint64_t> buffers_written{0};
+
+    /// The bytes written by all the kernels
+    std::atomic<uint64_t> bytes_written{0};
+
+    /// The time spent evaluating the trees in nanoseconds
+    std::atomic<uint64_t> eval_time_ns{0};
+
+    void reset();
+};
+
+/// Describes the evaluation of a single JIT kernel
+struct JitEvalInfo {
+    int nodes;
+    int height;
+    int buffers_read;
+    int buffers_written;
+    size_t bytes_written;
+    uint64_t time_ns;
+};
+
+/// Returns the counters of the trees created by the calling thread. Kernels
+/// evaluated asynchronously keep a copy of the pointer to update them.
+const std::shared_ptr<JitStats> &getThreadJitStats();
+
+/// Returns the counters of the trees evaluated on \p device
+JitStats &getDeviceJitStats(int device);
+
+/// Counts a tree evaluated early for \p reason on the active device
+void recordJitHeuristic(kJITHeuristics reason);
+
+/// Counts a kernel evaluated on \p device for the thread owning
+/// \p thread_stats. \p thread_stats can be null.
+void recordJitEval(JitStats *thread_stats, int device,
+                   const JitEvalInfo &info);
+
+}  // namespace common
+}  // namespace arrayfire
@@ -26,6 +26,12 @@ class ModdimNode : public NaryNode {
                       "ModdimNode is not move constructible");
     }
 
+    bool isEquivalent(const Node& other) const noexcept final {
+        return NaryNode::isEquivalent(other) &&
+               m_new_shape ==
+                   static_cast<const ModdimNode&>(other).m_new_shape;
+    }
+
     virtual std::unique_ptr<Node> clone() noexcept final {
         return std::make_unique<ModdimNode>(*this);
     }
@@ -12,10 +12,12 @@
 #include <Array.hpp>
 #include <backend.hpp>
 #include <common/defines.hpp>
+#include <common/jit/JitStats.hpp>
 #include <common/jit/Node.hpp>
 
 #include <nonstd/span.hpp>
 #include <array>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 #include <string>
@@ -45,6 +47,12 @@ class NaryNode : public Node {
         , m_num_children(num_children)
         , m_op_str(op_str)
         , m_op(op) {
+        // The nodes of an operation can call different functions, such as
+        // the casts to each type
+        mixHash(static_cast<size_t>(op));
+        for (const char *c = op_str; *c; c++) {
+            mixHash(static_cast<unsigned char>(*c));
+        }
         static_assert(std::is_nothrow_move_assignable<NaryNode>::value,
                       "NaryNode is not move assignable");
         static_assert(std::is_nothrow_move_constructible<NaryNode>::value,
@@ -71,6 +79,19 @@ class NaryNode : public Node {
 
     af_op_t getOp() const noexcept final { return m_op; }
 
+    /// Nary nodes are equivalent if they apply the same function to
+    /// equivalent children. The CPU backend only creates Nary nodes of its
+    /// own for operations other than af_moddims_t.
+    bool isEquivalent(const Node &other) const noexcept override {
+        if (other.getNodeType() != kNodeType::Nary || other.getOp() != m_op ||
+            other.getType() != m_type) {
+            return false;
+        }
+        const auto &node = static_cast<const NaryNode &>(other);
+        return m_num_children == node.m_num_children &&
+               std::strcmp(m_op_str, node.m_op_str) == 0;
+    }
+
     virtual std::unique_ptr<Node> clone() override {
         return std::make_unique<NaryNode>(*this);
     }
@@ -113,7 +134,9 @@ common::Node_ptr createNaryNode(
 
     common::Node_ptr ptr = createNode(childNodes);
 
-    switch (detail::passesJitHeuristics<Ti>(nodes)) {
+    const kJITHeuristics heuristic = detail::passesJitHeuristics<Ti>(nodes);
+    if (heuristic != kJITHeuristics::Pass) { recordJitHeuristic(heuristic); }
+    switch (heuristic) {
         case kJITHeuristics::Pass: {
             return ptr;
         }
@@ -35,11 +35,12 @@ namespace arrayfire {
 namespace common {
 
 enum class kNodeType {
-    Generic = 0,
-    Scalar  = 1,
-    Buffer  = 2,
-    Nary    = 3,
-    Shift   = 4,
+    Generic   = 0,
+    Scalar    = 1,
+    Buffer    = 2,
+    Nary      = 3,
+    Shift     = 4,
+    Generator = 5,
 };
 
 class Node;
@@ -51,12 +52,10 @@ class Node;
 
 namespace arrayfire {
 namespace cpu {
-namespace kernel {
-
-template<typename T>
-void evalMultiple(std::vector<Param<T>> arrays,
-                  std::vector<std::shared_ptr<common::Node>> output_nodes_);
-}  // namespace kernel
+namespace jit {
+struct Instruction;
+struct Leaf;
+}  // namespace jit
 }  // namespace cpu
 }  // namespace arrayfire
 #endif
@@ -134,6 +133,11 @@ class Node {
     int m_height;
     kNodeType m_node_type = kNodeType::Generic;
 
+    /// The hash of the type of the node, of its operation and of its
+    /// children. It is computed once because the children of a node never
+    /// change.
+    size_t m_hash = 0;
+
     template<typename T>
     friend class NodeIterator;
     Node() = default;
@@ -142,7 +146,8 @@ class Node {
         : m_children(children)
         , m_type(type)
         , m_height(height)
-        , m_node_type(node_type) {
+        , m_node_type(node_type)
+        , m_hash(hashChildren(type, children)) {
         static_assert(std::is_nothrow_move_assignable<Node>::value,
                       "Node is not move assignable");
     }
@@ -154,8 +159,26 @@ class Node {
         }
         swap(m_type, other.m_type);
         swap(m_height, other.m_height);
+        swap(m_hash, other.m_hash);
     }
 
+    /// Combines the hash of \p type with the hashes of \p children
+    static size_t hashChildren(
+        const af::dtype type,
+        const std::array<Node_ptr, kMaxChildren> &children) noexcept {
+        size_t h = std::hash<af::dtype>()(type);
+        for (const Node_ptr &child : children) {
+            if (!child) { break; }
+            h = h * 31 + child->getHash();
+        }
+        return h;
+    }
+
+    /// Mixes \p value into the hash of the node. The constructors of the
+    /// nodes applying an operation mix it in so that the nodes applying
+    /// different operations to the same children land in different buckets.
+    void mixHash(const size_t value) noexcept { m_hash = m_hash * 31 + value; }
+
     /// Default move constructor operator
     Node(Node &&node) noexcept = default;
 
@@ -189,18 +212,6 @@ class Node {
         UNUSED(is_linear);
     }
 
-    virtual void calc(int x, int y, int z, int w, int lim) {
-        UNUSED(x);
-        UNUSED(y);
-        UNUSED(z);
-        UNUSED(w);
-    }
-
-    virtual void calc(int idx, int lim) {
-        UNUSED(idx);
-        UNUSED(lim);
-    }
-
     const std::array<Node_ptr, kMaxChildren> &getChildren() const {
         return m_children;
     }
@@ -291,32 +302,44 @@ class Node {
     /// Default destructor
     virtual ~Node() noexcept = default;
 
-    /// Returns the hash of the node. For all Nodes other than the Buffer node,
-    /// this is the pointer of the object
-    virtual size_t getHash() const noexcept {
-        std::hash<const void *> ptr_hash;
-        std::hash<af::dtype> aftype_hash;
-        std::hash<int> int_hash;
-        const void *ptr = this;
-        size_t h =
-            ptr_hash(ptr) ^ (aftype_hash(m_type) << 1) ^ (int_hash(m_height));
-        return h;
-    }
+    /// Returns the hash of the node. Nodes which are equal or equivalent have
+    /// the same hash. For all Nodes other than the leaves, this is the hash
+    /// of their type, operation and children.
+    virtual size_t getHash() const noexcept { return m_hash; }
 
     /// A very bad equality operator used only for the hash function.
     virtual bool operator==(const Node &other) const noexcept {
         return this == &other;
     }
+
+    /// Returns true if this node computes the same values as \p other when
+    /// their children compute the same values. The CPU backend evaluates
+    /// equivalent nodes once. The other backends and getNodesMap do not merge
+    /// them.
+    virtual bool isEquivalent(const Node &other) const noexcept {
+        UNUSED(other);
+        return false;
+    }
     virtual std::unique_ptr<Node> clone() = 0;
 
 #ifdef AF_CPU
-    template<typename U>
-    friend void arrayfire::cpu::kernel::evalMultiple(
-        std::vector<arrayfire::cpu::Param<U>> arrays,
-        std::vector<common::Node_ptr> output_nodes_);
-
     virtual void setShape(af::dim4 new_shape) { UNUSED(new_shape); }
 
+    /// Describes how the node is evaluated by a cpu::jit::Tape
+    ///
+    /// \param[out] inst The kind and the functions of the instruction are set
+    ///                  by this function
+    ///
+    /// \returns false if the node cannot be evaluated by a Tape
+    virtual bool getInstruction(cpu::jit::Instruction &inst) const {
+        UNUSED(inst);
+        return false;
+    }
+
+    /// Sets the data read by the instruction of a leaf node for a single
+    /// evaluation of a cpu::jit::Tape
+    virtual void bind(cpu::jit::Leaf &leaf) const { UNUSED(leaf); }
+
 #endif
 };
 
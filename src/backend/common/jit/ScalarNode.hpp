@@ -14,6 +14,8 @@
 
 #include <math.hpp>
 #include <types.hpp>
+#include <algorithm>
+#include <cstring>
 #include <iomanip>
 
 namespace arrayfire {
@@ -89,6 +91,20 @@ class ScalarNode : public common::Node {
 
     std::string getNameStr() const final { return detail::shortname<T>(false); }
 
+    size_t getHash() const noexcept final {
+        size_t out = 0;
+        std::memcpy(&out, &m_val, std::min(sizeof(T), sizeof(size_t)));
+        return out ^ (std::hash<af::dtype>()(m_type) << 1);
+    }
+
+    /// Scalars are equivalent if they have the same type and the same bits
+    bool isEquivalent(const Node& other) const noexcept final {
+        return other.isScalar() && other.getType() == m_type &&
+               std::memcmp(&m_val,
+                           &static_cast<const ScalarNode<T>&>(other).m_val,
+                           sizeof(T)) == 0;
+    }
+
     // Return the info for the params and the size of the buffers
     virtual size_t getParamBytes() const final { return sizeof(T); }
 };
@@ -9,8 +9,6 @@
 
 #pragma once
 
-#if !defined(AF_CPU)
-
 #include <Kernel.hpp>
 #include <Module.hpp>
 #include <backend.hpp>
@@ -106,5 +104,3 @@ detail::Kernel getKernel(const detail::Module& mod, const std::string& name,
 
 }  // namespace common
 }  // namespace arrayfire
-
-#endif
@@ -27,7 +27,8 @@ detail::Array<T> tile(const detail::Array<T> &in, const af::dim4 tileDims) {
 
     // FIXME: Always use JIT instead of checking for the condition.
     // The current limitation exists for performance reasons. it should change
-    // in the future.
+    // in the future. The CPU backend already returns a lazy view from
+    // detail::tile.
 
     bool take_jit_path = true;
     af::dim4 outDims(1, 1, 1, 1);
@@ -14,12 +14,14 @@
 #include <common/ArrayInfo.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
+#include <common/jit/JitStats.hpp>
 #include <common/jit/NodeIterator.hpp>
 #include <common/traits.hpp>
 #include <copy.hpp>
 #include <jit/BufferNode.hpp>
 #include <jit/Node.hpp>
 #include <jit/ScalarNode.hpp>
+#include <mapped_file.hpp>
 #include <memory.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
@@ -134,6 +136,15 @@ Array<T>::Array(const dim4 &dims, const dim4 &strides, dim_t offset_,
     }
 }
 
+template<typename T>
+Array<T>::Array(const dim4 &dims, shared_ptr<T> in_data, bool owner)
+    : info(getActiveDeviceId(), dims, 0, calcStrides(dims),
+           static_cast<af_dtype>(dtype_traits<T>::af_type))
+    , data(move(in_data))
+    , data_dims(dims)
+    , node()
+    , owner(owner) {}
+
 template<typename T>
 void checkAndMigrate(const Array<T> &arr) {
     return;
@@ -159,44 +170,92 @@ T *Array<T>::device() {
 }
 
 template<typename T>
-void evalMultiple(vector<Array<T> *> array_ptrs) {
-    vector<Array<T> *> outputs;
-    vector<common::Node_ptr> nodes;
-    vector<Param<T>> params;
+bool prepareEval(Array<T> &array, EvalTarget &target) {
+    if (array.isReady()) { return false; }
+
+    array.setId(getActiveDeviceId());
+    array.data =
+        shared_ptr<T>(memAlloc<T>(array.elements()).release(), memFree);
+
+    target.output  = jit::makeOutput(array.getData().get());
+    target.dims    = array.dims();
+    target.strides = array.strides();
+    target.node    = std::move(array.node);
+    return true;
+}
+
+/// Returns the memory accessed by the evaluation of \p nodes into \p outputs.
+/// The kernel reads the buffers of the trees and writes the outputs.
+TaskAccesses getEvalAccesses(const vector<jit::Output> &outputs,
+                             const dim4 &dims, const dim4 &strides,
+                             const vector<Node_ptr> &nodes) {
+    TaskAccesses task;
+    for (const jit::Output &output : outputs) {
+        task.accesses.push_back(getMemoryAccess(
+            output.ptr, dims.get(), strides.get(),
+            common::dtypeSize(output.type), true));
+    }
+    for (const Node_ptr &root : nodes) {
+        for (NodeIterator<> it(root.get()), end; it != end; ++it) {
+            if (it->isBuffer()) {
+                jit::Leaf leaf;
+                it->bind(leaf);
+                task.accesses.push_back(getMemoryAccess(
+                    leaf.ptr, leaf.dims, leaf.strides,
+                    common::dtypeSize(it->getType()), false));
+            } else if (it->getBytes() > 0) {
+                // Other nodes reading memory keep the order of the queue
+                task.barrier = true;
+            }
+        }
+    }
+    return task;
+}
+
+void evalMultiple(vector<EvalTarget> targets) {
     if (getQueue().is_worker()) {
         AF_ERROR("Array not evaluated", AF_ERR_INTERNAL);
     }
 
-    // Check if all the arrays have the same dimension
-    auto it = adjacent_find(begin(array_ptrs), end(array_ptrs),
-                            [](const Array<T> *l, const Array<T> *r) {
-                                return l->dims() != r->dims();
-                            });
+    // The arrays with the same shape are evaluated by a single kernel. The
+    // groups keep the order in which their first array appears.
+    vector<bool> done(targets.size(), false);
+    for (size_t i = 0; i < targets.size(); i++) {
+        if (done[i]) { continue; }
+        vector<jit::Output> outputs;
+        vector<Node_ptr> nodes;
+        for (size_t j = i; j < targets.size(); j++) {
+            if (done[j] || targets[j].dims != targets[i].dims) { continue; }
+            done[j] = true;
+            outputs.push_back(targets[j].output);
+            nodes.push_back(std::move(targets[j].node));
+        }
+        TaskAccesses task = getEvalAccesses(outputs, targets[i].dims,
+                                            targets[i].strides, nodes);
+        getQueue().enqueueAccessing(std::move(task), kernel::evalMultiple,
+                                    outputs, targets[i].dims,
+                                    targets[i].strides, nodes,
+                                    common::getThreadJitStats());
+    }
+}
 
-    // If they are not the same. eval individually
-    if (it != end(array_ptrs)) {
-        for (auto ptr : array_ptrs) { ptr->eval(); }
-        return;
+template<typename T>
+void evalMultiple(vector<Array<T> *> array_ptrs) {
+    if (getQueue().is_worker()) {
+        AF_ERROR("Array not evaluated", AF_ERR_INTERNAL);
     }
 
+    vector<EvalTarget> targets;
+    targets.reserve(array_ptrs.size());
     for (Array<T> *array : array_ptrs) {
-        if (array->isReady()) { continue; }
-
-        array->setId(getActiveDeviceId());
-        array->data =
-            shared_ptr<T>(memAlloc<T>(array->elements()).release(), memFree);
-
-        outputs.push_back(array);
-        params.emplace_back(array->getData().get(), array->dims(),
-                            array->strides());
-        nodes.push_back(array->node);
+        EvalTarget target;
+        if (prepareEval(*array, target)) {
+            targets.push_back(std::move(target));
+        }
     }
+    if (targets.empty()) { return; }
 
-    if (params.empty()) return;
-
-    getQueue().enqueue(cpu::kernel::evalMultiple<T>, params, nodes);
-
-    for (Array<T> *array : outputs) { array->node.reset(); }
+    evalMultiple(std::move(targets));
 }
 
 template<typename T>
@@ -226,6 +285,19 @@ Array<T> createDeviceDataArray(const dim4 &dims, void *data, bool copy) {
     return Array<T>(dims, static_cast<T *>(data), is_device, copy);
 }
 
+template<typename T>
+Array<T> createMappedArray(const dim4 &dims, const char *filename,
+                           size_t offset, bool copy_on_write) {
+    // mmap cannot map 0 bytes
+    if (dims.elements() == 0) { return createEmptyArray<T>(dims); }
+    shared_ptr<void> mapping =
+        mapFile(filename, offset, dims.elements() * sizeof(T));
+    shared_ptr<T> data(mapping, static_cast<T *>(mapping.get()));
+    // The read-only arrays do not own their data so that device() and
+    // writeHostDataArray copy them first
+    return Array<T>(dims, move(data), copy_on_write);
+}
+
 template<typename T>
 Array<T> createValueArray(const dim4 &dims, const T &value) {
     return createNodeArray<T>(dims, make_shared<jit::ScalarNode<T>>(value));
@@ -239,11 +311,16 @@ Array<T> createEmptyArray(const dim4 &dims) {
 template<typename T>
 kJITHeuristics passesJitHeuristics(span<Node *> root_nodes) {
     if (!evalFlag()) { return kJITHeuristics::Pass; }
-    size_t bytes = 0;
+    size_t bytes       = 0;
+    size_t working_set = 0;
     for (Node *n : root_nodes) {
         if (n->getHeight() > static_cast<int>(getMaxJitSize())) {
             return kJITHeuristics::TreeHeight;
         }
+        // A tree evaluated in post order keeps about one value per level in
+        // its registers
+        working_set += (n->getHeight() + 1) * sizeof(compute_t<T>) *
+                       jit::kMinVectorLength;
         // Check if approaching the memory limit
         if (getMemoryPressure() >= getMemoryPressureThreshold()) {
             NodeIterator<Node> it(n);
@@ -258,6 +335,10 @@ kJITHeuristics passesJitHeuristics(span<Node *> root_nodes) {
         }
     }
 
+    // The registers of the tree would not fit in the L1 cache even with the
+    // shortest chunks
+    if (working_set > getL1CacheSize()) { return kJITHeuristics::TreeHeight; }
+
     if (jitTreeExceedsMemoryPressure(bytes)) {
         return kJITHeuristics::MemoryPressure;
     }
@@ -276,18 +357,19 @@ Array<T> createSubArray(const Array<T> &parent, const vector<af_seq> &index,
                         bool copy) {
     parent.eval();
 
-    dim4 dDims          = parent.getDataDims();
+    const dim4 &pDims   = parent.dims();
     dim4 parent_strides = parent.strides();
-
-    if (parent.isLinear() == false) {
-        const Array<T> parentCopy = copyArray(parent);
-        return createSubArray(parentCopy, index, copy);
+    dim4 dims           = toDims(index, pDims);
+
+    // The steps of the sequences scale the strides of the parent. Views of
+    // non-linear parents are composed the same way instead of being copied.
+    dim4 strides = parent_strides;
+    for (size_t i = 0; i < index.size(); i++) {
+        if (index[i].step != 0) {
+            strides[i] *= static_cast<dim_t>(index[i].step);
+        }
     }
 
-    const dim4 &pDims = parent.dims();
-    dim4 dims         = toDims(index, pDims);
-    dim4 strides      = toStride(index, dDims);
-
     // Find total offsets after indexing
     dim4 offsets = toOffset(index, pDims);
     dim_t offset = parent.getOffset();
@@ -297,8 +379,10 @@ Array<T> createSubArray(const Array<T> &parent, const vector<af_seq> &index,
 
     if (!copy) { return out; }
 
+    // The elements of views the kernels cannot read directly are gathered
+    // by the JIT when the array is used or evaluated
     if (strides[0] != 1 || strides[1] < 0 || strides[2] < 0 || strides[3] < 0) {
-        out = copyArray(out);
+        return createNodeArray<T>(dims, out.getNode());
     }
 
     return out;
@@ -328,6 +412,8 @@ void writeDeviceDataArray(Array<T> &arr, const void *const data,
 
 template<typename T>
 void Array<T>::setDataDims(const dim4 &new_dims) {
+    // The nodes of JIT trees keep the shape the array was created with
+    if (!isReady()) { eval(); }
     data_dims = new_dims;
     modDims(new_dims);
 }
@@ -337,6 +423,9 @@ void Array<T>::setDataDims(const dim4 &new_dims) {
                                              const T *const data);            \
     template Array<T> createDeviceDataArray<T>(const dim4 &dims, void *data,  \
                                                bool copy);                    \
+    template Array<T> createMappedArray<T>(                                   \
+        const dim4 &dims, const char *filename, size_t offset,                \
+        bool copy_on_write);                                                  \
     template Array<T> createValueArray<T>(const dim4 &dims, const T &value);  \
     template Array<T> createEmptyArray<T>(const dim4 &dims);                  \
     template Array<T> createSubArray<T>(                                      \
@@ -357,6 +446,7 @@ void Array<T>::setDataDims(const dim4 &new_dims) {
     template void writeDeviceDataArray<T>(                                    \
         Array<T> & arr, const void *const data, const size_t bytes);          \
     template void evalMultiple<T>(vector<Array<T> *> arrays);                 \
+    template bool prepareEval<T>(Array<T> & array, EvalTarget & target);      \
     template kJITHeuristics passesJitHeuristics<T>(span<Node *> n);           \
     template void Array<T>::setDataDims(const dim4 &new_dims);                \
     template void checkAndMigrate<T>(const Array<T> &arr);
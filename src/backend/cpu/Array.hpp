@@ -39,11 +39,6 @@ class BufferNode;
 namespace kernel {
 template<typename T>
 void evalArray(Param<T> in, common::Node_ptr node);
-
-template<typename T>
-void evalMultiple(std::vector<Param<T>> arrays,
-                  std::vector<common::Node_ptr> nodes);
-
 }  // namespace kernel
 
 template<typename T>
@@ -52,6 +47,24 @@ class Array;
 using af::dim4;
 using std::shared_ptr;
 
+/// An unevaluated array of any type prepared for evalMultiple
+struct EvalTarget {
+    jit::Output output;
+    af::dim4 dims;
+    af::dim4 strides;
+    common::Node_ptr node;
+};
+
+/// Allocates the buffer of \p array and moves its tree to \p target.
+/// Returns false if the array is already evaluated.
+template<typename T>
+bool prepareEval(Array<T> &array, EvalTarget &target);
+
+/// Evaluates arrays of any type and shape. The arrays with the same shape
+/// are evaluated in a single pass so the subtrees they share are computed
+/// once.
+void evalMultiple(std::vector<EvalTarget> targets);
+
 template<typename T>
 void evalMultiple(std::vector<Array<T> *> array_ptrs);
 
@@ -87,6 +100,21 @@ Array<T> createStridedArray(af::dim4 dims, af::dim4 strides, dim_t offset,
     return Array<T>(dims, strides, offset, in_data, is_device);
 }
 
+/// Creates an Array<T> object backed by a file mapped in memory
+///
+/// \param[in] dims          The shape of the resulting Array.
+/// \param[in] filename      The path of the file
+/// \param[in] offset        The position of the data in the file in bytes
+/// \param[in] copy_on_write If true, the array owns the mapping and can be
+///                          modified in place. If false, the functions
+///                          checking the ownership copy the array before
+///                          writing to it. The file is never modified.
+/// \returns The new Array<T> object. The memory manager does not own its
+///          data.
+template<typename T>
+Array<T> createMappedArray(const af::dim4 &dims, const char *filename,
+                           size_t offset, bool copy_on_write);
+
 /// Copies data to an existing Array object from a host pointer
 template<typename T>
 void writeHostDataArray(Array<T> &arr, const T *const data, const size_t bytes);
@@ -165,6 +193,7 @@ class Array {
     explicit Array(const af::dim4 &dims, common::Node_ptr n);
     Array(const af::dim4 &dims, const af::dim4 &strides, dim_t offset,
           T *const in_data, bool is_device = false);
+    Array(const af::dim4 &dims, std::shared_ptr<T> in_data, bool owner);
 
    public:
     Array<T>(const Array<T> &other) = default;
@@ -281,12 +310,16 @@ class Array {
     common::Node_ptr getNode();
 
     friend void evalMultiple<T>(std::vector<Array<T> *> arrays);
+    friend bool prepareEval<T>(Array<T> &array, EvalTarget &target);
 
     friend Array<T> createValueArray<T>(const af::dim4 &dims, const T &value);
     friend Array<T> createHostDataArray<T>(const af::dim4 &dims,
                                            const T *const data);
     friend Array<T> createDeviceDataArray<T>(const af::dim4 &dims, void *data,
                                              bool copy);
+    friend Array<T> createMappedArray<T>(const af::dim4 &dims,
+                                         const char *filename, size_t offset,
+                                         bool copy_on_write);
     friend Array<T> createStridedArray<T>(af::dim4 dims, af::dim4 strides,
                                           dim_t offset, T *const in_data,
                                           bool is_device);
@@ -300,8 +333,6 @@ class Array {
                                       bool copy);
 
     friend void kernel::evalArray<T>(Param<T> in, common::Node_ptr node);
-    friend void kernel::evalMultiple<T>(std::vector<Param<T>> arrays,
-                                        std::vector<common::Node_ptr> nodes);
 
     friend void destroyArray<T>(Array<T> *arr);
     friend void *getDevicePtr<T>(const Array<T> &arr);
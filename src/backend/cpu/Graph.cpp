@@ -0,0 +1,172 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Graph.hpp>
+
+#include <common/err_common.hpp>
+#include <memory.hpp>
+#include <queue.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+using std::lock_guard;
+using std::mutex;
+using std::unique_ptr;
+using std::vector;
+
+namespace arrayfire {
+namespace cpu {
+
+namespace {
+
+/// The graphs which exist or are being captured
+struct GraphRegistry {
+    mutex graphs_mutex;
+    vector<Graph *> graphs;
+    std::atomic<int> count{0};
+};
+
+GraphRegistry &registry() {
+    // Buffers can be freed after the static objects are destroyed
+    static auto *instance = new GraphRegistry();
+    return *instance;
+}
+
+/// The graph captured by the calling thread
+thread_local unique_ptr<Graph> captured;
+
+/// The graph recording the tasks of the calling thread. It is the captured
+/// graph unless the capture is paused.
+thread_local Graph *recording = nullptr;
+
+bool overlaps(const MemoryAccess &a, std::uintptr_t begin,
+              std::uintptr_t end) noexcept {
+    return a.begin < end && begin < a.end;
+}
+
+}  // namespace
+
+Graph::Graph() {
+    GraphRegistry &reg = registry();
+    lock_guard<mutex> lock(reg.graphs_mutex);
+    reg.graphs.push_back(this);
+    reg.count++;
+}
+
+Graph::~Graph() {
+    GraphRegistry &reg = registry();
+    {
+        lock_guard<mutex> lock(reg.graphs_mutex);
+        reg.graphs.erase(
+            std::remove(reg.graphs.begin(), reg.graphs.end(), this),
+            reg.graphs.end());
+        reg.count--;
+    }
+
+    // The buffers go back to the memory manager unless another graph still
+    // accesses them. The tasks using them are ordered by the queue.
+    for (void *ptr : retained) { memFree(ptr); }
+}
+
+void Graph::record(Task task, const vector<MemoryAccess> &accesses,
+                   bool barrier, bool replayable) {
+    if (!replayable) { valid = false; }
+    steps.push_back({std::move(task), accesses, barrier});
+
+    lock_guard<mutex> lock(registry().graphs_mutex);
+    for (const MemoryAccess &access : accesses) {
+        if (access.begin < access.end) { ranges.push_back(access); }
+    }
+}
+
+void Graph::replay(queue &q) const {
+    Graph *outer = getCapturingGraph();
+    for (const Step &step : steps) {
+        // A graph replayed during a capture is part of the captured graph
+        if (outer) {
+            outer->record(step.task, step.accesses, step.barrier, true);
+        }
+        q.enqueueRecorded(step.task, step.accesses, step.barrier);
+    }
+}
+
+bool Graph::retain(void *ptr, size_t bytes) {
+    const auto begin = reinterpret_cast<std::uintptr_t>(ptr);
+    const auto end   = begin + bytes;
+    const bool found = std::any_of(
+        ranges.begin(), ranges.end(),
+        [=](const MemoryAccess &a) { return overlaps(a, begin, end); });
+    if (found) { retained.push_back(ptr); }
+    return found;
+}
+
+void beginCapture() {
+    if (captured) {
+        AF_ERROR("A capture is already in progress on this thread",
+                 AF_ERR_RUNTIME);
+    }
+    captured  = std::make_unique<Graph>();
+    recording = captured.get();
+}
+
+unique_ptr<Graph> endCapture() {
+    if (!captured) {
+        AF_ERROR("No capture is in progress on this thread", AF_ERR_RUNTIME);
+    }
+    recording = nullptr;
+    unique_ptr<Graph> graph = std::move(captured);
+
+    // Merging the ranges shortens the search done for every freed buffer
+    lock_guard<mutex> lock(registry().graphs_mutex);
+    vector<MemoryAccess> &ranges = graph->ranges;
+    std::sort(ranges.begin(), ranges.end(),
+              [](const MemoryAccess &a, const MemoryAccess &b) {
+                  return a.begin < b.begin;
+              });
+    vector<MemoryAccess> merged;
+    for (const MemoryAccess &range : ranges) {
+        if (!merged.empty() && range.begin <= merged.back().end) {
+            merged.back().end = std::max(merged.back().end, range.end);
+        } else {
+            merged.push_back(range);
+        }
+    }
+    ranges = std::move(merged);
+    return graph;
+}
+
+Graph *getCapturingGraph() noexcept { return recording; }
+
+bool hasGraphs() noexcept { return registry().count > 0; }
+
+bool retainByGraphs(void *ptr, size_t bytes) {
+    GraphRegistry &reg = registry();
+    lock_guard<mutex> lock(reg.graphs_mutex);
+    for (Graph *graph : reg.graphs) {
+        if (graph->retain(ptr, bytes)) { return true; }
+    }
+    return false;
+}
+
+CapturePause::CapturePause() : graph(std::exchange(recording, nullptr)) {}
+
+CapturePause::~CapturePause() { recording = graph; }
+
+af_graph getHandle(Graph &graph) { return static_cast<af_graph>(&graph); }
+
+Graph &getGraph(const af_graph handle) {
+    return *static_cast<Graph *>(handle);
+}
+
+}  // namespace cpu
+}  // namespace arrayfire
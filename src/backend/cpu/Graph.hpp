@@ -0,0 +1,111 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <task_scheduler.hpp>
+#include <af/graph.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace arrayfire {
+namespace cpu {
+
+class queue;
+
+/// The tasks enqueued by a host thread between beginCapture and endCapture
+///
+/// The tasks keep the pointers to the memory they accessed during the
+/// capture so a replay reads and writes the same buffers. The buffers are
+/// kept alive while the graph exists: freeing one of them only returns it to
+/// the memory manager once no graph accesses it anymore.
+class Graph {
+   public:
+    using Task = std::shared_ptr<const TaskScheduler::Task>;
+
+    Graph();
+    ~Graph();
+
+    Graph(const Graph &)            = delete;
+    Graph &operator=(const Graph &) = delete;
+
+    /// Appends \p task accessing \p accesses to the graph. A task which
+    /// cannot be replayed makes the whole graph invalid.
+    void record(Task task, const std::vector<MemoryAccess> &accesses,
+                bool barrier, bool replayable);
+
+    /// Enqueues the tasks of the graph on \p q
+    void replay(queue &q) const;
+
+    /// Returns true if every recorded task can be replayed
+    bool isValid() const noexcept { return valid; }
+
+    /// Keeps the buffer \p ptr of \p bytes bytes until the graph is destroyed
+    /// if the graph accesses it. Returns false if it does not.
+    bool retain(void *ptr, size_t bytes);
+
+   private:
+    struct Step {
+        Task task;
+        std::vector<MemoryAccess> accesses;
+        bool barrier;
+    };
+
+    std::vector<Step> steps;
+
+    /// The memory accessed by the steps
+    std::vector<MemoryAccess> ranges;
+
+    /// The buffers freed while the graph accesses them
+    std::vector<void *> retained;
+
+    bool valid = true;
+
+    friend std::unique_ptr<Graph> endCapture();
+    friend bool retainByGraphs(void *ptr, size_t bytes);
+};
+
+/// Starts recording the tasks enqueued by the calling thread
+void beginCapture();
+
+/// Stops the capture of the calling thread and returns the graph
+std::unique_ptr<Graph> endCapture();
+
+/// Returns the graph recorded by the calling thread or nullptr if it is not
+/// capturing
+Graph *getCapturingGraph() noexcept;
+
+/// Returns true if a graph exists or is being captured
+bool hasGraphs() noexcept;
+
+/// Hands the buffer \p ptr of \p bytes bytes being freed over to the graphs
+/// accessing it. Returns false if no graph accesses it.
+bool retainByGraphs(void *ptr, size_t bytes);
+
+/// Stops the recording of the calling thread during its lifetime. Used while
+/// the recorded tasks run on the thread which enqueued them.
+class CapturePause {
+    Graph *graph;
+
+   public:
+    CapturePause();
+    ~CapturePause();
+
+    CapturePause(const CapturePause &)            = delete;
+    CapturePause &operator=(const CapturePause &) = delete;
+};
+
+af_graph getHandle(Graph &graph);
+
+Graph &getGraph(const af_graph handle);
+
+}  // namespace cpu
+}  // namespace arrayfire
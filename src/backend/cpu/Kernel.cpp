@@ -0,0 +1,42 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Kernel.hpp>
+
+#include <common/defines.hpp>
+#include <common/module_loading.hpp>
+
+#include <cstring>
+
+namespace arrayfire {
+namespace cpu {
+
+Kernel::DevPtrType Kernel::getDevPtr(const char* name) {
+    return common::getFunctionPointer(getModuleHandle(), name);
+}
+
+void Kernel::copyToReadOnly(Kernel::DevPtrType dst, Kernel::DevPtrType src,
+                            size_t bytes) {
+    std::memcpy(dst, src, bytes);
+}
+
+void Kernel::setFlag(Kernel::DevPtrType dst, int* scalarValPtr,
+                     const bool syncCopy) {
+    UNUSED(syncCopy);
+    std::memcpy(dst, scalarValPtr, sizeof(int));
+}
+
+int Kernel::getFlag(Kernel::DevPtrType src) {
+    int retVal = 0;
+    std::memcpy(&retVal, src, sizeof(int));
+    return retVal;
+}
+
+}  // namespace cpu
+}  // namespace arrayfire
@@ -0,0 +1,54 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/KernelInterface.hpp>
+#include <common/defines.hpp>
+
+#include <string>
+#include <utility>
+
+namespace arrayfire {
+namespace cpu {
+
+/// Calls the function of a native kernel with the arguments following the
+/// launch arguments, which are not used by the CPU backend
+struct Enqueuer {
+    template<typename EnqueueArgs, typename... Args>
+    void operator()(const std::string& name, void* ker, const EnqueueArgs&,
+                    Args&&... args) {
+        UNUSED(name);
+        reinterpret_cast<void (*)(Args...)>(ker)(std::forward<Args>(args)...);
+    }
+};
+
+/// A function of the shared library of a native JIT kernel
+class Kernel
+    : public common::KernelInterface<LibHandle, void*, Enqueuer, void*> {
+   public:
+    using BaseClass =
+        common::KernelInterface<ModuleType, KernelType, Enqueuer, DevPtrType>;
+
+    Kernel() : BaseClass("", nullptr, nullptr) {}
+    Kernel(std::string name, ModuleType mod, KernelType ker)
+        : BaseClass(name, mod, ker) {}
+
+    DevPtrType getDevPtr(const char* name) final;
+
+    void copyToReadOnly(DevPtrType dst, DevPtrType src, size_t bytes) final;
+
+    void setFlag(DevPtrType dst, int* scalarValPtr,
+                 const bool syncCopy = false) final;
+
+    int getFlag(DevPtrType src) final;
+};
+
+}  // namespace cpu
+}  // namespace arrayfire
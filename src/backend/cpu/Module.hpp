@@ -0,0 +1,43 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/ModuleInterface.hpp>
+#include <common/defines.hpp>
+#include <common/module_loading.hpp>
+
+#include <string>
+
+namespace arrayfire {
+namespace cpu {
+
+/// CPU backend wrapper for the shared library of a native JIT kernel
+class Module : public common::ModuleInterface<LibHandle> {
+   public:
+    using ModuleType = LibHandle;
+    using BaseClass  = common::ModuleInterface<ModuleType>;
+
+    /// \brief Create an uninitialized Module
+    Module() : BaseClass(nullptr) {}
+
+    /// \brief Create a module given a loaded shared library
+    Module(ModuleType mod) : BaseClass(mod) {}
+
+    operator bool() const final { return get() != nullptr; }
+
+    /// Unload the shared library
+    void unload() final {
+        if (get()) { common::unloadLibrary(get()); }
+        set(nullptr);
+    }
+};
+
+}  // namespace cpu
+}  // namespace arrayfire
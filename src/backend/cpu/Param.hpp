@@ -120,8 +120,9 @@ template<typename T>
 class Array;
 
 // These functions are needed to convert Array<T> to Param<T> when queueing up
-// functions. This is fine becacuse we only have 1 compute queue. This ensures
-// there's no race conditions.
+// functions. The queue uses the Param and CParam arguments of a task to order
+// it after the tasks accessing the same memory. This ensures there's no race
+// conditions.
 
 /// \brief Converts Array<T> to Param<T> or CParam<T> based on the constness
 ///        of the Array<T> object. If called on anything else, the object is
@@ -0,0 +1,188 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <allocation_policy.hpp>
+
+#include <common/dispatch.hpp>
+#include <common/util.hpp>
+#include <parallel.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+
+#if defined(OS_LNX)
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using arrayfire::common::getEnvVar;
+using std::lock_guard;
+using std::mutex;
+using std::string;
+
+namespace arrayfire {
+namespace cpu {
+
+namespace {
+
+/// The alignment of the mapped buffers. It is the size of the huge pages on
+/// x86-64 and of the transparent huge pages on most other architectures.
+constexpr size_t kHugePageBytes = size_t(2) << 20;
+
+af_huge_pages parseHugePages(const string &value) {
+    if (value == "1" || value == "transparent") {
+        return AF_HUGE_PAGES_TRANSPARENT;
+    }
+    if (value == "explicit") { return AF_HUGE_PAGES_EXPLICIT; }
+    return AF_HUGE_PAGES_NONE;
+}
+
+af_numa_policy parseNuma(const string &value) {
+    if (value == "local") { return AF_NUMA_LOCAL; }
+    if (value == "interleave") { return AF_NUMA_INTERLEAVE; }
+    return AF_NUMA_DEFAULT;
+}
+
+size_t parseLargeBytes(const string &value) {
+    if (!value.empty()) {
+        try {
+            return static_cast<size_t>(std::stoull(value));
+        } catch (...) {}
+    }
+    return size_t(16) << 20;
+}
+
+struct PolicyState {
+    mutex policy_mutex;
+    AllocationPolicy policy;
+
+    PolicyState()
+        : policy{parseHugePages(getEnvVar("AF_CPU_HUGE_PAGES")),
+                 parseNuma(getEnvVar("AF_CPU_NUMA")),
+                 parseLargeBytes(getEnvVar("AF_CPU_LARGE_ALLOC_BYTES"))} {}
+};
+
+PolicyState &policyState() {
+    static PolicyState state;
+    return state;
+}
+
+#if defined(OS_LNX)
+/// Maps \p length bytes starting on a huge page boundary
+void *mapAligned(size_t length) {
+    void *raw = mmap(nullptr, length + kHugePageBytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) { return nullptr; }
+
+    const auto begin   = reinterpret_cast<std::uintptr_t>(raw);
+    const auto aligned = divup(begin, kHugePageBytes) * kHugePageBytes;
+    const size_t head  = aligned - begin;
+    const size_t tail  = kHugePageBytes - head;
+    if (head) { munmap(raw, head); }
+    if (tail) { munmap(reinterpret_cast<void *>(aligned + length), tail); }
+    return reinterpret_cast<void *>(aligned);
+}
+
+/// Spreads the pages of the buffer over the NUMA nodes the process can use.
+/// Errors are ignored as the buffer stays usable with the default placement.
+void interleave(void *ptr, size_t length) {
+    unsigned long nodes[16]      = {};
+    const unsigned long max_node = sizeof(nodes) * 8;
+    if (syscall(SYS_get_mempolicy, nullptr, nodes, max_node, nullptr,
+                MPOL_F_MEMS_ALLOWED) != 0) {
+        return;
+    }
+    syscall(SYS_mbind, ptr, length, MPOL_INTERLEAVE, nodes, max_node, 0);
+}
+
+/// Touches the pages of the buffer from the threads of the pool. A page is
+/// placed on the NUMA node of the thread touching it first, and the kernels
+/// split their work across the pool threads the same way.
+void touchPages(void *ptr, size_t length) {
+    const auto page_bytes = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const auto num_pages  = static_cast<dim_t>(length / page_bytes);
+    char *bytes           = static_cast<char *>(ptr);
+    parallel_for(0, num_pages, 64, [=](dim_t begin, dim_t end) {
+        for (dim_t i = begin; i < end; i++) { bytes[i * page_bytes] = 0; }
+    });
+}
+
+void *mapHost(size_t bytes, const AllocationPolicy &policy,
+              size_t *mapped_bytes) {
+    const size_t length = divup(bytes, kHugePageBytes) * kHugePageBytes;
+    void *ptr           = nullptr;
+    if (policy.huge_pages == AF_HUGE_PAGES_EXPLICIT) {
+        ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        // Falls back to transparent huge pages when none are reserved
+        if (ptr == MAP_FAILED) { ptr = nullptr; }
+    }
+    if (!ptr) {
+        ptr = mapAligned(length);
+        if (!ptr) { return nullptr; }
+        if (policy.huge_pages != AF_HUGE_PAGES_NONE) {
+            madvise(ptr, length, MADV_HUGEPAGE);
+        }
+    }
+
+    if (policy.numa == AF_NUMA_INTERLEAVE) {
+        interleave(ptr, length);
+    } else if (policy.numa == AF_NUMA_LOCAL) {
+        touchPages(ptr, length);
+    }
+    *mapped_bytes = length;
+    return ptr;
+}
+#endif
+
+}  // namespace
+
+AllocationPolicy getAllocationPolicy() {
+    PolicyState &state = policyState();
+    lock_guard<mutex> lock(state.policy_mutex);
+    return state.policy;
+}
+
+void setAllocationPolicy(const AllocationPolicy &policy) {
+    PolicyState &state = policyState();
+    lock_guard<mutex> lock(state.policy_mutex);
+    state.policy = policy;
+}
+
+void *allocateHost(size_t bytes, size_t *mapped_bytes) {
+    *mapped_bytes = 0;
+#if defined(OS_LNX)
+    const AllocationPolicy policy = getAllocationPolicy();
+
+    // The default policy is the one of malloc
+    const bool map = policy.huge_pages != AF_HUGE_PAGES_NONE ||
+                     policy.numa != AF_NUMA_DEFAULT;
+    if (map && bytes >= policy.large_bytes) {
+        return mapHost(bytes, policy, mapped_bytes);
+    }
+#endif
+    return malloc(bytes);  // NOLINT(hicpp-no-malloc)
+}
+
+void freeHost(void *ptr, size_t mapped_bytes) {
+#if defined(OS_LNX)
+    if (mapped_bytes) {
+        munmap(ptr, mapped_bytes);
+        return;
+    }
+#endif
+    free(ptr);  // NOLINT(hicpp-no-malloc)
+}
+
+}  // namespace cpu
+}  // namespace arrayfire
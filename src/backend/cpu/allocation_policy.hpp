@@ -0,0 +1,55 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <af/defines.h>
+
+#include <cstddef>
+
+namespace arrayfire {
+namespace cpu {
+
+/// Describes how the CPU backend allocates its large buffers
+///
+/// The buffers of at least \ref large_bytes bytes are mapped directly from the
+/// operating system instead of coming from malloc. This lets them use huge
+/// pages and control the NUMA nodes backing them. The smaller buffers always
+/// come from malloc. The policy only has an effect on Linux.
+struct AllocationPolicy {
+    af_huge_pages huge_pages;
+    af_numa_policy numa;
+    size_t large_bytes;
+};
+
+/// Returns the policy used by the allocations
+///
+/// The initial policy is read from the AF_CPU_HUGE_PAGES, AF_CPU_NUMA and
+/// AF_CPU_LARGE_ALLOC_BYTES environment variables.
+AllocationPolicy getAllocationPolicy();
+
+/// Changes the policy used by the next allocations. The existing buffers are
+/// not moved.
+void setAllocationPolicy(const AllocationPolicy &policy);
+
+/// Allocates \p bytes bytes following the current policy
+///
+/// \param[in]  bytes        the size of the buffer
+/// \param[out] mapped_bytes the length of the mapping backing the buffer or 0
+///                          if it comes from malloc. It must be passed to
+///                          \ref freeHost.
+///
+/// \returns the buffer or nullptr if the memory could not be allocated
+void *allocateHost(size_t bytes, size_t *mapped_bytes);
+
+/// Frees a buffer returned by \ref allocateHost
+void freeHost(void *ptr, size_t mapped_bytes);
+
+}  // namespace cpu
+}  // namespace arrayfire
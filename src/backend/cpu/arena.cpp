@@ -0,0 +1,203 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arena.hpp>
+
+#include <common/MemoryManagerBase.hpp>
+#include <common/dispatch.hpp>
+#include <common/err_common.hpp>
+#include <platform.hpp>
+#include <af/dim4.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using af::dim4;
+using std::shared_lock;
+using std::shared_mutex;
+using std::unique_lock;
+using std::vector;
+
+namespace arrayfire {
+namespace cpu {
+
+/// A buffer of the memory manager the buffers of an arena are carved out of
+struct ArenaBlock {
+    char *data;
+    size_t bytes;
+    // The bytes handed out. Only accessed by the thread owning the arena.
+    size_t used;
+    // The buffers alive, plus one while the arena is open
+    std::atomic<size_t> refs;
+
+    ArenaBlock(char *data, size_t bytes)
+        : data(data), bytes(bytes), used(0), refs(1) {}
+};
+
+namespace {
+
+constexpr size_t kDefaultBlockBytes = size_t(16) << 20;
+
+/// The alignment of the buffers
+constexpr size_t kAlignment = 64;
+
+constexpr unsigned kManagerLock = 1;
+constexpr unsigned kUserLock    = 2;
+
+struct Arena {
+    size_t block_bytes;
+    vector<ArenaBlock *> blocks;
+};
+
+/// The arenas opened by a thread. The ones left open when the thread exits
+/// are closed.
+struct ArenaStack {
+    vector<Arena> arenas;
+
+    ~ArenaStack() {
+        while (!arenas.empty()) { popArena(); }
+    }
+};
+
+ArenaStack &arenaStack() {
+    thread_local ArenaStack stack;
+    return stack;
+}
+
+/// The headers of the buffers alive of all the threads, indexed by address.
+/// The buffers can be released by any thread.
+struct BufferRegistry {
+    shared_mutex registry_mutex;
+    std::unordered_map<const void *, std::shared_ptr<ArenaBuffer>> buffers;
+    std::atomic<size_t> count{0};
+};
+
+BufferRegistry &registry() {
+    static BufferRegistry reg;
+    return reg;
+}
+
+ArenaBlock *newBlock(size_t bytes) {
+    dim4 dims(static_cast<dim_t>(bytes));
+    auto *data =
+        static_cast<char *>(memoryManager().alloc(false, 1, dims.get(), 1));
+    return new ArenaBlock(data, bytes);
+}
+
+void releaseBlock(ArenaBlock *block) {
+    memoryManager().unlock(block->data, false);
+    delete block;
+}
+
+void releaseRef(ArenaBlock *block) {
+    if (block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        releaseBlock(block);
+    }
+}
+
+/// Reserves \p bytes bytes aligned to kAlignment at the end of \p block.
+/// Returns nullptr if the block is full.
+char *reserve(ArenaBlock *block, size_t bytes) {
+    const auto base    = reinterpret_cast<std::uintptr_t>(block->data);
+    const auto current = base + block->used;
+    const auto aligned = divup(current, kAlignment) * kAlignment;
+    if (aligned + bytes > base + block->bytes) { return nullptr; }
+    block->used = aligned + bytes - base;
+    return reinterpret_cast<char *>(aligned);
+}
+
+}  // namespace
+
+ArenaBuffer::ArenaBuffer(ArenaBlock *block, const void *ptr, size_t bytes)
+    : block(block), ptr(ptr), size(bytes), locks(kManagerLock) {}
+
+void ArenaBuffer::userLock() { locks.fetch_or(kUserLock); }
+
+bool ArenaBuffer::isUserLocked() const { return locks.load() & kUserLock; }
+
+void ArenaBuffer::unlock(bool user_unlock) {
+    const unsigned lock     = user_unlock ? kUserLock : kManagerLock;
+    const unsigned previous = locks.fetch_and(~lock);
+    if (previous != lock) { return; }
+
+    ArenaBlock *owner   = block;
+    BufferRegistry &reg = registry();
+    {
+        unique_lock<shared_mutex> registry_lock(reg.registry_mutex);
+        reg.buffers.erase(ptr);
+        reg.count--;
+    }
+    releaseRef(owner);
+}
+
+void pushArena(size_t block_bytes) {
+    arenaStack().arenas.push_back(
+        {block_bytes ? block_bytes : kDefaultBlockBytes, {}});
+}
+
+void popArena() {
+    vector<Arena> &arenas = arenaStack().arenas;
+    if (arenas.empty()) {
+        AF_ERROR("No arena is open on this thread", AF_ERR_ARG);
+    }
+    Arena arena = std::move(arenas.back());
+    arenas.pop_back();
+    for (ArenaBlock *block : arena.blocks) { releaseRef(block); }
+}
+
+void *arenaAlloc(size_t bytes) {
+    vector<Arena> &arenas = arenaStack().arenas;
+    if (arenas.empty() || bytes == 0) { return nullptr; }
+
+    Arena &arena = arenas.back();
+    if (bytes > arena.block_bytes / 2) { return nullptr; }
+
+    ArenaBlock *block = arena.blocks.empty() ? nullptr : arena.blocks.back();
+    char *ptr         = nullptr;
+    if (block) {
+        // The block is refilled once all its buffers are released. The queue
+        // orders the new tasks after the ones still using the old buffers,
+        // the host never writes to the memory of the block.
+        if (block->refs.load(std::memory_order_acquire) == 1) {
+            block->used = 0;
+        }
+        ptr = reserve(block, bytes);
+    }
+    if (!ptr) {
+        block = newBlock(arena.block_bytes);
+        arena.blocks.push_back(block);
+        ptr = reserve(block, bytes);
+    }
+
+    block->refs.fetch_add(1, std::memory_order_relaxed);
+    BufferRegistry &reg = registry();
+    unique_lock<shared_mutex> lock(reg.registry_mutex);
+    reg.buffers.emplace(ptr, std::make_shared<ArenaBuffer>(block, ptr, bytes));
+    reg.count++;
+    return ptr;
+}
+
+std::shared_ptr<ArenaBuffer> findArenaBuffer(const void *ptr) {
+    BufferRegistry &reg = registry();
+    if (reg.count.load(std::memory_order_acquire) == 0) { return nullptr; }
+
+    // The caller shares the header so a concurrent unlock erasing it from the
+    // table does not destroy it while it is used
+    shared_lock<shared_mutex> lock(reg.registry_mutex);
+    auto iter = reg.buffers.find(ptr);
+    return iter == reg.buffers.end() ? nullptr : iter->second;
+}
+
+}  // namespace cpu
+}  // namespace arrayfire
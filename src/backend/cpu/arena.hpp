@@ -0,0 +1,80 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace arrayfire {
+namespace cpu {
+
+struct ArenaBlock;
+
+/// A buffer carved out of an arena block
+///
+/// The headers are kept in a table outside of the blocks: the memory of a
+/// released buffer can still be used by the pending tasks. Like the buffers
+/// of the memory manager, a buffer is alive while it is locked by ArrayFire
+/// or by the user.
+class ArenaBuffer {
+    ArenaBlock *block;
+    const void *ptr;
+    size_t size;
+    std::atomic<unsigned> locks;
+
+   public:
+    ArenaBuffer(ArenaBlock *block, const void *ptr, size_t bytes);
+
+    size_t bytes() const { return size; }
+
+    void userLock();
+    bool isUserLocked() const;
+
+    /// Releases the lock of ArrayFire or of the user. The header is removed
+    /// from the table once both locks are released. The block is given back to
+    /// the memory manager once its arena is closed and all its buffers are
+    /// released.
+    void unlock(bool user_unlock);
+};
+
+/// Opens an arena on the calling thread
+///
+/// Until the arena is closed, the arrays allocated by the thread are carved
+/// out of blocks of \p block_bytes bytes allocated from the memory manager.
+/// The requests larger than half a block still go to the memory manager.
+/// The arenas can be nested, the innermost one is used.
+///
+/// \param[in] block_bytes the size of the blocks. 0 selects the default
+///                        size of 16 MiB
+void pushArena(size_t block_bytes);
+
+/// Closes the innermost arena of the calling thread
+///
+/// The blocks without buffers alive are given back to the memory manager
+/// at once. The arrays which escape the scope of the arena keep their block
+/// allocated until they are released.
+void popArena();
+
+/// Allocates \p bytes bytes from the innermost arena of the calling thread
+///
+/// \returns the buffer or nullptr when the thread has no arena open or when
+///          the request is too large for the arena
+void *arenaAlloc(size_t bytes);
+
+/// Returns the header of \p ptr if it was allocated by \ref arenaAlloc and
+/// nullptr otherwise. It costs an atomic load when no buffer is alive.
+///
+/// The header stays valid while the returned pointer is held, even if
+/// another thread releases the buffer in the meantime.
+std::shared_ptr<ArenaBuffer> findArenaBuffer(const void *ptr);
+
+}  // namespace cpu
+}  // namespace arrayfire
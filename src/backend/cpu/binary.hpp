@@ -11,6 +11,7 @@
 #include <jit/Node.hpp>
 #include <math.hpp>
 #include <optypes.hpp>
+#include <simd_math.hpp>
 #include <types.hpp>
 #include <cmath>
 
@@ -20,14 +21,22 @@ namespace cpu {
 template<typename To, typename Ti, af_op_t op>
 struct BinOp;
 
-#define ARITH_FN(OP, op)                                                 \
-    template<typename T>                                                 \
-    struct BinOp<T, T, OP> {                                             \
-        void eval(jit::array<compute_t<T>> &out,                         \
-                  const jit::array<compute_t<T>> &lhs,                   \
-                  const jit::array<compute_t<T>> &rhs, int lim) const {  \
-            for (int i = 0; i < lim; i++) { out[i] = lhs[i] op rhs[i]; } \
-        }                                                                \
+#define ARITH_FN(OP, op)                                                     \
+    template<typename T>                                                     \
+    struct BinOp<T, T, OP> {                                                 \
+        void eval(jit::array<compute_t<T>> &out,                             \
+                  const jit::array<compute_t<T>> &lhs,                       \
+                  const jit::array<compute_t<T>> &rhs, int lim) const {      \
+            using C = compute_t<T>;                                          \
+            if constexpr (simd::is_vectorized<C>::value) {                   \
+                auto fn = [](simd::batch<C> a, simd::batch<C> b) {           \
+                    return a op b;                                           \
+                };                                                           \
+                simd::apply(out.data(), lhs.data(), rhs.data(), lim, fn);    \
+            } else {                                                         \
+                for (int i = 0; i < lim; i++) { out[i] = lhs[i] op rhs[i]; } \
+            }                                                                \
+        }                                                                    \
     };
 
 ARITH_FN(af_add_t, +)
@@ -46,15 +55,33 @@ ARITH_FN(af_div_t, /)
         }                                                                     \
     };
 
-LOGIC_FN(af_eq_t, ==)
-LOGIC_FN(af_neq_t, !=)
-LOGIC_FN(af_lt_t, <)
-LOGIC_FN(af_gt_t, >)
-LOGIC_FN(af_le_t, <=)
-LOGIC_FN(af_ge_t, >=)
+#define COMPARE_FN(OP, op)                                                    \
+    template<typename T>                                                      \
+    struct BinOp<char, T, OP> {                                               \
+        void eval(jit::array<char> &out, const jit::array<compute_t<T>> &lhs, \
+                  const jit::array<compute_t<T>> &rhs, int lim) {             \
+            using C = compute_t<T>;                                           \
+            if constexpr (simd::is_vectorized<C>::value) {                    \
+                auto fn = [](simd::batch<C> a, simd::batch<C> b) {            \
+                    return a op b;                                            \
+                };                                                            \
+                simd::compare(out.data(), lhs.data(), rhs.data(), lim, fn);   \
+            } else {                                                          \
+                for (int i = 0; i < lim; i++) { out[i] = lhs[i] op rhs[i]; }  \
+            }                                                                 \
+        }                                                                     \
+    };
+
+COMPARE_FN(af_eq_t, ==)
+COMPARE_FN(af_neq_t, !=)
+COMPARE_FN(af_lt_t, <)
+COMPARE_FN(af_gt_t, >)
+COMPARE_FN(af_le_t, <=)
+COMPARE_FN(af_ge_t, >=)
 LOGIC_FN(af_and_t, &&)
 LOGIC_FN(af_or_t, ||)
 
+#undef COMPARE_FN
 #undef LOGIC_FN
 
 #define LOGIC_CPLX_FN(T, OP, op)                                               \
@@ -0,0 +1,224 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/compile_module.hpp>  //compileModule & loadModuleFromDisk
+#include <common/kernel_cache.hpp>    //getKernel(Module&, ...)
+
+#include <Kernel.hpp>
+#include <Module.hpp>
+#include <common/Logger.hpp>
+#include <common/defines.hpp>
+#include <common/err_common.hpp>
+#include <common/module_loading.hpp>
+#include <common/util.hpp>
+#include <af/version.h>
+
+#include <nonstd/span.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+
+using arrayfire::common::getCacheDirectory;
+using arrayfire::common::getEnvVar;
+using arrayfire::common::loadLibrary;
+using arrayfire::common::loggerFactory;
+using arrayfire::common::makeTempFilename;
+using arrayfire::common::removeFile;
+using arrayfire::common::renameFile;
+using arrayfire::cpu::Kernel;
+using arrayfire::cpu::Module;
+using nonstd::span;
+using spdlog::logger;
+using std::ofstream;
+using std::shared_ptr;
+using std::string;
+using std::to_string;
+using std::chrono::duration_cast;
+using std::chrono::high_resolution_clock;
+using std::chrono::milliseconds;
+
+#if defined(OS_WIN)
+#define popen _popen
+#define pclose _pclose
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+logger *getLogger() {
+    static shared_ptr<logger> logger(loggerFactory("jit"));
+    return logger.get();
+}
+
+string getKernelCacheFilename(const string &key) {
+    return "KER" + key + "_CPU_AF_" + to_string(AF_API_VERSION_CURRENT) +
+           ".so";
+}
+
+/// Returns true if only the current user can modify \p path. The native
+/// kernels are loaded into the process so they must not come from a file or
+/// a directory other users can write to.
+bool isPrivatePath(const string &path, const bool isDirectory) {
+#if defined(OS_WIN)
+    UNUSED(path);
+    UNUSED(isDirectory);
+    return true;
+#else
+    // The kernel files are not followed through symbolic links
+    struct stat status {};
+    const int ret = isDirectory ? stat(path.c_str(), &status)
+                                : lstat(path.c_str(), &status);
+    if (ret != 0) { return false; }
+    const bool isType =
+        isDirectory ? S_ISDIR(status.st_mode) : S_ISREG(status.st_mode);
+    // NOLINTNEXTLINE(hicpp-signed-bitwise)
+    return isType && status.st_uid == geteuid() &&
+           (status.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+#endif
+}
+
+/// Returns the directory used to build and cache the native kernels. It is
+/// empty if the kernel cache directory can be modified by other users, such
+/// as a /tmp/arrayfire directory created by someone else.
+string getNativeCacheDirectory() {
+    const string &cacheDirectory = getCacheDirectory();
+    if (cacheDirectory.empty() || isPrivatePath(cacheDirectory, true)) {
+        return cacheDirectory;
+    }
+    AF_TRACE("{} is not private to the user, native kernels are disabled",
+             cacheDirectory);
+    return string();
+}
+
+/// Runs \p command and returns its exit status. The output of the command is
+/// appended to \p log.
+int runCommand(const string &command, string &log) {
+    FILE *pipe = popen((command + " 2>&1").c_str(), "r");
+    if (!pipe) { return -1; }
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), pipe)) { log += buffer; }
+    return pclose(pipe);
+}
+
+}  // namespace
+
+namespace arrayfire {
+namespace common {
+
+Module compileModule(const string &moduleKey, span<const string> sources,
+                     span<const string> options, span<const string> kInstances,
+                     const bool isJIT) {
+    UNUSED(kInstances);
+    UNUSED(isJIT);
+
+    const string cacheDirectory = getNativeCacheDirectory();
+    if (cacheDirectory.empty()) {
+        AF_ERROR("No private writable directory to build the native JIT "
+                 "kernels",
+                 AF_ERR_RUNTIME);
+    }
+
+    const string tempFile =
+        cacheDirectory + AF_PATH_SEPARATOR + makeTempFilename();
+    const string sourceFile = tempFile + ".cpp";
+    const string binaryFile = tempFile + ".so";
+    {
+        ofstream out(sourceFile);
+        for (const auto &source : sources) { out << source << '\n'; }
+        if (!out) {
+            removeFile(sourceFile);
+            AF_ERROR("Failed to write the source of a native JIT kernel",
+                     AF_ERR_RUNTIME);
+        }
+    }
+
+    string compiler = getEnvVar("AF_CPU_JIT_COMPILER");
+    if (compiler.empty()) { compiler = "c++"; }
+    string command = compiler;
+    for (const auto &opt : options) { command += ' ' + opt; }
+    command += " -o " + binaryFile + ' ' + sourceFile;
+
+    string buildLog;
+    auto compileBegin = high_resolution_clock::now();
+    const int status  = runCommand(command, buildLog);
+    auto compileEnd   = high_resolution_clock::now();
+    removeFile(sourceFile);
+    if (status != 0) {
+        removeFile(binaryFile);
+        AF_ERROR("Failed to compile a native JIT kernel: " + command + "\n" +
+                     buildLog,
+                 AF_ERR_INTERNAL);
+    }
+
+    string libraryFile = binaryFile;
+#ifdef AF_CACHE_KERNELS_TO_DISK
+    // If the rename fails another thread or process has already written the
+    // same kernel to the cache
+    const string cacheFile =
+        cacheDirectory + AF_PATH_SEPARATOR + getKernelCacheFilename(moduleKey);
+    if (!renameFile(binaryFile, cacheFile)) { removeFile(binaryFile); }
+    libraryFile = cacheFile;
+#endif
+
+    LibHandle handle = loadLibrary(libraryFile.c_str());
+#ifndef AF_CACHE_KERNELS_TO_DISK
+    removeFile(libraryFile);
+#endif
+    if (!handle) {
+        AF_ERROR("Failed to load a native JIT kernel: " + getErrorMessage(),
+                 AF_ERR_INTERNAL);
+    }
+
+    AF_TRACE("{{ {:<20} : {{ compile:{:>5} ms, {} }} }}", moduleKey,
+             duration_cast<milliseconds>(compileEnd - compileBegin).count(),
+             command);
+
+    return {handle};
+}
+
+Module loadModuleFromDisk(const int device, const string &moduleKey,
+                          const bool isJIT) {
+    UNUSED(device);
+    UNUSED(isJIT);
+#ifdef AF_CACHE_KERNELS_TO_DISK
+    const string cacheDirectory = getNativeCacheDirectory();
+    if (cacheDirectory.empty()) { return Module{}; }
+
+    const string cacheFile =
+        cacheDirectory + AF_PATH_SEPARATOR + getKernelCacheFilename(moduleKey);
+    if (!isPrivatePath(cacheFile, false)) { return Module{}; }
+
+    LibHandle handle = loadLibrary(cacheFile.c_str());
+    if (!handle) {
+        AF_TRACE("{{{:<20} : Failed to load {}, removed; {}}}", moduleKey,
+                 cacheFile, getErrorMessage());
+        removeFile(cacheFile);
+        return Module{};
+    }
+    AF_TRACE("{{{:<20} : loaded from {}}}", moduleKey, cacheFile);
+    return {handle};
+#else
+    UNUSED(moduleKey);
+    return Module{};
+#endif
+}
+
+Kernel getKernel(const Module &mod, const string &nameExpr,
+                 const bool sourceWasJIT) {
+    UNUSED(sourceWasJIT);
+    return {nameExpr, mod.get(),
+            getFunctionPointer(mod.get(), nameExpr.c_str())};
+}
+
+}  // namespace common
+}  // namespace arrayfire
@@ -7,16 +7,25 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
-#include <common/DefaultMemoryManager.hpp>
+#include <common/SizeClassMemoryManager.hpp>
 #include <common/err_common.hpp>
 #include <common/graphics_common.hpp>
+#include <common/util.hpp>
 #include <device_manager.hpp>
 #include <memory.hpp>
+#include <task_scheduler.hpp>
 #include <af/version.h>
 
+#include <algorithm>
+#include <array>
 #include <cctype>
 #include <sstream>
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using arrayfire::common::getEnvVar;
 using arrayfire::common::MemoryManagerBase;
 using std::string;
 
@@ -28,7 +37,9 @@ CPUInfo::CPUInfo()
     , mNumSMT(0)
     , mNumCores(0)
     , mNumLogCpus(0)
-    , mIsHTT(false) {
+    , mIsHTT(false)
+    , mL1CacheSize(0)
+    , mL2CacheSize(0) {
     // Get vendor name EAX=0
     CPUID cpuID1(1, 0);
     mIsHTT = cpuID1.EDX() & HTT_POS;
@@ -105,6 +116,33 @@ CPUInfo::CPUInfo()
         mModelName += string(reinterpret_cast<const char*>(&cpuID.EDX()), 4);
     }
     mModelName.shrink_to_fit();
+    detectCacheSizes();
+}
+
+void CPUInfo::detectCacheSizes() {
+    if (mVendorId == "Intel" && CPUID(0, 0).EAX() >= 4) {
+        // Each sub-leaf describes one cache until the null cache type
+        for (unsigned i = 0; i < 16; ++i) {
+            CPUID cpuID4(4, i);
+            uint32_t type = cpuID4.EAX() & 0x1FU;
+            if (type == 0) { break; }
+            uint32_t level    = (cpuID4.EAX() >> 5U) & 0x7U;
+            size_t ways       = ((cpuID4.EBX() >> 22U) & 0x3FFU) + 1;
+            size_t partitions = ((cpuID4.EBX() >> 12U) & 0x3FFU) + 1;
+            size_t line       = (cpuID4.EBX() & 0xFFFU) + 1;
+            size_t sets       = static_cast<size_t>(cpuID4.ECX()) + 1;
+            size_t size       = ways * partitions * line * sets;
+            // Types 1 and 3 are the data and unified caches
+            if (level == 1 && type == 1) { mL1CacheSize = size; }
+            if (level == 2 && type != 2) { mL2CacheSize = size; }
+        }
+    } else if (mVendorId == "AMD" &&
+               CPUID(0x80000000, 0).EAX() >= 0x80000006U) {
+        mL1CacheSize = (CPUID(0x80000005, 0).ECX() >> 24U) * 1024;
+        mL2CacheSize = (CPUID(0x80000006, 0).ECX() >> 16U) * 1024;
+    }
+    if (mL1CacheSize == 0) { mL1CacheSize = DEFAULT_L1_CACHE_SIZE; }
+    if (mL2CacheSize == 0) { mL2CacheSize = DEFAULT_L2_CACHE_SIZE; }
 }
 
 #else
@@ -115,7 +153,22 @@ CPUInfo::CPUInfo()
     , mNumSMT(1)
     , mNumCores(1)
     , mNumLogCpus(1)
-    , mIsHTT(false) {}
+    , mIsHTT(false)
+    , mL1CacheSize(0)
+    , mL2CacheSize(0) {
+    detectCacheSizes();
+}
+
+void CPUInfo::detectCacheSizes() {
+#if defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE)
+    long l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+    long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (l1 > 0) { mL1CacheSize = static_cast<size_t>(l1); }
+    if (l2 > 0) { mL2CacheSize = static_cast<size_t>(l2); }
+#endif
+    if (mL1CacheSize == 0) { mL1CacheSize = DEFAULT_L1_CACHE_SIZE; }
+    if (mL2CacheSize == 0) { mL2CacheSize = DEFAULT_L2_CACHE_SIZE; }
+}
 
 #endif
 
@@ -124,8 +177,10 @@ namespace cpu {
 
 DeviceManager::DeviceManager()
     : queues(MAX_QUEUES)
+    , thread_queues_enabled(getEnvVar("AF_CPU_THREAD_QUEUES") == "1")
+    , threadPool(std::make_shared<ThreadPool>(getDefaultThreadCount()))
     , fgMngr(new common::ForgeManager())
-    , memManager(new common::DefaultMemoryManager(
+    , memManager(common::createDefaultMemoryManager(
           getDeviceCount(), common::MAX_BUFFERS,
           AF_MEM_DEBUG || AF_CPU_MEM_DEBUG)) {
     // Use the default ArrayFire memory manager
@@ -143,9 +198,9 @@ CPUInfo DeviceManager::getCPUInfo() const { return cinfo; }
 
 void DeviceManager::resetMemoryManager() {
     // Replace with default memory manager
-    std::unique_ptr<MemoryManagerBase> mgr(
-        new common::DefaultMemoryManager(getDeviceCount(), common::MAX_BUFFERS,
-                                         AF_MEM_DEBUG || AF_CPU_MEM_DEBUG));
+    std::unique_ptr<MemoryManagerBase> mgr = common::createDefaultMemoryManager(
+        getDeviceCount(), common::MAX_BUFFERS,
+        AF_MEM_DEBUG || AF_CPU_MEM_DEBUG);
     setMemoryManager(std::move(mgr));
 }
 
@@ -166,6 +221,93 @@ void DeviceManager::setMemoryManager(
     memManager->initialize();
 }
 
+void DeviceManager::setThreadCount(int num_threads) {
+    std::lock_guard<std::mutex> l(mutex);
+    if (std::atomic_load(&threadPool)->size() == num_threads) { return; }
+    // The functions called earlier complete with the previous number of
+    // threads
+    for (auto& q : queues) { q.sync(); }
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        for (queue* q : thread_queues) { q->wait(); }
+    }
+    // The previous pool is destroyed once the kernels using it release it
+    std::atomic_store(&threadPool, std::make_shared<ThreadPool>(num_threads));
+}
+
+void DeviceManager::setThreadQueues(bool enable) {
+    std::lock_guard<std::mutex> l(mutex);
+    if (isThreadQueueEnabled() == enable) { return; }
+    // The buffers freed on the queues are released differently in each mode
+    for (auto& q : queues) { q.sync(); }
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        for (queue* q : thread_queues) { q->wait(); }
+    }
+    thread_queues_enabled.store(enable, std::memory_order_release);
+}
+
+namespace {
+
+/// The queues created by a host thread. They are destroyed when the thread
+/// exits once their tasks have completed.
+struct ThreadQueues {
+    std::array<std::unique_ptr<queue>, DeviceManager::MAX_QUEUES> queues;
+
+    ThreadQueues() = default;
+    ~ThreadQueues();
+};
+
+/// False once the queues of the calling thread have been destroyed
+thread_local bool thread_queues_alive = true;
+
+ThreadQueues::~ThreadQueues() {
+    thread_queues_alive = false;
+    for (auto& q : queues) {
+        if (!q) { continue; }
+        q->wait();
+        DeviceManager::getInstance().unregisterQueue(q.get());
+    }
+}
+
+}  // namespace
+
+queue& DeviceManager::getThreadQueue(int device) {
+    // The workers run the functions they call inline so they do not need
+    // queues of their own. The arrays released at the exit of a thread use
+    // the shared queue.
+    if (TaskScheduler::current() || !thread_queues_alive) {
+        return queues[device];
+    }
+
+    thread_local ThreadQueues local;
+    std::unique_ptr<queue>& q = local.queues[device];
+    if (!q) {
+        q = std::make_unique<queue>();
+        registerQueue(q.get());
+    }
+    return *q;
+}
+
+void DeviceManager::registerQueue(queue* q) {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    thread_queues.push_back(q);
+}
+
+void DeviceManager::unregisterQueue(queue* q) {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    thread_queues.erase(
+        std::remove(thread_queues.begin(), thread_queues.end(), q),
+        thread_queues.end());
+}
+
+void DeviceManager::forEachQueue(const std::function<void(queue&)>& func) {
+    // The threads unregister their queues before destroying them
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    for (auto& q : queues) { func(q); }
+    for (queue* q : thread_queues) { func(*q); }
+}
+
 void DeviceManager::setMemoryManagerPinned(
     std::unique_ptr<MemoryManagerBase> newMgr) {
     UNUSED(newMgr);
@@ -11,6 +11,9 @@
 
 #include <platform.hpp>
 #include <queue.hpp>
+#include <thread_pool.hpp>
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -69,6 +72,10 @@ class CPUInfo {
     std::string vendor() const { return mVendorId; }
     std::string model() const { return mModelName; }
     int threads() const { return mNumLogCpus; }
+    /// The size in bytes of the level 1 data cache of a core
+    size_t l1CacheSize() const { return mL1CacheSize; }
+    /// The size in bytes of the level 2 cache of a core
+    size_t l2CacheSize() const { return mL2CacheSize; }
 
    private:
     // Bit positions for data extractions
@@ -77,6 +84,12 @@ class CPUInfo {
     static const uint32_t LVL_CORES = 0x0000FFFF;
     static const uint32_t HTT_POS   = 0x10000000;
 
+    // Cache sizes used when they can not be detected
+    static const size_t DEFAULT_L1_CACHE_SIZE = 32 * 1024;
+    static const size_t DEFAULT_L2_CACHE_SIZE = 256 * 1024;
+
+    void detectCacheSizes();
+
     // Attributes
     std::string mVendorId;
     std::string mModelName;
@@ -84,6 +97,8 @@ class CPUInfo {
     unsigned mNumCores;
     unsigned mNumLogCpus;
     bool mIsHTT;
+    size_t mL1CacheSize;
+    size_t mL2CacheSize;
 };
 
 namespace arrayfire {
@@ -93,6 +108,7 @@ class DeviceManager {
    public:
     static const int MAX_QUEUES            = 1;
     static const int NUM_DEVICES           = 1;
+    static const int MAX_DEVICES           = NUM_DEVICES;
     static const unsigned ACTIVE_DEVICE_ID = 0;
     static const bool IS_DOUBLE_SUPPORTED  = true;
 
@@ -103,6 +119,30 @@ class DeviceManager {
 
     friend queue& getQueue(int device);
 
+    /// Returns the queue of \p device used by the calling thread when each
+    /// host thread has its own queues
+    queue& getThreadQueue(int device);
+
+    /// Returns true if each host thread uses its own queues
+    bool isThreadQueueEnabled() const {
+        return thread_queues_enabled.load(std::memory_order_acquire);
+    }
+
+    /// Makes each host thread use its own queues if \p enable is true. The
+    /// work of every queue is waited for before switching.
+    void setThreadQueues(bool enable);
+
+    /// Makes the functions waiting for every queue, such as setThreadCount,
+    /// wait for \p q
+    void registerQueue(queue* q);
+
+    /// Calls \p func on the shared queues and on the queues of every host
+    /// thread. The queues are not destroyed while \p func runs.
+    void forEachQueue(const std::function<void(queue&)>& func);
+
+    /// Reverts registerQueue
+    void unregisterQueue(queue* q);
+
     friend MemoryManagerBase& memoryManager();
 
     friend void setMemoryManager(std::unique_ptr<MemoryManagerBase> mgr);
@@ -120,6 +160,12 @@ class DeviceManager {
 
     friend arrayfire::common::ForgeManager& forgeManager();
 
+    friend std::shared_ptr<ThreadPool> getThreadPool();
+
+    /// Replaces the thread pool with one using \p num_threads threads. The
+    /// kernels already holding the previous pool keep using it.
+    void setThreadCount(int num_threads);
+
     void setMemoryManager(std::unique_ptr<MemoryManagerBase> mgr);
 
     void resetMemoryManager();
@@ -137,6 +183,11 @@ class DeviceManager {
 
     // Attributes
     std::vector<queue> queues;
+    std::vector<queue*> thread_queues;
+    std::mutex queue_mutex;
+    std::atomic<bool> thread_queues_enabled;
+    /// Accessed with std::atomic_load and std::atomic_store
+    std::shared_ptr<ThreadPool> threadPool;
     std::unique_ptr<arrayfire::common::ForgeManager> fgMngr;
     const CPUInfo cinfo;
     std::unique_ptr<MemoryManagerBase> memManager;
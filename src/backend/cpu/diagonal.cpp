@@ -8,20 +8,22 @@
  ********************************************************/
 
 #include <diagonal.hpp>
-#include <kernel/diagonal.hpp>
 
 #include <Array.hpp>
 #include <common/half.hpp>
-#include <platform.hpp>
+#include <jit/BufferNode.hpp>
+#include <jit/GeneratorNode.hpp>
 #include <af/defines.h>
 #include <af/dim4.hpp>
 
 #include <algorithm>
 #include <cstdlib>
+#include <memory>
 
 using arrayfire::common::half;  // NOLINT(misc-unused-using-decls) bug in
                                 // clang-tidy
 using std::abs;  // NOLINT(misc-unused-using-decls) bug in clang-tidy
+using std::make_shared;
 using std::min;  // NOLINT(misc-unused-using-decls) bug in clang-tidy
 
 namespace arrayfire {
@@ -29,24 +31,38 @@ namespace cpu {
 
 template<typename T>
 Array<T> diagCreate(const Array<T> &in, const int num) {
-    int size     = in.dims()[0] + abs(num);
-    int batch    = in.dims()[1];
-    Array<T> out = createEmptyArray<T>(dim4(size, size, batch));
+    in.eval();
 
-    getQueue().enqueue(kernel::diagCreate<T>, out, in, num);
+    int size  = in.dims()[0] + abs(num);
+    int batch = in.dims()[1];
+    dim4 odims(size, size, batch);
 
-    return out;
+    auto node = make_shared<jit::GeneratorNode<T, jit::DiagonalGenerator<T>>>(
+        odims, dim4(num, 0, 0, 0));
+    node->setData(in.getData(), in.getDataDims().elements() * sizeof(T),
+                  in.getOffset(), in.strides().get());
+    return createNodeArray<T>(odims, node);
 }
 
 template<typename T>
 Array<T> diagExtract(const Array<T> &in, const int num) {
-    const dim4 &idims = in.dims();
-    dim_t size        = min(idims[0], idims[1]) - abs(num);
-    Array<T> out      = createEmptyArray<T>(dim4(size, 1, idims[2], idims[3]));
+    in.eval();
 
-    getQueue().enqueue(kernel::diagExtract<T>, out, in, num);
+    const dim4 &idims   = in.dims();
+    const dim4 istrides = in.strides();
+    dim_t size          = min(idims[0], idims[1]) - abs(num);
+    dim4 odims(size, 1, idims[2], idims[3]);
 
-    return out;
+    // The diagonal is read from the input like a strided view
+    const dim_t step   = istrides[0] + istrides[1];
+    const dim_t offset = in.getOffset() +
+                         (num > 0 ? num * istrides[1] : -num * istrides[0]);
+    const dim4 ostrides(step, step * size, istrides[2], istrides[3]);
+
+    auto node = make_shared<jit::BufferNode<T>>();
+    node->setData(in.getData(), in.getDataDims().elements() * sizeof(T),
+                  offset, odims.get(), ostrides.get(), false);
+    return createNodeArray<T>(odims, node);
 }
 
 #define INSTANTIATE_DIAGONAL(T)                                          \
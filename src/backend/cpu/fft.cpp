@@ -17,6 +17,7 @@
 #include <af/dim4.hpp>
 
 #include <array>
+#include <mutex>
 #include <type_traits>
 
 using af::dim4;
@@ -25,6 +26,11 @@ using std::array;
 namespace arrayfire {
 namespace cpu {
 
+std::mutex &getFFTPlannerMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
 template<typename T>
 struct fftw_transform;
 
@@ -36,10 +42,14 @@ struct fftw_transform;
                                                                        \
         template<typename... Args>                                     \
         plan_t create(Args... args) {                                  \
+            std::lock_guard<std::mutex> lock(getFFTPlannerMutex());    \
             return PRE##_plan_many_dft(args...);                       \
         }                                                              \
         void execute(plan_t plan) { return PRE##_execute(plan); }      \
-        void destroy(plan_t plan) { return PRE##_destroy_plan(plan); } \
+        void destroy(plan_t plan) {                                    \
+            std::lock_guard<std::mutex> lock(getFFTPlannerMutex());    \
+            return PRE##_destroy_plan(plan);                           \
+        }                                                              \
     };
 
 TRANSFORM(fftwf, cfloat)
@@ -56,10 +66,14 @@ struct fftw_real_transform;
                                                                        \
         template<typename... Args>                                     \
         plan_t create(Args... args) {                                  \
+            std::lock_guard<std::mutex> lock(getFFTPlannerMutex());    \
             return PRE##_plan_many_dft_##POST(args...);                \
         }                                                              \
         void execute(plan_t plan) { return PRE##_execute(plan); }      \
-        void destroy(plan_t plan) { return PRE##_destroy_plan(plan); } \
+        void destroy(plan_t plan) {                                    \
+            std::lock_guard<std::mutex> lock(getFFTPlannerMutex());    \
+            return PRE##_destroy_plan(plan);                           \
+        }                                                              \
     };
 
 TRANSFORM_REAL(fftwf, cfloat, float, r2c)
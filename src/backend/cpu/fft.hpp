@@ -10,6 +10,7 @@
 #include <Array.hpp>
 
 #include <cstddef>
+#include <mutex>
 
 namespace af {
 class dim4;
@@ -20,6 +21,11 @@ namespace cpu {
 
 void setFFTPlanCacheSize(size_t numPlans);
 
+/// Returns the mutex guarding the creation and destruction of the FFTW plans.
+/// The FFTW planner is not thread safe and the tasks of a queue can run
+/// concurrently.
+std::mutex &getFFTPlannerMutex();
+
 template<typename T>
 void fft_inplace(Array<T> &in, const int rank, const bool direction);
 
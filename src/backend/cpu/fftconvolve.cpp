@@ -11,6 +11,7 @@
 
 #include <Array.hpp>
 #include <common/dispatch.hpp>
+#include <fft.hpp>
 #include <fftw3.h>
 #include <kernel/fftconvolve.hpp>
 #include <queue.hpp>
@@ -19,6 +20,7 @@
 #include <array>
 #include <cmath>
 #include <functional>
+#include <mutex>
 #include <type_traits>
 
 using af::dim4;
@@ -102,6 +104,7 @@ Array<T> fftconvolve(Array<T> const& signal, Array<T> const& filter,
         const dim4 packed_strides = packed.strides();
         // Compute forward FFT
         if (IsTypeDouble) {
+            std::unique_lock<std::mutex> lock(getFFTPlannerMutex());
             fftw_plan plan = fftw_plan_many_dft(
                 rank, fftDims.data(), packedDims[rank],
                 reinterpret_cast<fftw_complex*>(packed.get()), nullptr,
@@ -109,10 +112,14 @@ Array<T> fftconvolve(Array<T> const& signal, Array<T> const& filter,
                 reinterpret_cast<fftw_complex*>(packed.get()), nullptr,
                 packed_strides[0], packed_strides[rank] / 2, FFTW_FORWARD,
                 FFTW_ESTIMATE);  // NOLINT(hicpp-signed-bitwise)
+            lock.unlock();
 
             fftw_execute(plan);
+
+            lock.lock();
             fftw_destroy_plan(plan);
         } else {
+            std::unique_lock<std::mutex> lock(getFFTPlannerMutex());
             fftwf_plan plan = fftwf_plan_many_dft(
                 rank, fftDims.data(), packedDims[rank],
                 reinterpret_cast<fftwf_complex*>(packed.get()), nullptr,
@@ -120,8 +127,11 @@ Array<T> fftconvolve(Array<T> const& signal, Array<T> const& filter,
                 reinterpret_cast<fftwf_complex*>(packed.get()), nullptr,
                 packed_strides[0], packed_strides[rank] / 2, FFTW_FORWARD,
                 FFTW_ESTIMATE);  // NOLINT(hicpp-signed-bitwise)
+            lock.unlock();
 
             fftwf_execute(plan);
+
+            lock.lock();
             fftwf_destroy_plan(plan);
         }
     };
@@ -139,6 +149,7 @@ Array<T> fftconvolve(Array<T> const& signal, Array<T> const& filter,
         const dim4 packed_strides = packed.strides();
         // Compute inverse FFT
         if (IsTypeDouble) {
+            std::unique_lock<std::mutex> lock(getFFTPlannerMutex());
             fftw_plan plan = fftw_plan_many_dft(
                 rank, fftDims.data(), packedDims[rank],
                 reinterpret_cast<fftw_complex*>(packed.get()), nullptr,
@@ -146,10 +157,14 @@ Array<T> fftconvolve(Array<T> const& signal, Array<T> const& filter,
                 reinterpret_cast<fftw_complex*>(packed.get()), nullptr,
                 packed_strides[0], packed_strides[rank] / 2, FFTW_BACKWARD,
                 FFTW_ESTIMATE);  // NOLINT(hicpp-signed-bitwise)
+            lock.unlock();
 
             fftw_execute(plan);
+
+            lock.lock();
             fftw_destroy_plan(plan);
         } else {
+            std::unique_lock<std::mutex> lock(getFFTPlannerMutex());
             fftwf_plan plan = fftwf_plan_many_dft(
                 rank, fftDims.data(), packedDims[rank],
                 reinterpret_cast<fftwf_complex*>(packed.get()), nullptr,
@@ -157,8 +172,11 @@ Array<T> fftconvolve(Array<T> const& signal, Array<T> const& filter,
                 reinterpret_cast<fftwf_complex*>(packed.get()), nullptr,
                 packed_strides[0], packed_strides[rank] / 2, FFTW_BACKWARD,
                 FFTW_ESTIMATE);  // NOLINT(hicpp-signed-bitwise)
+            lock.unlock();
 
             fftwf_execute(plan);
+
+            lock.lock();
             fftwf_destroy_plan(plan);
         }
     };
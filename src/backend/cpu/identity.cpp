@@ -7,27 +7,26 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 #include <identity.hpp>
-#include <kernel/identity.hpp>
 
 #include <Array.hpp>
 #include <common/half.hpp>
-#include <platform.hpp>
-#include <queue.hpp>
+#include <jit/GeneratorNode.hpp>
 #include <af/dim4.hpp>
 
+#include <memory>
+
 using arrayfire::common::half;  // NOLINT(misc-unused-using-decls) bug in
                                 // clang-tidy
+using std::make_shared;
 
 namespace arrayfire {
 namespace cpu {
 
 template<typename T>
 Array<T> identity(const dim4& dims) {
-    Array<T> out = createEmptyArray<T>(dims);
-
-    getQueue().enqueue(kernel::identity<T>, out);
-
-    return out;
+    return createNodeArray<T>(
+        dims, make_shared<jit::GeneratorNode<T, jit::IdentityGenerator<T>>>(
+                  dims, dim4(0, 0, 0, 0)));
 }
 
 #define INSTANTIATE_IDENTITY(T) \
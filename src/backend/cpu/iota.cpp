@@ -7,16 +7,17 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 #include <iota.hpp>
-#include <kernel/iota.hpp>
 
 #include <Array.hpp>
 #include <common/half.hpp>
+#include <jit/GeneratorNode.hpp>
 #include <math.hpp>
-#include <platform.hpp>
-#include <queue.hpp>
+
+#include <memory>
 
 using arrayfire::common::half;  // NOLINT(misc-unused-using-decls) bug in
                                 // clang-tidy
+using std::make_shared;
 
 namespace arrayfire {
 namespace cpu {
@@ -25,11 +26,9 @@ template<typename T>
 Array<T> iota(const dim4 &dims, const dim4 &tile_dims) {
     dim4 outdims = dims * tile_dims;
 
-    Array<T> out = createEmptyArray<T>(outdims);
-
-    getQueue().enqueue(kernel::iota<T>, out, dims);
-
-    return out;
+    return createNodeArray<T>(
+        outdims, make_shared<jit::GeneratorNode<T, jit::IotaGenerator<T>>>(
+                     outdims, dims));
 }
 
 #define INSTANTIATE(T) \
@@ -11,10 +11,12 @@
 
 #include <binary.hpp>
 #include <common/jit/Node.hpp>
+#include <jit/kernel_generators.hpp>
 #include <math.hpp>
 #include <optypes.hpp>
 
 #include <array>
+#include <string>
 #include <vector>
 
 namespace arrayfire {
@@ -25,14 +27,14 @@ namespace jit {
 template<typename To, typename Ti, af_op_t op>
 class BinaryNode : public TNode<compute_t<To>> {
    protected:
-    BinOp<compute_t<To>, compute_t<Ti>, op> m_op;
     using TNode<compute_t<To>>::m_children;
 
    public:
     BinaryNode(common::Node_ptr lhs, common::Node_ptr rhs)
-        : TNode<compute_t<To>>(compute_t<To>(0),
-                               std::max(lhs->getHeight(), rhs->getHeight()) + 1,
-                               {{lhs, rhs}}, common::kNodeType::Nary) {}
+        : TNode<compute_t<To>>(std::max(lhs->getHeight(), rhs->getHeight()) + 1,
+                               {{lhs, rhs}}, common::kNodeType::Nary) {
+        this->mixHash(static_cast<size_t>(op));
+    }
 
     std::unique_ptr<common::Node> clone() final {
         return std::make_unique<BinaryNode>(*this);
@@ -40,27 +42,36 @@ class BinaryNode : public TNode<compute_t<To>> {
 
     af_op_t getOp() const noexcept final { return op; }
 
-    void calc(int x, int y, int z, int w, int lim) final {
-        UNUSED(x);
-        UNUSED(y);
-        UNUSED(z);
-        UNUSED(w);
-        auto lhs = static_cast<TNode<compute_t<Ti>> *>(m_children[0].get());
-        auto rhs = static_cast<TNode<compute_t<Ti>> *>(m_children[1].get());
-        m_op.eval(this->m_val, lhs->m_val, rhs->m_val, lim);
+    bool isEquivalent(const common::Node &other) const noexcept final {
+        return other.getNodeType() == common::kNodeType::Nary &&
+               other.getOp() == op && other.getType() == this->getType();
+    }
+
+    static void eval(void *out, const void *const *in, int lim) {
+        using Tc = compute_t<Ti>;
+        BinOp<compute_t<To>, Tc, op> binop;
+        binop.eval(*static_cast<array<compute_t<To>> *>(out),
+                   *static_cast<const array<Tc> *>(in[0]),
+                   *static_cast<const array<Tc> *>(in[1]), lim);
     }
 
-    void calc(int idx, int lim) final {
-        UNUSED(idx);
-        auto lhs = static_cast<TNode<compute_t<Ti>> *>(m_children[0].get());
-        auto rhs = static_cast<TNode<compute_t<Ti>> *>(m_children[1].get());
-        m_op.eval(this->m_val, lhs->m_val, rhs->m_val, lim);
+    bool getInstruction(Instruction &inst) const final {
+        inst.kind = InstructionKind::Op;
+        inst.op   = eval;
+        return true;
     }
 
     void genKerName(std::string &kerString,
                     const common::Node_ids &ids) const final {
-        UNUSED(kerString);
-        UNUSED(ids);
+        kerString += '_';
+        kerString += this->getNameStr();
+        kerString += std::to_string(op);
+        kerString += ',';
+        kerString += std::to_string(ids.child_ids[0]);
+        kerString += ',';
+        kerString += std::to_string(ids.child_ids[1]);
+        kerString += ',';
+        kerString += std::to_string(ids.id);
     }
 
     void genParams(std::stringstream &kerStream, int id,
@@ -88,8 +99,9 @@ class BinaryNode : public TNode<compute_t<To>> {
 
     void genFuncs(std::stringstream &kerStream,
                   const common::Node_ids &ids) const final {
-        UNUSED(kerStream);
-        UNUSED(ids);
+        kerStream << this->getTypeStr() << " val" << ids.id << " = "
+                  << getNativeFunctionName(op) << "(val" << ids.child_ids[0]
+                  << ", val" << ids.child_ids[1] << ");\n";
     }
 };
 
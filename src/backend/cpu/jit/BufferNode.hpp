@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <jit/kernel_generators.hpp>
 #include <optypes.hpp>
 #include <af/defines.h>
 #include "Node.hpp"
@@ -35,7 +36,7 @@ class BufferNode : public TNode<T> {
 
    public:
     BufferNode()
-        : TNode<T>(T(0), 0, {}, common::kNodeType::Buffer)
+        : TNode<T>(0, {}, common::kNodeType::Buffer)
         , m_bytes(0)
         , m_strides{0, 0, 0, 0}
         , m_dims{0, 0, 0, 0}
@@ -70,31 +71,62 @@ class BufferNode : public TNode<T> {
         m_strides[3]     = new_strides[3];
     }
 
-    void calc(int x, int y, int z, int w, int lim) final {
+    /// Reads the elements of the buffer described by \p leaf starting at the
+    /// coordinates (x, y, z, w). Dimensions of size one are broadcast and
+    /// the strides of views are applied to every dimension.
+    static void load(void *out, const Leaf &leaf, int x, int y, int z, int w,
+                     int lim) {
         using Tc = compute_t<T>;
 
         dim_t l_off = 0;
-        l_off += (w < (int)m_dims[3]) * w * m_strides[3];
-        l_off += (z < (int)m_dims[2]) * z * m_strides[2];
-        l_off += (y < (int)m_dims[1]) * y * m_strides[1];
-        T *in_ptr   = m_ptr + l_off;
-        Tc *out_ptr = this->m_val.data();
-        for (int i = 0; i < lim; i++) {
-            out_ptr[i] =
-                static_cast<Tc>(in_ptr[((x + i) < m_dims[0]) ? (x + i) : 0]);
+        l_off += (w < (int)leaf.dims[3]) * w * leaf.strides[3];
+        l_off += (z < (int)leaf.dims[2]) * z * leaf.strides[2];
+        l_off += (y < (int)leaf.dims[1]) * y * leaf.strides[1];
+        const T *in_ptr = static_cast<const T *>(leaf.ptr) + l_off;
+        Tc *out_ptr     = static_cast<Tc *>(out);
+        if (leaf.strides[0] == 1) {
+            for (int i = 0; i < lim; i++) {
+                out_ptr[i] = static_cast<Tc>(
+                    in_ptr[((x + i) < leaf.dims[0]) ? (x + i) : 0]);
+            }
+        } else {
+            // Strided views gather their elements
+            const dim_t stride = leaf.strides[0];
+            for (int i = 0; i < lim; i++) {
+                out_ptr[i] = static_cast<Tc>(
+                    in_ptr[((x + i) < leaf.dims[0]) ? (x + i) * stride : 0]);
+            }
         }
     }
 
-    void calc(int idx, int lim) final {
+    /// Reads the elements [idx, idx + lim) of the linear buffer described by
+    /// \p leaf
+    static void loadLinear(void *out, const Leaf &leaf, dim_t idx, int lim) {
         using Tc = compute_t<T>;
 
-        T *in_ptr   = m_ptr + idx;
-        Tc *out_ptr = this->m_val.data();
+        const T *in_ptr = static_cast<const T *>(leaf.ptr) + idx;
+        Tc *out_ptr     = static_cast<Tc *>(out);
         for (int i = 0; i < lim; i++) {
             out_ptr[i] = static_cast<Tc>(in_ptr[i]);
         }
     }
 
+    bool getInstruction(Instruction &inst) const final {
+        inst.kind        = InstructionKind::Load;
+        inst.load        = load;
+        inst.load_linear = loadLinear;
+        return true;
+    }
+
+    void bind(Leaf &leaf) const final {
+        leaf.ptr    = m_ptr;
+        leaf.linear = m_linear_buffer;
+        for (int i = 0; i < 4; i++) {
+            leaf.dims[i]    = m_dims[i];
+            leaf.strides[i] = m_strides[i];
+        }
+    }
+
     void getInfo(unsigned &len, unsigned &buf_count,
                  unsigned &bytes) const final {
         len++;
@@ -107,15 +139,16 @@ class BufferNode : public TNode<T> {
 
     void genKerName(std::string &kerString,
                     const common::Node_ids &ids) const final {
-        UNUSED(kerString);
-        UNUSED(ids);
+        kerString += '_';
+        kerString += this->getNameStr();
+        kerString += ',';
+        kerString += std::to_string(ids.id);
     }
 
     void genParams(std::stringstream &kerStream, int id,
                    bool is_linear) const final {
-        UNUSED(kerStream);
-        UNUSED(id);
         UNUSED(is_linear);
+        generateParamDeclaration(kerStream, id, this->getTypeStr());
     }
 
     int setArgs(int start_id, bool is_linear,
@@ -129,15 +162,12 @@ class BufferNode : public TNode<T> {
 
     void genOffsets(std::stringstream &kerStream, int id,
                     bool is_linear) const final {
-        UNUSED(kerStream);
-        UNUSED(id);
-        UNUSED(is_linear);
+        generateBufferOffsets(kerStream, id, is_linear);
     }
 
     void genFuncs(std::stringstream &kerStream,
                   const common::Node_ids &ids) const final {
-        UNUSED(kerStream);
-        UNUSED(ids);
+        generateBufferRead(kerStream, ids.id, this->getTypeStr());
     }
 
     bool isLinear(const dim_t *dims) const final {
@@ -175,6 +205,11 @@ class BufferNode : public TNode<T> {
         }
         return false;
     }
+
+    /// Buffers reading the same elements are equivalent
+    bool isEquivalent(const common::Node &other) const noexcept final {
+        return *this == other;
+    }
 };
 
 }  // namespace jit
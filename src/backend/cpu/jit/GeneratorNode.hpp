@@ -0,0 +1,364 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/jit/Node.hpp>
+#include <jit/kernel_generators.hpp>
+#include <af/dim4.hpp>
+#include "Node.hpp"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace arrayfire {
+namespace cpu {
+
+namespace jit {
+
+/// The parameters of a generator read by its load functions. The native
+/// kernels declare the same structure.
+struct GeneratorInfo {
+    dim_t dims[4];     ///< The shape of the generated array
+    dim_t params[4];   ///< The parameters of the generator
+    const void *data;  ///< The buffer read by the generator or nullptr
+    dim_t strides[4];  ///< The strides of data
+};
+
+/// The coordinate along the dimension params[0]
+template<typename T>
+struct RangeGenerator {
+    static constexpr const char *name = "range";
+
+    static compute_t<T> value(const GeneratorInfo &info, const dim_t *c) {
+        return static_cast<compute_t<T>>(c[info.params[0]]);
+    }
+
+    static void genValue(std::stringstream &kerStream, const std::string &g,
+                         const std::string &c, const std::string &type_str) {
+        kerStream << "(" << type_str << ")" << c << "[" << g << ".params[0]]";
+    }
+};
+
+/// The position of the element in the sequence of shape params repeated
+/// along the array
+template<typename T>
+struct IotaGenerator {
+    static constexpr const char *name = "iota";
+
+    static compute_t<T> value(const GeneratorInfo &info, const dim_t *c) {
+        const dim_t *p = info.params;
+        return static_cast<compute_t<T>>(
+            (((c[3] % p[3]) * p[2] + c[2] % p[2]) * p[1] + c[1] % p[1]) *
+                p[0] +
+            c[0] % p[0]);
+    }
+
+    static void genValue(std::stringstream &kerStream, const std::string &g,
+                         const std::string &c, const std::string &type_str) {
+        const std::string p = g + ".params";
+        kerStream << "(" << type_str << ")(((" << c << "[3] % " << p
+                  << "[3] * " << p << "[2] + " << c << "[2] % " << p
+                  << "[2]) * " << p << "[1] + " << c << "[1] % " << p
+                  << "[1]) * " << p << "[0] + " << c << "[0] % " << p
+                  << "[0])";
+    }
+};
+
+/// One on the diagonal of each matrix and zero elsewhere
+template<typename T>
+struct IdentityGenerator {
+    static constexpr const char *name = "identity";
+
+    static compute_t<T> value(const GeneratorInfo &info, const dim_t *c) {
+        UNUSED(info);
+        return static_cast<compute_t<T>>(c[0] == c[1] ? 1 : 0);
+    }
+
+    static void genValue(std::stringstream &kerStream, const std::string &g,
+                         const std::string &c, const std::string &type_str) {
+        UNUSED(g);
+        kerStream << "(" << type_str << ")(" << c << "[0] == " << c << "[1])";
+    }
+};
+
+/// The elements of the columns of data on the diagonal params[0] of each
+/// matrix and zero elsewhere
+template<typename T>
+struct DiagonalGenerator {
+    static constexpr const char *name = "diag";
+
+    static compute_t<T> value(const GeneratorInfo &info, const dim_t *c) {
+        const dim_t num = info.params[0];
+        if (c[0] != c[1] - num) { return static_cast<compute_t<T>>(0); }
+        const T *in = static_cast<const T *>(info.data);
+        return static_cast<compute_t<T>>(
+            in[(num > 0 ? c[0] : c[1]) + c[2] * info.strides[1]]);
+    }
+
+    static void genValue(std::stringstream &kerStream, const std::string &g,
+                         const std::string &c, const std::string &type_str) {
+        const std::string num = g + ".params[0]";
+        kerStream << "(" << c << "[0] == " << c << "[1] - " << num
+                  << ") ? static_cast<const " << type_str << " *>(" << g
+                  << ".data)[(" << num << " > 0 ? " << c << "[0] : " << c
+                  << "[1]) + " << c << "[2] * " << g << ".strides[1]] : ("
+                  << type_str << ")0";
+    }
+};
+
+/// The elements of data shifted circularly by params[i] along each dimension
+/// i. The shifts are in [0, dims[i]].
+template<typename T>
+struct ShiftGenerator {
+    static constexpr const char *name = "shift";
+
+    static compute_t<T> value(const GeneratorInfo &info, const dim_t *c) {
+        dim_t off = 0;
+        for (int i = 0; i < 4; i++) {
+            dim_t ci = c[i] + info.params[i];
+            if (ci >= info.dims[i]) { ci -= info.dims[i]; }
+            off += ci * info.strides[i];
+        }
+        return static_cast<compute_t<T>>(
+            static_cast<const T *>(info.data)[off]);
+    }
+
+    static void genValue(std::stringstream &kerStream, const std::string &g,
+                         const std::string &c, const std::string &type_str) {
+        kerStream << "static_cast<const " << type_str << " *>(" << g
+                  << ".data)[";
+        for (int i = 0; i < 4; i++) {
+            const std::string d = std::to_string(i);
+            kerStream << (i ? " + " : "") << "(" << c << "[" << d << "] + "
+                      << g << ".params[" << d << "]) % " << g << ".dims[" << d
+                      << "] * " << g << ".strides[" << d << "]";
+        }
+        kerStream << "]";
+    }
+};
+
+/// The elements of data repeated along each dimension. params holds the
+/// shape of data.
+template<typename T>
+struct TileGenerator {
+    static constexpr const char *name = "tile";
+
+    static compute_t<T> value(const GeneratorInfo &info, const dim_t *c) {
+        dim_t off = 0;
+        for (int i = 0; i < 4; i++) {
+            off += (c[i] % info.params[i]) * info.strides[i];
+        }
+        return static_cast<compute_t<T>>(
+            static_cast<const T *>(info.data)[off]);
+    }
+
+    static void genValue(std::stringstream &kerStream, const std::string &g,
+                         const std::string &c, const std::string &type_str) {
+        kerStream << "static_cast<const " << type_str << " *>(" << g
+                  << ".data)[";
+        for (int i = 0; i < 4; i++) {
+            const std::string d = std::to_string(i);
+            kerStream << (i ? " + " : "") << c << "[" << d << "] % " << g
+                      << ".params[" << d << "] * " << g << ".strides[" << d
+                      << "]";
+        }
+        kerStream << "]";
+    }
+};
+
+/// A leaf whose values are a function of the coordinates of the elements
+///
+/// Generators are read like buffers: the element at a position of the
+/// generated array is computed instead of being loaded. Moddims nodes and
+/// broadcasting therefore apply to generators the same way they apply to
+/// buffers and no memory is allocated for the generated array.
+///
+/// \tparam Gen provides the value of an element from its coordinates and the
+///             code computing it in the native kernels
+template<typename T, typename Gen>
+class GeneratorNode : public TNode<T> {
+    GeneratorInfo m_info;
+
+    /// Keeps the buffer read by the generator alive
+    std::shared_ptr<T> m_data;
+    unsigned m_bytes;
+
+    using Tc = compute_t<T>;
+
+    /// Computes the elements [idx, idx + lim) of the generated array
+    static void generate(Tc *out, const GeneratorInfo &info, dim_t idx,
+                         int lim) {
+        dim_t c[4];
+        c[0] = idx % info.dims[0];
+        idx /= info.dims[0];
+        c[1] = idx % info.dims[1];
+        idx /= info.dims[1];
+        c[2] = idx % info.dims[2];
+        c[3] = idx / info.dims[2];
+        for (int i = 0; i < lim; i++) {
+            out[i] = Gen::value(info, c);
+            if (++c[0] < info.dims[0]) { continue; }
+            c[0] = 0;
+            if (++c[1] < info.dims[1]) { continue; }
+            c[1] = 0;
+            if (++c[2] < info.dims[2]) { continue; }
+            c[2] = 0;
+            ++c[3];
+        }
+    }
+
+   public:
+    GeneratorNode(const af::dim4 &dims, const af::dim4 &params)
+        : TNode<T>(0, {}, common::kNodeType::Generator)
+        , m_info{}
+        , m_bytes(0) {
+        for (int i = 0; i < 4; i++) {
+            m_info.dims[i]   = dims[i];
+            m_info.params[i] = params[i];
+        }
+    }
+
+    /// Sets the buffer read by the generator
+    void setData(std::shared_ptr<T> data, unsigned bytes, dim_t data_off,
+                 const dim_t *strides) {
+        m_data      = std::move(data);
+        m_bytes     = bytes;
+        m_info.data = m_data.get() + data_off;
+        for (int i = 0; i < 4; i++) { m_info.strides[i] = strides[i]; }
+    }
+
+    std::unique_ptr<common::Node> clone() final {
+        return std::make_unique<GeneratorNode>(*this);
+    }
+
+    static void load(void *out, const Leaf &leaf, int x, int y, int z, int w,
+                     int lim) {
+        const auto &info = *static_cast<const GeneratorInfo *>(leaf.ptr);
+        Tc *out_ptr      = static_cast<Tc *>(out);
+
+        dim_t l_off = 0;
+        l_off += (w < (int)leaf.dims[3]) * w * leaf.strides[3];
+        l_off += (z < (int)leaf.dims[2]) * z * leaf.strides[2];
+        l_off += (y < (int)leaf.dims[1]) * y * leaf.strides[1];
+        if (x + lim <= leaf.dims[0] && leaf.strides[0] == 1) {
+            generate(out_ptr, info, l_off + x, lim);
+            return;
+        }
+        for (int i = 0; i < lim; i++) {
+            const dim_t idx =
+                ((x + i) < leaf.dims[0]) ? (x + i) * leaf.strides[0] : 0;
+            generate(out_ptr + i, info, l_off + idx, 1);
+        }
+    }
+
+    static void loadLinear(void *out, const Leaf &leaf, dim_t idx, int lim) {
+        generate(static_cast<Tc *>(out),
+                 *static_cast<const GeneratorInfo *>(leaf.ptr), idx, lim);
+    }
+
+    bool getInstruction(Instruction &inst) const final {
+        inst.kind        = InstructionKind::Load;
+        inst.load        = load;
+        inst.load_linear = loadLinear;
+        return true;
+    }
+
+    void bind(Leaf &leaf) const final {
+        leaf.ptr    = &m_info;
+        leaf.linear = true;
+        dim_t stride = 1;
+        for (int i = 0; i < 4; i++) {
+            leaf.dims[i]    = m_info.dims[i];
+            leaf.strides[i] = stride;
+            stride *= m_info.dims[i];
+        }
+    }
+
+    void getInfo(unsigned &len, unsigned &buf_count,
+                 unsigned &bytes) const final {
+        len++;
+        buf_count += m_data ? 1 : 0;
+        bytes += m_bytes;
+    }
+
+    size_t getBytes() const final { return m_bytes; }
+
+    bool isLinear(const dim_t *dims) const final {
+        return std::equal(dims, dims + 4, m_info.dims);
+    }
+
+    size_t getHash() const noexcept final {
+        size_t out = std::hash<const void *>()(m_info.data);
+        for (int i = 0; i < 4; i++) {
+            out = out * 31 + static_cast<size_t>(m_info.dims[i]);
+            out = out * 31 + static_cast<size_t>(m_info.params[i]);
+        }
+        return out ^ (std::hash<af::dtype>()(this->getType()) << 1);
+    }
+
+    /// Generators of the same kind with the same parameters are equivalent
+    bool isEquivalent(const common::Node &other) const noexcept final {
+        const auto *node = dynamic_cast<const GeneratorNode *>(&other);
+        if (node == nullptr) { return false; }
+        const GeneratorInfo &info = node->m_info;
+        return m_info.data == info.data &&
+               std::equal(m_info.dims, m_info.dims + 4, info.dims) &&
+               std::equal(m_info.params, m_info.params + 4, info.params) &&
+               std::equal(m_info.strides, m_info.strides + 4, info.strides);
+    }
+
+    void genKerName(std::string &kerString,
+                    const common::Node_ids &ids) const final {
+        kerString += '_';
+        kerString += Gen::name;
+        kerString += this->getNameStr();
+        kerString += ',';
+        kerString += std::to_string(ids.id);
+    }
+
+    void genParams(std::stringstream &kerStream, int id,
+                   bool is_linear) const final {
+        UNUSED(is_linear);
+        kerStream << "const GeneratorInfo &gInfo" << id
+                  << " = *static_cast<const GeneratorInfo *>(iInfo" << id
+                  << ".ptr);\n";
+    }
+
+    void genOffsets(std::stringstream &kerStream, int id,
+                    bool is_linear) const final {
+        generateBufferOffsets(kerStream, id, is_linear);
+    }
+
+    void genFuncs(std::stringstream &kerStream,
+                  const common::Node_ids &ids) const final {
+        const std::string id  = std::to_string(ids.id);
+        const std::string g   = "gInfo" + id;
+        const std::string c   = "c" + id;
+        const std::string idx = "idx" + id;
+        kerStream << "dim_t " << c << "[4];\n"
+                  << c << "[0] = " << idx << " % " << g << ".dims[0];\n"
+                  << c << "[1] = " << idx << " / " << g << ".dims[0] % " << g
+                  << ".dims[1];\n"
+                  << c << "[2] = " << idx << " / (" << g << ".dims[0] * " << g
+                  << ".dims[1]) % " << g << ".dims[2];\n"
+                  << c << "[3] = " << idx << " / (" << g << ".dims[0] * " << g
+                  << ".dims[1] * " << g << ".dims[2]);\n"
+                  << this->getTypeStr() << " val" << id << " = ";
+        Gen::genValue(kerStream, g, c, this->getTypeStr());
+        kerStream << ";\n";
+    }
+};
+
+}  // namespace jit
+}  // namespace cpu
+}  // namespace arrayfire
@@ -0,0 +1,329 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <jit/Native.hpp>
+
+#include <Kernel.hpp>
+#include <common/Logger.hpp>
+#include <common/Source.hpp>
+#include <common/deterministicHash.hpp>
+#include <common/err_common.hpp>
+#include <common/kernel_cache.hpp>
+#include <common/util.hpp>
+#include <jit/kernel_generators.hpp>
+#include <platform.hpp>
+
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using arrayfire::common::findModule;
+using arrayfire::common::getEnvVar;
+using arrayfire::common::getFuncName;
+using arrayfire::common::loggerFactory;
+using arrayfire::common::Node;
+using arrayfire::common::Node_ids;
+using arrayfire::common::saveKernel;
+using spdlog::logger;
+using std::shared_ptr;
+using std::string;
+using std::stringstream;
+using std::vector;
+
+namespace arrayfire {
+namespace cpu {
+namespace jit {
+
+namespace {
+
+logger *getLogger() {
+    static shared_ptr<logger> logger(loggerFactory("jit"));
+    return logger.get();
+}
+
+/// The declarations shared by all the native kernels. The functions mirror
+/// the UnOp and BinOp implementations used by the interpreter.
+constexpr const char kNativePrelude[] = R"JIT(
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <type_traits>
+
+typedef long long dim_t;
+typedef unsigned char uchar;
+typedef unsigned short ushort;
+typedef unsigned int uint;
+typedef unsigned long ulong;
+
+struct Leaf {
+    const void *ptr;
+    dim_t dims[4];
+    dim_t strides[4];
+    bool linear;
+};
+
+struct GeneratorInfo {
+    dim_t dims[4];
+    dim_t params[4];
+    const void *data;
+    dim_t strides[4];
+};
+
+template<typename T> T __noop(T v) { return v; }
+template<typename T> char __tob8(T v) { return v != 0; }
+
+template<typename T> T __add(T a, T b) { return a + b; }
+template<typename T> T __sub(T a, T b) { return a - b; }
+template<typename T> T __mul(T a, T b) { return a * b; }
+template<typename T> T __div(T a, T b) { return a / b; }
+
+template<typename T> char __eq(T a, T b) { return a == b; }
+template<typename T> char __neq(T a, T b) { return a != b; }
+template<typename T> char __lt(T a, T b) { return a < b; }
+template<typename T> char __gt(T a, T b) { return a > b; }
+template<typename T> char __le(T a, T b) { return a <= b; }
+template<typename T> char __ge(T a, T b) { return a >= b; }
+template<typename T> char __and(T a, T b) { return a && b; }
+template<typename T> char __or(T a, T b) { return a || b; }
+
+template<typename T> T __bitand(T a, T b) { return a & b; }
+template<typename T> T __bitor(T a, T b) { return a | b; }
+template<typename T> T __bitxor(T a, T b) { return a ^ b; }
+template<typename T> T __bitshiftl(T a, T b) { return a << b; }
+template<typename T> T __bitshiftr(T a, T b) { return a >> b; }
+template<typename T> T __bitnot(T v) { return ~v; }
+
+template<typename T> T __select(char c, T a, T b) { return c ? a : b; }
+template<typename T> T __not_select(char c, T a, T b) { return c ? b : a; }
+
+template<typename T> T __min(T a, T b) { return std::min(a, b); }
+template<typename T> T __max(T a, T b) { return std::max(a, b); }
+template<typename T> T __atan2(T a, T b) { return std::atan2(a, b); }
+template<typename T> T __hypot(T a, T b) { return std::hypot(a, b); }
+
+template<typename T> T __mod(T a, T b) {
+    if constexpr (std::is_floating_point<T>::value) {
+        return std::fmod(a, b);
+    } else if constexpr (std::is_signed<T>::value) {
+        T res = a % b;
+        return (res < 0) ? std::abs(b - res) : res;
+    } else {
+        return a % b;
+    }
+}
+
+template<typename T> T __rem(T a, T b) {
+    if constexpr (std::is_floating_point<T>::value) {
+        return std::remainder(a, b);
+    } else {
+        return a % b;
+    }
+}
+
+#define UNARY_FN(fn) template<typename T> T __##fn(T v) { return std::fn(v); }
+UNARY_FN(sin) UNARY_FN(cos) UNARY_FN(tan)
+UNARY_FN(asin) UNARY_FN(acos) UNARY_FN(atan)
+UNARY_FN(sinh) UNARY_FN(cosh) UNARY_FN(tanh)
+UNARY_FN(asinh) UNARY_FN(acosh) UNARY_FN(atanh)
+UNARY_FN(round) UNARY_FN(trunc) UNARY_FN(floor) UNARY_FN(ceil)
+UNARY_FN(signbit)
+UNARY_FN(exp) UNARY_FN(expm1) UNARY_FN(erf) UNARY_FN(erfc)
+UNARY_FN(log) UNARY_FN(log10) UNARY_FN(log1p) UNARY_FN(log2)
+UNARY_FN(sqrt) UNARY_FN(cbrt) UNARY_FN(tgamma) UNARY_FN(lgamma)
+#undef UNARY_FN
+
+template<typename T> T __sigmoid(T v) { return 1.0 / (1 + std::exp(-v)); }
+template<typename T> T __rsqrt(T v) { return std::pow(v, -0.5); }
+template<typename T> char __isinf(T v) { return std::isinf(v); }
+template<typename T> char __isnan(T v) { return std::isnan(v); }
+template<typename T> char __iszero(T v) { return v == 0; }
+)JIT";
+
+/// The options passed to the host compiler
+const vector<string> &getCompileOptions() {
+    static const vector<string> options = {
+        "-std=c++17", "-O3",    "-march=native", "-fno-math-errno",
+        "-fPIC",      "-shared", "-w"};
+    return options;
+}
+
+/// Returns true if the node can be evaluated by a native kernel
+bool isNativeNode(const Node &node) {
+    switch (node.getType()) {
+        case c32:
+        case c64:
+        case f16: return false;
+        default: break;
+    }
+    if (node.isBuffer() || node.isScalar() ||
+        node.getNodeType() == common::kNodeType::Generator) {
+        return true;
+    }
+    return node.getNodeType() == common::kNodeType::Nary &&
+           getNativeFunctionName(node.getOp()) != nullptr;
+}
+
+/// Returns the ids of the nodes in the traversal of \p binding
+vector<Node_ids> getNodeIds(const TapeBinding &binding) {
+    const Tape &tape = *binding.tape;
+    vector<Node_ids> ids(binding.nodes.size());
+    for (int id = 0; id < static_cast<int>(ids.size()); id++) {
+        ids[id].id        = id;
+        ids[id].child_ids = tape.node_children[id];
+    }
+    return ids;
+}
+
+string getKernelString(const string &funcName, const TapeBinding &binding,
+                       const vector<Node_ids> &ids, const bool is_linear,
+                       const af::dtype type) {
+    const Tape &tape            = *binding.tape;
+    const vector<Node *> &nodes = binding.nodes;
+    const string type_str       = common::getFullName(type);
+    const int num_outputs       = static_cast<int>(tape.output_nodes.size());
+    const int num_leaves        = static_cast<int>(tape.leaf_nodes.size());
+
+    stringstream kerStream;
+    kerStream << "extern \"C\" void " << funcName
+              << "(const Leaf *leaves, void *const *outputs, "
+                 "const dim_t *dims, const dim_t *strides, dim_t begin, "
+                 "dim_t end) {\n";
+
+    for (int k = 0; k < num_leaves; k++) {
+        const int id = tape.leaf_nodes[k];
+        kerStream << "const Leaf &iInfo" << id << " = leaves[" << k << "];\n";
+        nodes[id]->genParams(kerStream, id, is_linear);
+    }
+    for (int k = 0; k < num_outputs; k++) {
+        kerStream << type_str << " *out" << k << " = static_cast<" << type_str
+                  << " *>(outputs[" << k << "]);\n";
+    }
+
+    if (is_linear) {
+        kerStream << "for (dim_t idx = begin; idx < end; ++idx) {\n";
+    } else {
+        kerStream << "for (dim_t row = begin; row < end; ++row) {\n"
+                  << "const dim_t id1 = row % dims[1];\n"
+                  << "const dim_t id2 = (row / dims[1]) % dims[2];\n"
+                  << "const dim_t id3 = row / (dims[1] * dims[2]);\n"
+                  << "const dim_t off = id1 * strides[1] + id2 * strides[2] "
+                     "+ id3 * strides[3];\n"
+                  << "for (dim_t id0 = 0; id0 < dims[0]; ++id0) {\n"
+                  << "const dim_t idx = off + id0;\n";
+    }
+
+    for (int id = 0; id < static_cast<int>(nodes.size()); id++) {
+        nodes[id]->genOffsets(kerStream, id, is_linear);
+    }
+    for (int id = 0; id < static_cast<int>(nodes.size()); id++) {
+        nodes[id]->genFuncs(kerStream, ids[id]);
+    }
+    for (int k = 0; k < num_outputs; k++) {
+        kerStream << "out" << k << "[idx] = val" << tape.output_nodes[k]
+                  << ";\n";
+    }
+
+    kerStream << (is_linear ? "}\n" : "}\n}\n") << "}\n";
+    return kerStream.str();
+}
+
+NativeFn compileNativeKernel(const TapeBinding &binding, const bool is_linear,
+                             const af::dtype type) {
+    const vector<Node *> &nodes = binding.nodes;
+    for (const Node *node : nodes) {
+        if (!isNativeNode(*node)) { return nullptr; }
+    }
+    switch (type) {
+        case c32:
+        case c64:
+        case f16: return nullptr;
+        default: break;
+    }
+
+    const vector<Node_ids> ids = getNodeIds(binding);
+    vector<Node *> output_nodes;
+    for (int id : binding.tape->output_nodes) {
+        output_nodes.push_back(nodes[id]);
+    }
+    const string funcName = getFuncName(output_nodes, nodes, ids, is_linear,
+                                        false, false, false, false) +
+                            '_' + common::getShortName(type);
+
+    // A forward lookup in module cache helps avoid regenerating the source
+    // of trees compiled by other threads
+    const auto entry =
+        findModule(getActiveDeviceId(), deterministicHash(funcName));
+    if (entry) {
+        return reinterpret_cast<NativeFn>(
+            common::getKernel(entry, funcName, true).get());
+    }
+
+    const string jitKer = getKernelString(funcName, binding, ids, is_linear,
+                                          type);
+    saveKernel(funcName, jitKer, ".cpp");
+
+    static const size_t prelude_hash =
+        deterministicHash(kNativePrelude, sizeof(kNativePrelude) - 1);
+    const common::Source prelude_src{kNativePrelude,
+                                     sizeof(kNativePrelude) - 1, prelude_hash};
+    const common::Source jitKer_src{
+        jitKer.data(), jitKer.size(),
+        deterministicHash(jitKer.data(), jitKer.size())};
+    return reinterpret_cast<NativeFn>(
+        common::getKernel(funcName, {{prelude_src, jitKer_src}}, {},
+                          getCompileOptions(), true)
+            .get());
+}
+
+}  // namespace
+
+namespace {
+std::atomic<bool> &nativeEnabled() {
+    static std::atomic<bool> enabled(getEnvVar("AF_CPU_JIT_NATIVE") == "1");
+    return enabled;
+}
+}  // namespace
+
+bool isNativeEnabled() {
+#if defined(OS_WIN)
+    return false;
+#else
+    return nativeEnabled().load(std::memory_order_relaxed);
+#endif
+}
+
+void setNativeEnabled(const bool enable) {
+    nativeEnabled().store(enable, std::memory_order_relaxed);
+}
+
+NativeFn getNativeKernel(const TapeBinding &binding, const bool is_linear,
+                         const af::dtype type) {
+    if (!isNativeEnabled()) { return nullptr; }
+
+    Tape::NativeKernel &kernel = binding.tape->native[is_linear];
+    if (kernel.searched && kernel.type == type) { return kernel.fn; }
+
+    kernel.type     = type;
+    kernel.searched = true;
+    try {
+        kernel.fn = compileNativeKernel(binding, is_linear, type);
+    } catch (const AfError &err) {
+        // The tree is evaluated by the interpreter if the host compiler is
+        // not available or fails
+        AF_TRACE("Native JIT kernel unavailable: {}", err.what());
+        kernel.fn = nullptr;
+    }
+    return kernel.fn;
+}
+
+}  // namespace jit
+}  // namespace cpu
+}  // namespace arrayfire
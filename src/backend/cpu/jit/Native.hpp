@@ -0,0 +1,41 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <jit/Node.hpp>
+#include <jit/Tape.hpp>
+#include <af/defines.h>
+
+namespace arrayfire {
+namespace cpu {
+namespace jit {
+
+/// Returns true if the JIT trees are compiled into native kernels. This is
+/// enabled by setting the AF_CPU_JIT_NATIVE environment variable to 1 before
+/// the backend starts or by calling setNativeEnabled.
+bool isNativeEnabled();
+
+/// Compiles the JIT trees evaluated from now on into native kernels if
+/// \p enable is true. The trees already enqueued may use either mode.
+void setNativeEnabled(const bool enable);
+
+/// Returns the native kernel evaluating the tree of \p binding into outputs
+/// of type \p type. The kernel is generated and compiled with the host
+/// compiler the first time the structure of the tree is seen and cached in
+/// memory and in the kernel cache directory.
+///
+/// Returns nullptr if native kernels are disabled, if the tree contains
+/// operations or types they do not support or if the compilation failed. The
+/// tree must then be evaluated by the tape interpreter.
+NativeFn getNativeKernel(const TapeBinding &binding, const bool is_linear,
+                         const af::dtype type);
+
+}  // namespace jit
+}  // namespace cpu
+}  // namespace arrayfire
@@ -15,6 +15,7 @@
 #include <optypes.hpp>
 #include <af/traits.hpp>
 
+#include <algorithm>
 #include <array>
 #include <memory>
 #include <unordered_map>
@@ -28,28 +29,101 @@ namespace arrayfire {
 namespace cpu {
 
 namespace jit {
+/// The largest number of elements evaluated by a chunk of a tape. The length
+/// of the chunks of each tape is chosen between kMinVectorLength and this so
+/// that its registers fit in the L1 cache.
 constexpr int VECTOR_LENGTH = 256;
 
+/// The smallest number of elements evaluated by a chunk of a tape
+constexpr int kMinVectorLength = 32;
+
 template<typename T>
 using array = std::array<T, VECTOR_LENGTH>;
 
+/// The data read by a leaf of a tree during one evaluation of a Tape. Buffers
+/// point to their first element and constants to VECTOR_LENGTH copies of
+/// their value.
+struct Leaf {
+    const void *ptr;
+    dim_t dims[4];
+    dim_t strides[4];
+    bool linear;
+};
+
+/// Computes lim values of a node from the values of its children
+using OpFn = void (*)(void *out, const void *const *in, int lim);
+
+/// Reads the lim elements of a linear buffer starting at idx
+using LoadLinearFn = void (*)(void *out, const Leaf &leaf, dim_t idx,
+                              int lim);
+
+/// Reads the lim elements of a buffer starting at the coordinates
+/// (x, y, z, w)
+using LoadFn = void (*)(void *out, const Leaf &leaf, int x, int y, int z,
+                        int w, int lim);
+
+/// Evaluates all the outputs of a tree compiled into a native kernel. Kernels
+/// of linear trees compute the elements [begin, end) of the outputs and the
+/// others compute the rows [begin, end) along the first dimension.
+using NativeFn = void (*)(const Leaf *leaves, void *const *outputs,
+                          const dim_t *dims, const dim_t *strides,
+                          dim_t begin, dim_t end);
+
+/// Converts lim values of the compute type of an output to its type and
+/// writes them to the elements of out starting at offset
+using StoreFn = void (*)(void *out, dim_t offset, const void *values, int lim);
+
+/// An array written by the evaluation of a tree
+struct Output {
+    void *ptr;
+    af::dtype type;
+    StoreFn store;
+};
+
+template<typename T>
+void store(void *out, dim_t offset, const void *values, int lim) {
+    const auto *in = static_cast<const compute_t<T> *>(values);
+    std::copy(in, in + lim, static_cast<T *>(out) + offset);
+}
+
+/// Returns the output writing the elements pointed to by \p ptr
+template<typename T>
+Output makeOutput(T *ptr) {
+    return {ptr, static_cast<af::dtype>(af::dtype_traits<T>::af_type),
+            store<T>};
+}
+
+enum class InstructionKind {
+    Op,       ///< Calls op on the values of the children
+    Load,     ///< Reads a buffer using load or load_linear
+    Constant  ///< Reads the VECTOR_LENGTH values the leaf points to
+};
+
+/// A single step of a Tape. Each value of the tape holds a chunk of elements
+/// of the compute type of the node that produced it.
+struct Instruction {
+    InstructionKind kind;
+    OpFn op;
+    LoadFn load;
+    LoadLinearFn load_linear;
+    int out;
+    std::array<int, common::Node::kMaxChildren> in;
+    int leaf;
+};
+
 }  // namespace jit
 
 template<typename T>
 class TNode : public common::Node {
    public:
-    alignas(16) jit::array<compute_t<T>> m_val;
     using arrayfire::common::Node::m_children;
 
    public:
-    TNode(T val, const int height,
+    TNode(const int height,
           const std::array<common::Node_ptr, kMaxChildren> &&children,
           common::kNodeType node_type)
         : Node(static_cast<af::dtype>(af::dtype_traits<T>::af_type), height,
-               move(children), node_type) {
-        using namespace common;
-        m_val.fill(static_cast<compute_t<T>>(val));
-    }
+               move(children), node_type) {}
 
     virtual ~TNode() = default;
 };
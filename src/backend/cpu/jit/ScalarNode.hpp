@@ -9,6 +9,9 @@
 
 #pragma once
 #include <optypes.hpp>
+#include <algorithm>
+#include <cstring>
+#include <string>
 #include <vector>
 #include "Node.hpp"
 
@@ -19,24 +22,57 @@ namespace jit {
 
 template<typename T>
 class ScalarNode : public TNode<T> {
+    /// The value repeated so the node can be read like any other register
+    alignas(16) jit::array<compute_t<T>> m_val;
+
    public:
-    ScalarNode(T val) : TNode<T>(val, 0, {}, common::kNodeType::Scalar) {}
+    ScalarNode(T val) : TNode<T>(0, {}, common::kNodeType::Scalar) {
+        m_val.fill(static_cast<compute_t<T>>(val));
+    }
 
     std::unique_ptr<common::Node> clone() final {
         return std::make_unique<ScalarNode>(*this);
     }
 
+    bool getInstruction(Instruction &inst) const final {
+        inst.kind = InstructionKind::Constant;
+        return true;
+    }
+
+    void bind(Leaf &leaf) const final { leaf.ptr = m_val.data(); }
+
+    size_t getHash() const noexcept final {
+        size_t out = 0;
+        std::memcpy(&out, m_val.data(),
+                    std::min(sizeof(compute_t<T>), sizeof(size_t)));
+        return out ^ (std::hash<af::dtype>()(this->getType()) << 1);
+    }
+
+    /// Scalars are equivalent if they have the same type and the same bits
+    bool isEquivalent(const common::Node &other) const noexcept final {
+        if (!other.isScalar() || other.getType() != this->getType()) {
+            return false;
+        }
+        const auto &node = static_cast<const ScalarNode<T> &>(other);
+        return std::memcmp(m_val.data(), node.m_val.data(),
+                           sizeof(compute_t<T>)) == 0;
+    }
+
     void genKerName(std::string &kerString,
                     const common::Node_ids &ids) const final {
-        UNUSED(kerString);
-        UNUSED(ids);
+        kerString += '_';
+        kerString += this->getTypeStr();
+        kerString += ',';
+        kerString += std::to_string(ids.id);
     }
 
     void genParams(std::stringstream &kerStream, int id,
                    bool is_linear) const final {
-        UNUSED(kerStream);
-        UNUSED(id);
         UNUSED(is_linear);
+        const std::string type_str = this->getTypeStr();
+        kerStream << "const " << type_str << " scalar" << id
+                  << " = *static_cast<const " << type_str << " *>(iInfo" << id
+                  << ".ptr);\n";
     }
 
     int setArgs(int start_id, bool is_linear,
@@ -57,8 +93,8 @@ class ScalarNode : public TNode<T> {
 
     void genFuncs(std::stringstream &kerStream,
                   const common::Node_ids &ids) const final {
-        UNUSED(kerStream);
-        UNUSED(ids);
+        kerStream << this->getTypeStr() << " val" << ids.id << " = scalar"
+                  << ids.id << ";\n";
     }
 };
 }  // namespace jit
@@ -0,0 +1,94 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/jit/Node.hpp>
+#include <jit/kernel_generators.hpp>
+#include <optypes.hpp>
+#include "Node.hpp"
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+namespace arrayfire {
+namespace cpu {
+
+namespace jit {
+
+/// Picks the values of its second or third child depending on the value of
+/// its first child. af_select_t picks the second child where the condition is
+/// true and af_not_select_t picks the third one.
+template<typename T, af_op_t op>
+class SelectNode : public TNode<compute_t<T>> {
+    static_assert(op == af_select_t || op == af_not_select_t,
+                  "SelectNode only supports af_select_t and af_not_select_t");
+
+   public:
+    SelectNode(common::Node_ptr cond, common::Node_ptr a, common::Node_ptr b)
+        : TNode<compute_t<T>>(std::max({cond->getHeight(), a->getHeight(),
+                                        b->getHeight()}) +
+                                  1,
+                              {{cond, a, b}}, common::kNodeType::Nary) {
+        this->mixHash(static_cast<size_t>(op));
+    }
+
+    std::unique_ptr<common::Node> clone() final {
+        return std::make_unique<SelectNode>(*this);
+    }
+
+    af_op_t getOp() const noexcept final { return op; }
+
+    bool isEquivalent(const common::Node &other) const noexcept final {
+        return other.getNodeType() == common::kNodeType::Nary &&
+               other.getOp() == op && other.getType() == this->getType();
+    }
+
+    static void eval(void *out, const void *const *in, int lim) {
+        using Tc         = compute_t<T>;
+        constexpr bool t = op == af_select_t;
+        auto &o          = *static_cast<array<Tc> *>(out);
+        const auto &c    = *static_cast<const array<char> *>(in[0]);
+        const auto &a    = *static_cast<const array<Tc> *>(in[1]);
+        const auto &b    = *static_cast<const array<Tc> *>(in[2]);
+        for (int i = 0; i < lim; i++) { o[i] = (c[i] != 0) == t ? a[i] : b[i]; }
+    }
+
+    bool getInstruction(Instruction &inst) const final {
+        inst.kind = InstructionKind::Op;
+        inst.op   = eval;
+        return true;
+    }
+
+    void genKerName(std::string &kerString,
+                    const common::Node_ids &ids) const final {
+        kerString += '_';
+        kerString += this->getNameStr();
+        kerString += std::to_string(op);
+        for (int i = 0; i < 3; i++) {
+            kerString += ',';
+            kerString += std::to_string(ids.child_ids[i]);
+        }
+        kerString += ',';
+        kerString += std::to_string(ids.id);
+    }
+
+    void genFuncs(std::stringstream &kerStream,
+                  const common::Node_ids &ids) const final {
+        kerStream << this->getTypeStr() << " val" << ids.id << " = "
+                  << getNativeFunctionName(op) << "(val" << ids.child_ids[0]
+                  << ", val" << ids.child_ids[1] << ", val"
+                  << ids.child_ids[2] << ");\n";
+    }
+};
+
+}  // namespace jit
+}  // namespace cpu
+}  // namespace arrayfire
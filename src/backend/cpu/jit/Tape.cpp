@@ -0,0 +1,401 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <jit/Tape.hpp>
+
+#include <common/ArrayInfo.hpp>
+#include <common/deterministicHash.hpp>
+#include <common/dispatch.hpp>
+#include <common/err_common.hpp>
+#include <common/jit/ModdimNode.hpp>
+#include <common/traits.hpp>
+#include <platform.hpp>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+using arrayfire::common::ModdimNode;
+using arrayfire::common::Node;
+using arrayfire::common::Node_ptr;
+using std::make_shared;
+using std::pair;
+using std::shared_ptr;
+using std::uintptr_t;
+using std::unordered_map;
+using std::vector;
+
+namespace arrayfire {
+namespace cpu {
+namespace jit {
+
+namespace {
+
+/// The maximum number of tapes kept by the cache of each thread
+constexpr size_t kMaxCachedTapes = 1024;
+
+/// Marks the moddims nodes in the signature of a tree
+constexpr uintptr_t kModdimsSignature = std::numeric_limits<uintptr_t>::max();
+
+/// The nodes of the trees in post order, each node appearing once
+struct Traversal {
+    vector<Node *> nodes;
+    vector<Instruction> insts;
+    vector<bool> is_moddims;
+    vector<uintptr_t> signature;
+
+    /// Maps the visited nodes to their position. Small trees are searched
+    /// linearly which is cheaper than hashing the nodes.
+    vector<pair<const Node *, int>> small_index;
+    unordered_map<const Node *, int> large_index;
+
+    /// The ids of the visited nodes by hash. Small trees are searched
+    /// linearly for equivalent nodes so this is only filled for large trees.
+    std::unordered_multimap<size_t, int> hashes;
+
+    static constexpr size_t kMaxLinearSearch = 32;
+
+    int find(const Node *node) const {
+        if (small_index.size() < kMaxLinearSearch) {
+            for (const auto &entry : small_index) {
+                if (entry.first == node) { return entry.second; }
+            }
+            return -1;
+        }
+        auto it = large_index.find(node);
+        return it == large_index.end() ? -1 : it->second;
+    }
+
+    /// Returns the id of a visited node equivalent to \p node, whose children
+    /// have the ids \p in, or -1 if there is none
+    int findEquivalent(const Node *node,
+                       const std::array<int, Node::kMaxChildren> &in) const {
+        auto isEquivalent = [&](int id) {
+            return insts[id].in == in && node->isEquivalent(*nodes[id]);
+        };
+        if (nodes.size() < kMaxLinearSearch) {
+            for (int id = 0; id < static_cast<int>(nodes.size()); id++) {
+                if (isEquivalent(id)) { return id; }
+            }
+            return -1;
+        }
+        auto range = hashes.equal_range(node->getHash());
+        for (auto it = range.first; it != range.second; ++it) {
+            if (isEquivalent(it->second)) { return it->second; }
+        }
+        return -1;
+    }
+
+    void insert(const Node *node, int id) {
+        if (small_index.size() < kMaxLinearSearch) {
+            small_index.emplace_back(node, id);
+            if (small_index.size() == kMaxLinearSearch) {
+                large_index.insert(begin(small_index), end(small_index));
+            }
+        } else {
+            large_index.emplace(node, id);
+        }
+    }
+
+    int visit(Node *node) {
+        int id = find(node);
+        if (id >= 0) { return id; }
+
+        Instruction inst{};
+        inst.in.fill(-1);
+        for (int i = 0; i < Node::kMaxChildren && node->m_children[i]; i++) {
+            inst.in[i] = visit(node->m_children[i].get());
+        }
+
+        // Equivalent nodes are evaluated once
+        id = findEquivalent(node, inst.in);
+        if (id >= 0) {
+            insert(node, id);
+            return id;
+        }
+
+        const bool moddims = node->getOp() == af_moddims_t;
+        if (moddims) {
+            signature.push_back(kModdimsSignature);
+        } else {
+            if (!node->getInstruction(inst)) {
+                AF_ERROR("Node can not be evaluated by the CPU JIT",
+                         AF_ERR_INTERNAL);
+            }
+            signature.push_back(static_cast<uintptr_t>(inst.kind));
+            signature.push_back(reinterpret_cast<uintptr_t>(inst.op));
+            signature.push_back(reinterpret_cast<uintptr_t>(inst.load));
+        }
+        for (int child : inst.in) {
+            signature.push_back(static_cast<uintptr_t>(child));
+        }
+
+        id = static_cast<int>(nodes.size());
+        nodes.push_back(node);
+        if (nodes.size() == kMaxLinearSearch) {
+            for (int i = 0; i <= id; i++) {
+                hashes.emplace(nodes[i]->getHash(), i);
+            }
+        } else if (nodes.size() > kMaxLinearSearch) {
+            hashes.emplace(node->getHash(), id);
+        }
+        insts.push_back(inst);
+        is_moddims.push_back(moddims);
+        insert(node, id);
+        return id;
+    }
+};
+
+/// The size of the elements of the values of the nodes of type \p type
+size_t computeSize(af::dtype type) {
+    // Half precision values are computed in single precision
+    return type == f16 ? sizeof(float) : common::dtypeSize(type);
+}
+
+/// Returns the number of elements of the chunks of a tape whose registers
+/// use \p bytes_per_element bytes for each element. The registers of a chunk
+/// use at most half of the L1 cache so that the buffers read and written
+/// by the chunk stay in the cache as well.
+int getChunkLength(size_t bytes_per_element) {
+    const size_t budget = getL1CacheSize() / 2;
+    int length          = VECTOR_LENGTH;
+    while (length > kMinVectorLength && length * bytes_per_element > budget) {
+        length /= 2;
+    }
+    return length;
+}
+
+/// Sets the shape of the leaves under the moddims node \p moddims
+void setLeafShapes(const Traversal &t, const int moddims, const int id,
+                   vector<int> &shapes, vector<bool> &visited) {
+    if (visited[id]) { return; }
+    visited[id] = true;
+    if (t.insts[id].kind == InstructionKind::Load) { shapes[id] = moddims; }
+    for (int child : t.insts[id].in) {
+        if (child >= 0) { setLeafShapes(t, moddims, child, shapes, visited); }
+    }
+}
+
+shared_ptr<const Tape> buildTape(const Traversal &t,
+                                 const vector<int> &output_ids) {
+    auto tape       = make_shared<Tape>();
+    tape->signature = t.signature;
+
+    const int num_nodes = static_cast<int>(t.nodes.size());
+
+    // The moddims nodes only change the shape of the buffers under them. The
+    // outermost moddims node appears last so its shape takes precedence.
+    vector<int> shapes(num_nodes, -1);
+    for (int id = 0; id < num_nodes; id++) {
+        if (!t.is_moddims[id]) { continue; }
+        vector<bool> visited(num_nodes, false);
+        setLeafShapes(t, id, id, shapes, visited);
+    }
+
+    // The node whose value is used in place of each node
+    vector<int> source(num_nodes);
+    for (int id = 0; id < num_nodes; id++) {
+        source[id] = t.is_moddims[id] ? source[t.insts[id].in[0]] : id;
+    }
+
+    // The position of the last instruction reading the value of each node
+    constexpr int kNeverFreed = std::numeric_limits<int>::max();
+    vector<int> last_use(num_nodes, -1);
+    for (int id = 0; id < num_nodes; id++) {
+        for (int child : t.insts[id].in) {
+            if (child >= 0) { last_use[source[child]] = id; }
+        }
+    }
+    for (int id : output_ids) { last_use[source[id]] = kNeverFreed; }
+
+    // Registers are numbered from 0. Constants are numbered from
+    // kConstantBase until the number of registers is known.
+    constexpr int kConstantBase = std::numeric_limits<int>::max() / 2;
+    vector<int> value(num_nodes, 0);
+    vector<int> free_registers;
+    vector<size_t> register_sizes;
+    int num_registers = 0;
+    for (int id = 0; id < num_nodes; id++) {
+        if (t.is_moddims[id]) { continue; }
+        Instruction inst = t.insts[id];
+        for (int &child : inst.in) {
+            if (child >= 0) { child = value[source[child]]; }
+        }
+
+        if (inst.kind == InstructionKind::Constant) {
+            inst.leaf = static_cast<int>(tape->leaf_nodes.size());
+            tape->leaf_nodes.push_back(id);
+            tape->leaf_shapes.push_back(-1);
+            const int k = static_cast<int>(tape->constants.size());
+            inst.out    = kConstantBase + k;
+            value[id]   = inst.out;
+            tape->constants.push_back(inst);
+            continue;
+        }
+
+        if (inst.kind == InstructionKind::Load) {
+            inst.leaf = static_cast<int>(tape->leaf_nodes.size());
+            tape->leaf_nodes.push_back(id);
+            tape->leaf_shapes.push_back(shapes[id]);
+        }
+
+        // The inputs are released after the output is allocated because the
+        // output of a cast can be larger than its input
+        if (free_registers.empty()) {
+            inst.out = num_registers++;
+            register_sizes.push_back(0);
+        } else {
+            inst.out = free_registers.back();
+            free_registers.pop_back();
+        }
+        value[id] = inst.out;
+        register_sizes[inst.out] = std::max(
+            register_sizes[inst.out], computeSize(t.nodes[id]->getType()));
+        for (int child : t.insts[id].in) {
+            if (child < 0) { continue; }
+            int src = source[child];
+            if (last_use[src] == id && value[src] < kConstantBase &&
+                std::find(begin(free_registers), end(free_registers),
+                          value[src]) == end(free_registers)) {
+                free_registers.push_back(value[src]);
+            }
+        }
+        // Values which are never read are released immediately
+        if (last_use[id] < 0) { free_registers.push_back(inst.out); }
+
+        tape->code.push_back(inst);
+    }
+
+    auto toSlot = [num_registers](int v) {
+        return v < kConstantBase ? v : num_registers + (v - kConstantBase);
+    };
+    for (Instruction &inst : tape->code) {
+        for (int &child : inst.in) {
+            if (child >= 0) { child = toSlot(child); }
+        }
+    }
+    for (Instruction &inst : tape->constants) { inst.out = toSlot(inst.out); }
+    for (int id : output_ids) {
+        tape->outputs.push_back(toSlot(value[source[id]]));
+    }
+    for (const Instruction &inst : t.insts) {
+        tape->node_children.push_back(inst.in);
+    }
+    tape->output_nodes  = output_ids;
+    tape->num_registers = num_registers;
+
+    // The registers are packed using the size of the largest value they hold
+    size_t bytes_per_element = 0;
+    for (size_t size : register_sizes) { bytes_per_element += size; }
+    tape->chunk_length = getChunkLength(bytes_per_element);
+    tape->frame_bytes  = 0;
+    for (size_t size : register_sizes) {
+        tape->register_offsets.push_back(tape->frame_bytes);
+        tape->frame_bytes += divup(size * tape->chunk_length, size_t(64)) * 64;
+    }
+    return tape;
+}
+
+}  // namespace
+
+TapeBinding compileTape(const vector<Node_ptr> &outputs) {
+    Traversal t;
+    vector<int> output_ids;
+    output_ids.reserve(outputs.size());
+    for (const Node_ptr &node : outputs) {
+        output_ids.push_back(t.visit(node.get()));
+    }
+    for (int id : output_ids) {
+        t.signature.push_back(static_cast<uintptr_t>(id));
+    }
+
+    thread_local unordered_map<size_t, vector<shared_ptr<const Tape>>> cache;
+    const size_t hash = deterministicHash(
+        t.signature.data(), t.signature.size() * sizeof(uintptr_t));
+
+    TapeBinding binding;
+    auto &bucket = cache[hash];
+    for (const auto &tape : bucket) {
+        if (tape->signature == t.signature) {
+            binding.tape = tape;
+            break;
+        }
+    }
+    if (!binding.tape) {
+        if (cache.size() > kMaxCachedTapes) {
+            cache.clear();
+            binding.tape = buildTape(t, output_ids);
+            cache[hash].push_back(binding.tape);
+        } else {
+            binding.tape = buildTape(t, output_ids);
+            bucket.push_back(binding.tape);
+        }
+    }
+
+    const Tape &tape = *binding.tape;
+    binding.leaves.resize(tape.leaf_nodes.size());
+    for (size_t i = 0; i < tape.leaf_nodes.size(); i++) {
+        Leaf &leaf = binding.leaves[i];
+        t.nodes[tape.leaf_nodes[i]]->bind(leaf);
+        if (tape.leaf_shapes[i] >= 0) {
+            const auto *moddims =
+                static_cast<const ModdimNode *>(t.nodes[tape.leaf_shapes[i]]);
+            const af::dim4 strides = calcStrides(moddims->m_new_shape);
+            for (int d = 0; d < 4; d++) {
+                leaf.dims[d]    = moddims->m_new_shape[d];
+                leaf.strides[d] = strides[d];
+            }
+        }
+    }
+    binding.nodes = std::move(t.nodes);
+    return binding;
+}
+
+bool isLinear(const TapeBinding &binding, const af::dim4 &dims) {
+    const Tape &tape = *binding.tape;
+    for (const Instruction &inst : tape.code) {
+        if (inst.kind != InstructionKind::Load) { continue; }
+        const Leaf &leaf = binding.leaves[inst.leaf];
+        if (!leaf.linear) { return false; }
+        for (int d = 0; d < 4; d++) {
+            if (leaf.dims[d] != dims[d]) { return false; }
+        }
+    }
+    return true;
+}
+
+Frame::Frame(const TapeBinding &binding)
+    : m_binding(binding)
+    , m_memory(binding.tape->frame_bytes / sizeof(Line))
+    , m_values(binding.tape->num_registers + binding.tape->constants.size()) {
+    const Tape &tape = *binding.tape;
+    auto *memory     = reinterpret_cast<unsigned char *>(m_memory.data());
+    for (int r = 0; r < tape.num_registers; r++) {
+        m_values[r] = memory + tape.register_offsets[r];
+    }
+    for (const Instruction &inst : tape.constants) {
+        m_values[inst.out] = binding.leaves[inst.leaf].ptr;
+    }
+
+    m_args.resize(tape.code.size());
+    m_out.resize(tape.code.size());
+    for (size_t i = 0; i < tape.code.size(); i++) {
+        const Instruction &inst = tape.code[i];
+        m_out[i]                = memory + tape.register_offsets[inst.out];
+        for (int c = 0; c < Node::kMaxChildren; c++) {
+            m_args[i][c] = inst.in[c] >= 0 ? m_values[inst.in[c]] : nullptr;
+        }
+    }
+}
+
+}  // namespace jit
+}  // namespace cpu
+}  // namespace arrayfire
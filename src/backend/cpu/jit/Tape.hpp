@@ -0,0 +1,169 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <common/jit/Node.hpp>
+#include <jit/Node.hpp>
+#include <types.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace arrayfire {
+namespace cpu {
+namespace jit {
+
+/// A JIT tree compiled into a list of instructions
+///
+/// Every node of the tree produces a value of chunk_length elements. The
+/// values of the buffers and the operations are stored in registers which are
+/// reused once all the instructions reading them have been executed. The
+/// values of the constants are read directly from their nodes. A tape only
+/// depends on the structure of the tree so it is shared by all the trees which
+/// only differ by the data of their leaves.
+struct Tape {
+    /// The instructions executed for each chunk of the output
+    std::vector<Instruction> code;
+
+    /// The constants of the tree. Their values are the ones following the
+    /// registers.
+    std::vector<Instruction> constants;
+
+    /// The values holding the outputs of the tree
+    std::vector<int> outputs;
+
+    /// The number of registers written by code
+    int num_registers;
+
+    /// The position in bytes of each register in the memory of a Frame
+    std::vector<size_t> register_offsets;
+
+    /// The bytes used by the registers of a Frame
+    size_t frame_bytes;
+
+    /// The number of elements evaluated by each chunk. Trees with many live
+    /// values use shorter chunks so that their registers stay in the L1
+    /// cache.
+    int chunk_length;
+
+    /// The position of the node of each leaf in the traversal of the tree
+    std::vector<int> leaf_nodes;
+
+    /// The position of the moddims node whose shape is used by each leaf or
+    /// -1 if the leaf keeps its own shape
+    std::vector<int> leaf_shapes;
+
+    /// The position of the output nodes in the traversal of the tree
+    std::vector<int> output_nodes;
+
+    /// The position of the children of each node in the traversal of the
+    /// tree. Equivalent nodes appear once in the traversal so a child can be
+    /// a different node than the child of the Node object.
+    std::vector<std::array<int, common::Node::kMaxChildren>> node_children;
+
+    /// Describes the structure of the tree. Two trees with the same signature
+    /// can be evaluated by the same tape.
+    std::vector<std::uintptr_t> signature;
+
+    /// The native kernel last used to evaluate the tape for linear and
+    /// strided buffers. Tapes are only shared by the evaluations of a single
+    /// thread so these can be updated without synchronization.
+    struct NativeKernel {
+        af::dtype type;
+        NativeFn fn   = nullptr;
+        bool searched = false;
+    };
+    mutable std::array<NativeKernel, 2> native;
+};
+
+/// A tape and the data of the leaves of the tree it was created for
+struct TapeBinding {
+    std::shared_ptr<const Tape> tape;
+    std::vector<Leaf> leaves;
+
+    /// The nodes of the tree in the order of the traversal. They are only
+    /// valid while the tree is alive.
+    std::vector<common::Node *> nodes;
+};
+
+/// Returns the tape evaluating the trees rooted at \p outputs bound to the
+/// data of their leaves. The tapes are cached so the trees are only compiled
+/// the first time their structure is seen.
+TapeBinding compileTape(const std::vector<common::Node_ptr> &outputs);
+
+/// Returns true if every buffer of \p binding can be read linearly when the
+/// tape is evaluated with the shape \p dims
+bool isLinear(const TapeBinding &binding, const af::dim4 &dims);
+
+/// The registers used by a single thread to evaluate a TapeBinding
+class Frame {
+    /// The registers are aligned to cache lines
+    struct alignas(64) Line {
+        unsigned char data[64];
+    };
+
+    const TapeBinding &m_binding;
+    std::vector<Line> m_memory;
+    std::vector<const void *> m_values;
+    std::vector<std::array<const void *, common::Node::kMaxChildren>> m_args;
+    std::vector<void *> m_out;
+
+   public:
+    explicit Frame(const TapeBinding &binding);
+
+    Frame(const Frame &)            = delete;
+    Frame &operator=(const Frame &) = delete;
+
+    /// Evaluates the elements [idx, idx + lim) of a tree whose buffers are
+    /// all linear
+    void eval(dim_t idx, int lim) {
+        const std::vector<Instruction> &code = m_binding.tape->code;
+        const Leaf *leaves                   = m_binding.leaves.data();
+        for (size_t i = 0; i < code.size(); i++) {
+            const Instruction &inst = code[i];
+            if (inst.kind == InstructionKind::Op) {
+                inst.op(m_out[i], m_args[i].data(), lim);
+            } else {
+                inst.load_linear(m_out[i], leaves[inst.leaf], idx, lim);
+            }
+        }
+    }
+
+    /// Evaluates lim elements of a tree starting at the coordinates
+    /// (x, y, z, w)
+    void eval(int x, int y, int z, int w, int lim) {
+        const std::vector<Instruction> &code = m_binding.tape->code;
+        const Leaf *leaves                   = m_binding.leaves.data();
+        for (size_t i = 0; i < code.size(); i++) {
+            const Instruction &inst = code[i];
+            if (inst.kind == InstructionKind::Op) {
+                inst.op(m_out[i], m_args[i].data(), lim);
+            } else {
+                inst.load(m_out[i], leaves[inst.leaf], x, y, z, w, lim);
+            }
+        }
+    }
+
+    /// Returns the values of the output \p i computed by the last call to
+    /// eval
+    const void *output(int i) const {
+        return m_values[m_binding.tape->outputs[i]];
+    }
+
+    template<typename T>
+    const compute_t<T> *output(int i) const {
+        return static_cast<const compute_t<T> *>(output(i));
+    }
+};
+
+}  // namespace jit
+}  // namespace cpu
+}  // namespace arrayfire
@@ -14,6 +14,10 @@
 #include "Node.hpp"
 
 #include <jit/BufferNode.hpp>
+#include <jit/kernel_generators.hpp>
+
+#include <string>
+#include <type_traits>
 #include <vector>
 
 namespace arrayfire {
@@ -30,12 +34,13 @@ template<typename To, typename Ti, af_op_t op>
 class UnaryNode : public TNode<To> {
    protected:
     using arrayfire::common::Node::m_children;
-    UnOp<To, Ti, op> m_op;
 
    public:
     UnaryNode(common::Node_ptr child)
-        : TNode<To>(To(0), child->getHeight() + 1, {{child}},
-                    common::kNodeType::Nary) {}
+        : TNode<To>(child->getHeight() + 1, {{child}},
+                    common::kNodeType::Nary) {
+        this->mixHash(static_cast<size_t>(op));
+    }
 
     std::unique_ptr<common::Node> clone() final {
         return std::make_unique<UnaryNode>(*this);
@@ -43,31 +48,43 @@ class UnaryNode : public TNode<To> {
 
     af_op_t getOp() const noexcept final { return op; }
 
-    void calc(int x, int y, int z, int w, int lim) final {
-        UNUSED(x);
-        UNUSED(y);
-        UNUSED(z);
-        UNUSED(w);
-        auto child = static_cast<TNode<Ti> *>(m_children[0].get());
-        m_op.eval(TNode<To>::m_val, child->m_val, lim);
+    /// The children of equivalent nodes are equivalent so they have the same
+    /// types as the children of this node
+    bool isEquivalent(const common::Node &other) const noexcept final {
+        return other.getNodeType() == common::kNodeType::Nary &&
+               other.getOp() == op && other.getType() == this->getType();
+    }
+
+    static void eval(void *out, const void *const *in, int lim) {
+        UnOp<To, Ti, op> unop;
+        unop.eval(*static_cast<array<compute_t<To>> *>(out),
+                  *static_cast<const array<compute_t<Ti>> *>(in[0]), lim);
     }
 
-    void calc(int idx, int lim) final {
-        UNUSED(idx);
-        auto child = static_cast<TNode<Ti> *>(m_children[0].get());
-        m_op.eval(TNode<To>::m_val, child->m_val, lim);
+    bool getInstruction(Instruction &inst) const final {
+        inst.kind = InstructionKind::Op;
+        inst.op   = eval;
+        return true;
     }
 
     void genKerName(std::string &kerString,
                     const common::Node_ids &ids) const final {
-        UNUSED(kerString);
-        UNUSED(ids);
+        kerString += '_';
+        kerString += this->getNameStr();
+        kerString += std::to_string(op);
+        kerString += ',';
+        kerString += std::to_string(ids.child_ids[0]);
+        kerString += ',';
+        kerString += std::to_string(ids.id);
     }
 
     void genFuncs(std::stringstream &kerStream,
                   const common::Node_ids &ids) const final {
-        UNUSED(kerStream);
-        UNUSED(ids);
+        // Casts to b8 test the value instead of truncating it
+        const bool to_b8 = op == af_cast_t && std::is_same<To, char>::value;
+        kerStream << this->getTypeStr() << " val" << ids.id << " = "
+                  << (to_b8 ? "__tob8" : getNativeFunctionName(op)) << "(val"
+                  << ids.child_ids[0] << ");\n";
     }
 };
 
@@ -0,0 +1,133 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <af/defines.h>
+
+#include <sstream>
+#include <string>
+
+namespace arrayfire {
+namespace cpu {
+namespace jit {
+
+namespace {
+
+/// Creates the pointer to the data of a buffer read by a native kernel. The
+/// leaf of the buffer is declared as iInfo<id> by the kernel.
+inline void generateParamDeclaration(std::stringstream& kerStream, int id,
+                                     const std::string& type_str) {
+    kerStream << "const " << type_str << " *in" << id << " = static_cast<const "
+              << type_str << " *>(iInfo" << id << ".ptr);\n";
+}
+
+/// Generates the code to calculate the offsets for a buffer. Dimensions of
+/// size one are broadcast like in BufferNode::load.
+inline void generateBufferOffsets(std::stringstream& kerStream, int id,
+                                  bool is_linear) {
+    const std::string idx_str  = std::string("idx") + std::to_string(id);
+    const std::string info_str = std::string("iInfo") + std::to_string(id);
+
+    if (is_linear) {
+        kerStream << "const dim_t " << idx_str << " = idx;\n";
+    } else {
+        kerStream << "const dim_t " << idx_str << " = id0*(id0<" << info_str
+                  << ".dims[0])*" << info_str << ".strides[0] + id1*(id1<"
+                  << info_str << ".dims[1])*" << info_str
+                  << ".strides[1] + id2*(id2<" << info_str << ".dims[2])*"
+                  << info_str << ".strides[2] + id3*(id3<" << info_str
+                  << ".dims[3])*" << info_str << ".strides[3];\n";
+    }
+}
+
+/// Generates the code to read a buffer and store it in a local variable
+inline void generateBufferRead(std::stringstream& kerStream, int id,
+                               const std::string& type_str) {
+    kerStream << type_str << " val" << id << " = in" << id << "[idx" << id
+              << "];\n";
+}
+
+/// Returns the function of the native kernels implementing \p op or nullptr
+/// if the operation can only be evaluated by the interpreter
+inline const char* getNativeFunctionName(af_op_t op) {
+    switch (op) {
+#define NATIVE_FN(OP) \
+    case af_##OP##_t: return "__" #OP;
+        NATIVE_FN(add)
+        NATIVE_FN(sub)
+        NATIVE_FN(mul)
+        NATIVE_FN(div)
+        NATIVE_FN(eq)
+        NATIVE_FN(neq)
+        NATIVE_FN(lt)
+        NATIVE_FN(gt)
+        NATIVE_FN(le)
+        NATIVE_FN(ge)
+        NATIVE_FN(and)
+        NATIVE_FN(or)
+        NATIVE_FN(bitand)
+        NATIVE_FN(bitor)
+        NATIVE_FN(bitxor)
+        NATIVE_FN(bitshiftl)
+        NATIVE_FN(bitshiftr)
+        NATIVE_FN(bitnot)
+        NATIVE_FN(min)
+        NATIVE_FN(max)
+        NATIVE_FN(mod)
+        NATIVE_FN(rem)
+        NATIVE_FN(atan2)
+        NATIVE_FN(hypot)
+        NATIVE_FN(sin)
+        NATIVE_FN(cos)
+        NATIVE_FN(tan)
+        NATIVE_FN(asin)
+        NATIVE_FN(acos)
+        NATIVE_FN(atan)
+        NATIVE_FN(sinh)
+        NATIVE_FN(cosh)
+        NATIVE_FN(tanh)
+        NATIVE_FN(asinh)
+        NATIVE_FN(acosh)
+        NATIVE_FN(atanh)
+        NATIVE_FN(round)
+        NATIVE_FN(trunc)
+        NATIVE_FN(floor)
+        NATIVE_FN(ceil)
+        NATIVE_FN(signbit)
+        NATIVE_FN(exp)
+        NATIVE_FN(expm1)
+        NATIVE_FN(sigmoid)
+        NATIVE_FN(erf)
+        NATIVE_FN(erfc)
+        NATIVE_FN(log)
+        NATIVE_FN(log10)
+        NATIVE_FN(log1p)
+        NATIVE_FN(log2)
+        NATIVE_FN(sqrt)
+        NATIVE_FN(rsqrt)
+        NATIVE_FN(cbrt)
+        NATIVE_FN(tgamma)
+        NATIVE_FN(lgamma)
+        NATIVE_FN(isinf)
+        NATIVE_FN(isnan)
+        NATIVE_FN(iszero)
+        NATIVE_FN(noop)
+        NATIVE_FN(select)
+        NATIVE_FN(not_select)
+#undef NATIVE_FN
+        case af_cast_t: return "__noop";
+        case af_moddims_t: return "__noop";
+        default: return nullptr;
+    }
+}
+
+}  // namespace
+}  // namespace jit
+}  // namespace cpu
+}  // namespace arrayfire
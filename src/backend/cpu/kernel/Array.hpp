@@ -9,199 +9,209 @@
 
 #pragma once
 #include <Param.hpp>
-#include <common/jit/ModdimNode.hpp>
+#include <common/dispatch.hpp>
+#include <common/jit/JitStats.hpp>
 #include <common/jit/Node.hpp>
-#include <common/jit/NodeIterator.hpp>
-#include <jit/BufferNode.hpp>
+#include <common/traits.hpp>
+#include <jit/Native.hpp>
 #include <jit/Node.hpp>
-#include <jit/UnaryNode.hpp>
+#include <jit/Tape.hpp>
+#include <parallel.hpp>
 #include <platform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
 #include <vector>
 
 namespace arrayfire {
 namespace cpu {
 namespace kernel {
 
-/// Clones node_index_map and update the child pointers
-std::vector<std::shared_ptr<common::Node>> cloneNodes(
-    const std::vector<common::Node *> &node_index_map,
-    const std::vector<common::Node_ids> &ids) {
-    using arrayfire::common::Node;
-    // find all moddims in the tree
-    std::vector<std::shared_ptr<Node>> node_clones;
-    node_clones.reserve(node_index_map.size());
-    transform(begin(node_index_map), end(node_index_map),
-              back_inserter(node_clones), [](Node *n) { return n->clone(); });
-
-    for (common::Node_ids id : ids) {
-        auto &children = node_clones[id.id]->m_children;
-        for (int i = 0; i < Node::kMaxChildren && children[i] != nullptr; i++) {
-            children[i] = node_clones[id.child_ids[i]];
-        }
+/// Evaluates a single chunk of \p lim elements of a tree with the shape
+/// \p dims starting at the coordinates (x, y, z, w). Returns the values of
+/// the first output of the tree.
+template<typename T>
+const compute_t<T> *evalChunk(jit::Frame &frame, const bool is_linear,
+                              const af::dim4 &dims, int x, int y, int z, int w,
+                              int lim) {
+    if (is_linear) {
+        dim_t idx = x + dims[0] * (y + dims[1] * (z + dims[2] * w));
+        frame.eval(idx, lim);
+    } else {
+        frame.eval(x, y, z, w, lim);
     }
-    return node_clones;
+    return frame.output<T>(0);
 }
 
-/// Sets the shape of the buffer node_index_map under the moddims node to the
-/// new shape
-void propagateModdimsShape(
-    std::vector<std::shared_ptr<common::Node>> &node_clones) {
-    using arrayfire::common::NodeIterator;
-    for (auto &node : node_clones) {
-        if (node->getOp() == af_moddims_t) {
-            common::ModdimNode *mn =
-                static_cast<common::ModdimNode *>(node.get());
-
-            NodeIterator<> it(node.get());
-            while (it != NodeIterator<>()) {
-                it = std::find_if(it, NodeIterator<>(), common::isBuffer);
-                if (it == NodeIterator<>()) { break; }
-
-                it->setShape(mn->m_new_shape);
-
-                ++it;
-            }
+/// Evaluates the chunks [begin, end) of a tree whose buffers are all linear.
+/// Chunk i covers the elements [i * length, (i + 1) * length)
+inline void evalLinearChunks(jit::Frame &frame,
+                             const std::vector<jit::Output> &outputs,
+                             const int length, const dim_t num,
+                             const dim_t begin, const dim_t end) {
+    const int num_outputs = static_cast<int>(outputs.size());
+    for (dim_t c = begin; c < end; c++) {
+        dim_t i = c * length;
+        int lim = static_cast<int>(std::min<dim_t>(length, num - i));
+        frame.eval(i, lim);
+        for (int n = 0; n < num_outputs; n++) {
+            outputs[n].store(outputs[n].ptr, i, frame.output(n), lim);
         }
     }
 }
 
-/// Removes node_index_map whos operation matchs a unary operation \p op.
-void removeNodeOfOperation(
-    std::vector<std::shared_ptr<common::Node>> &node_index_map, af_op_t op) {
-    using arrayfire::common::Node;
-
-    for (size_t nid = 0; nid < node_index_map.size(); nid++) {
-        auto &node = node_index_map[nid];
-
-        for (int i = 0;
-             i < Node::kMaxChildren && node->m_children[i] != nullptr; i++) {
-            if (node->m_children[i]->getOp() == op) {
-                // replace moddims
-                auto moddim_node    = node->m_children[i];
-                node->m_children[i] = moddim_node->m_children[0];
-            }
+/// Evaluates the chunks [begin, end) of a tree with strided buffers. Each row
+/// along the first dimension is split into \p row_chunks chunks, so chunk i
+/// covers the elements of row i / row_chunks starting at
+/// (i % row_chunks) * length
+inline void evalStridedChunks(jit::Frame &frame,
+                              const std::vector<jit::Output> &outputs,
+                              const af::dim4 &odims, const af::dim4 &ostrs,
+                              const int length, const dim_t row_chunks,
+                              const dim_t begin, const dim_t end) {
+    const int num_outputs = static_cast<int>(outputs.size());
+    int dim0              = odims[0];
+    for (dim_t c = begin; c < end; c++) {
+        dim_t row = c / row_chunks;
+        int x     = static_cast<int>((c % row_chunks) * length);
+        int y     = static_cast<int>(row % odims[1]);
+        int z     = static_cast<int>((row / odims[1]) % odims[2]);
+        int w     = static_cast<int>(row / (odims[1] * odims[2]));
+
+        int lim  = std::min(length, dim0 - x);
+        dim_t id = x + y * ostrs[1] + z * ostrs[2] + w * ostrs[3];
+
+        frame.eval(x, y, z, w, lim);
+        for (int n = 0; n < num_outputs; n++) {
+            outputs[n].store(outputs[n].ptr, id, frame.output(n), lim);
         }
     }
-
-    node_index_map.erase(remove_if(begin(node_index_map), end(node_index_map),
-                                   [op](std::shared_ptr<Node> &node) {
-                                       return node->getOp() == op;
-                                   }),
-                         end(node_index_map));
 }
 
-/// Returns the cloned output_nodes located in the node_clones array
-///
-/// This function returns the new cloned version of the output_nodes_ from
-/// the node_clones array. If the output node is a moddim node, then it will
-/// set the output node to be its first non-moddim node child
-template<typename T>
-std::vector<TNode<T> *> getClonedOutputNodes(
-    common::Node_map_t &node_index_map,
-    const std::vector<std::shared_ptr<common::Node>> &node_clones,
-    const std::vector<common::Node_ptr> &output_nodes_) {
-    std::vector<TNode<T> *> cloned_output_nodes;
-    cloned_output_nodes.reserve(output_nodes_.size());
-    for (auto &n : output_nodes_) {
-        TNode<T> *ptr;
-        if (n->getOp() == af_moddims_t) {
-            // if the output node is a moddims node, then set the output node
-            // to be the child of the moddims node. This is necessary because
-            // we remove the moddim node_index_map from the tree later
-            int child_index = node_index_map[n->m_children[0].get()];
-            ptr = static_cast<TNode<T> *>(node_clones[child_index].get());
-            while (ptr->getOp() == af_moddims_t) {
-                ptr = static_cast<TNode<T> *>(ptr->m_children[0].get());
-            }
-        } else {
-            int node_index = node_index_map[n.get()];
-            ptr = static_cast<TNode<T> *>(node_clones[node_index].get());
-        }
-        cloned_output_nodes.push_back(ptr);
+/// The minimum number of elements evaluated by each thread. Trees with fewer
+/// than two times this many elements are evaluated serially because the cost
+/// of waking up the pool outweighs the work.
+constexpr dim_t kMinElementsPerThread = 64 * jit::VECTOR_LENGTH;
+
+/// Evaluates a tree with a native kernel. Linear kernels are split by
+/// elements and the others by rows along the first dimension.
+inline void evalNative(jit::NativeFn native, const jit::TapeBinding &binding,
+                       const std::vector<jit::Output> &outputs,
+                       const bool is_linear, const af::dim4 &odims,
+                       const af::dim4 &ostrs) {
+    std::vector<void *> ptrs;
+    ptrs.reserve(outputs.size());
+    for (const jit::Output &output : outputs) { ptrs.push_back(output.ptr); }
+    const dim_t dims[4]    = {odims[0], odims[1], odims[2], odims[3]};
+    const dim_t strides[4] = {ostrs[0], ostrs[1], ostrs[2], ostrs[3]};
+
+    const dim_t num = odims.elements();
+    const dim_t n   = is_linear ? num : num / odims[0];
+    const dim_t grain =
+        is_linear ? kMinElementsPerThread
+                  : std::max<dim_t>(kMinElementsPerThread / odims[0], 1);
+
+    auto evalRange = [&](dim_t begin, dim_t end) {
+        native(binding.leaves.data(), ptrs.data(), dims, strides, begin, end);
+    };
+    if (n < 2 * grain || getNumThreads() == 1) {
+        evalRange(0, n);
+        return;
     }
-    return cloned_output_nodes;
+    parallel_for(0, n, grain, evalRange);
 }
 
-template<typename T>
-void evalMultiple(std::vector<Param<T>> arrays,
-                  std::vector<common::Node_ptr> output_nodes_) {
-    using arrayfire::common::ModdimNode;
-    using arrayfire::common::Node;
-    using arrayfire::common::Node_map_t;
-    using arrayfire::common::NodeIterator;
-
-    af::dim4 odims = arrays[0].dims();
-    af::dim4 ostrs = arrays[0].strides();
-
-    Node_map_t node_index_map;
-    std::vector<T *> ptrs;
-    std::vector<common::Node *> full_nodes;
-    std::vector<common::Node_ids> ids;
-
-    int narrays = static_cast<int>(arrays.size());
-    ptrs.reserve(narrays);
-    for (int i = 0; i < narrays; i++) {
-        ptrs.push_back(arrays[i].get());
-        output_nodes_[i]->getNodesMap(node_index_map, full_nodes, ids);
+/// Evaluates the tree of \p binding into \p outputs
+inline void evalTape(const jit::TapeBinding &binding,
+                     const std::vector<jit::Output> &outputs,
+                     const af::dim4 &odims, const af::dim4 &ostrs) {
+    const bool is_linear = jit::isLinear(binding, odims);
+    const dim_t num      = odims.elements();
+
+    // Native kernels write a single type
+    const bool same_type =
+        std::all_of(begin(outputs), end(outputs),
+                    [&](const jit::Output &output) {
+                        return output.type == outputs[0].type;
+                    });
+    if (same_type) {
+        if (jit::NativeFn native =
+                jit::getNativeKernel(binding, is_linear, outputs[0].type)) {
+            evalNative(native, binding, outputs, is_linear, odims, ostrs);
+            return;
+        }
     }
-    auto node_clones = cloneNodes(full_nodes, ids);
 
-    std::vector<TNode<T> *> cloned_output_nodes =
-        getClonedOutputNodes<T>(node_index_map, node_clones, output_nodes_);
-    propagateModdimsShape(node_clones);
-    removeNodeOfOperation(node_clones, af_moddims_t);
+    // The work is split into chunks of the length chosen for the tape. The
+    // strided path cannot cross rows so each row is split separately.
+    const int length       = binding.tape->chunk_length;
+    const dim_t row_chunks = divup(is_linear ? num : odims[0], dim_t(length));
+    const dim_t num_chunks =
+        is_linear ? row_chunks : row_chunks * (num / odims[0]);
+
+    // Each task evaluates a contiguous range of chunks using its own
+    // registers
+    auto evalChunks = [&](dim_t begin, dim_t end) {
+        jit::Frame frame(binding);
+        if (is_linear) {
+            evalLinearChunks(frame, outputs, length, num, begin, end);
+        } else {
+            evalStridedChunks(frame, outputs, odims, ostrs, length,
+                              row_chunks, begin, end);
+        }
+    };
 
-    bool is_linear = true;
-    for (auto &node : node_clones) { is_linear &= node->isLinear(odims.get()); }
+    const dim_t grain = kMinElementsPerThread / length;
+    if (num_chunks < 2 * grain || getNumThreads() == 1) {
+        evalChunks(0, num_chunks);
+        return;
+    }
+    parallel_for(0, num_chunks, grain, evalChunks);
+}
 
-    int num_nodes        = node_clones.size();
-    int num_output_nodes = cloned_output_nodes.size();
-    if (is_linear) {
-        int num = arrays[0].dims().elements();
-        int cnum =
-            jit::VECTOR_LENGTH * std::ceil(double(num) / jit::VECTOR_LENGTH);
-        for (int i = 0; i < cnum; i += jit::VECTOR_LENGTH) {
-            int lim = std::min(jit::VECTOR_LENGTH, num - i);
-            for (int n = 0; n < num_nodes; n++) {
-                node_clones[n]->calc(i, lim);
-            }
-            for (int n = 0; n < num_output_nodes; n++) {
-                std::copy(cloned_output_nodes[n]->m_val.begin(),
-                          cloned_output_nodes[n]->m_val.begin() + lim,
-                          ptrs[n] + i);
-            }
-        }
-    } else {
-        for (int w = 0; w < (int)odims[3]; w++) {
-            dim_t offw = w * ostrs[3];
-
-            for (int z = 0; z < (int)odims[2]; z++) {
-                dim_t offz = z * ostrs[2] + offw;
-
-                for (int y = 0; y < (int)odims[1]; y++) {
-                    dim_t offy = y * ostrs[1] + offz;
-
-                    int dim0  = odims[0];
-                    int cdim0 = jit::VECTOR_LENGTH *
-                                std::ceil(double(dim0) / jit::VECTOR_LENGTH);
-                    for (int x = 0; x < (int)cdim0; x += jit::VECTOR_LENGTH) {
-                        int lim  = std::min(jit::VECTOR_LENGTH, dim0 - x);
-                        dim_t id = x + offy;
-
-                        for (int n = 0; n < num_nodes; n++) {
-                            node_clones[n]->calc(x, y, z, w, lim);
-                        }
-                        for (int n = 0; n < num_output_nodes; n++) {
-                            std::copy(
-                                cloned_output_nodes[n]->m_val.begin(),
-                                cloned_output_nodes[n]->m_val.begin() + lim,
-                                ptrs[n] + id);
-                        }
-                    }
-                }
-            }
-        }
+/// Returns the description of the evaluation of \p binding into \p outputs
+/// used by the JIT statistics
+inline common::JitEvalInfo getEvalInfo(
+    const jit::TapeBinding &binding, const std::vector<jit::Output> &outputs,
+    const std::vector<common::Node_ptr> &output_nodes, const dim_t num) {
+    common::JitEvalInfo info{};
+    info.nodes           = static_cast<int>(binding.nodes.size());
+    info.buffers_written = static_cast<int>(outputs.size());
+    for (const common::Node_ptr &node : output_nodes) {
+        info.height = std::max(info.height, node->getHeight());
+    }
+    for (const common::Node *node : binding.nodes) {
+        if (node->isBuffer()) { info.buffers_read++; }
+    }
+    for (const jit::Output &output : outputs) {
+        info.bytes_written += num * common::dtypeSize(output.type);
     }
+    return info;
+}
+
+/// Evaluates the trees rooted at \p output_nodes into \p outputs in a single
+/// pass. The outputs can have different types but they must all have the
+/// shape \p odims and the strides \p ostrs. The evaluation is counted in the
+/// statistics of the device and in \p stats if it is not null.
+inline void evalMultiple(std::vector<jit::Output> outputs, af::dim4 odims,
+                         af::dim4 ostrs,
+                         std::vector<common::Node_ptr> output_nodes,
+                         std::shared_ptr<common::JitStats> stats = nullptr) {
+    const dim_t num = odims.elements();
+    if (num == 0) { return; }
+
+    const auto start               = std::chrono::steady_clock::now();
+    const jit::TapeBinding binding = jit::compileTape(output_nodes);
+    evalTape(binding, outputs, odims, ostrs);
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    common::JitEvalInfo info = getEvalInfo(binding, outputs, output_nodes, num);
+    info.time_ns             = static_cast<uint64_t>(elapsed.count());
+    common::recordJitEval(stats.get(), static_cast<int>(getActiveDeviceId()),
+                          info);
 }
 
 }  // namespace kernel
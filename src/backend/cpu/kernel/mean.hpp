@@ -38,6 +38,34 @@ struct MeanOp {
     }
 };
 
+/// Accumulates the unweighted mean of the values of a JIT tree. See
+/// reduce_jit.hpp for the interface.
+template<typename Ti, typename Tw, typename To>
+struct MeanAccumulator {
+    using acc_t = MeanOp<compute_t<Ti>, compute_t<To>, compute_t<Tw>>;
+
+    acc_t init() const { return acc_t(0, 0); }
+
+    void operator()(acc_t& acc, data_t<Ti> val) {
+        acc(compute_t<Ti>(val), 1);
+    }
+
+    acc_t combine(acc_t lhs, const acc_t& rhs) {
+        if (rhs.runningCount != 0) {
+            compute_t<Tw> count = lhs.runningCount + rhs.runningCount;
+            lhs.runningMean =
+                (lhs.runningCount / count) * lhs.runningMean +
+                (rhs.runningCount / count) * rhs.runningMean;
+            lhs.runningCount = count;
+        }
+        return lhs;
+    }
+
+    data_t<To> result(const acc_t& acc) const {
+        return data_t<To>(acc.runningMean);
+    }
+};
+
 template<typename T, typename Tw, int D>
 struct mean_weighted_dim {
     void operator()(Param<T> output, const dim_t outOffset,
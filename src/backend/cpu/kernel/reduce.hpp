@@ -12,11 +12,16 @@
 #include <common/Binary.hpp>
 #include <common/Transform.hpp>
 #include <common/half.hpp>
+#include <parallel.hpp>
 
 namespace arrayfire {
 namespace cpu {
 namespace kernel {
 
+/// The minimum number of input elements reduced by a single task of the
+/// thread pool
+constexpr dim_t kReduceGrainElements = 1 << 15;
+
 template<af_op_t op, typename Ti, typename To, int D>
 struct reduce_dim {
     void operator()(Param<To> out, const dim_t outOffset, CParam<Ti> in,
@@ -28,12 +33,22 @@ struct reduce_dim {
         const af::dim4 ostrides = out.strides();
         const af::dim4 istrides = in.strides();
         const af::dim4 odims    = out.dims();
+        const af::dim4 idims    = in.dims();
 
-        for (dim_t i = 0; i < odims[D1]; i++) {
-            reduce_dim_next(out, outOffset + i * ostrides[D1], in,
-                            inOffset + i * istrides[D1], dim, change_nan,
-                            nanval);
-        }
+        // The number of input elements reduced by each iteration
+        dim_t slice = 1;
+        for (int i = 0; i < D1; i++) { slice *= idims[i]; }
+        if (dim > D1) { slice *= idims[dim]; }
+
+        parallel_for(
+            0, odims[D1], kReduceGrainElements / std::max(slice, dim_t(1)),
+            [&](dim_t begin, dim_t end) {
+                for (dim_t i = begin; i < end; i++) {
+                    reduce_dim_next(out, outOffset + i * ostrides[D1], in,
+                                    inOffset + i * istrides[D1], dim,
+                                    change_nan, nanval);
+                }
+            });
     }
 };
 
@@ -171,29 +186,39 @@ struct reduce_all {
         const data_t<Ti> *inPtr  = in.get();
         data_t<To> *const outPtr = out.get();
 
-        compute_t<To> out_val = common::Binary<compute_t<To>, op>::init();
-
-        for (dim_t l = 0; l < dims[3]; l++) {
-            dim_t off3 = l * strides[3];
-
-            for (dim_t k = 0; k < dims[2]; k++) {
-                dim_t off2 = k * strides[2];
-
-                for (dim_t j = 0; j < dims[1]; j++) {
-                    dim_t off1 = j * strides[1];
-
-                    for (dim_t i = 0; i < dims[0]; i++) {
-                        dim_t idx = i + off1 + off2 + off3;
-
-                        compute_t<To> in_val = transform(inPtr[idx]);
-                        if (change_nan) {
-                            in_val = IS_NAN(in_val) ? nanval : in_val;
-                        }
-                        out_val = reduce(in_val, out_val);
+        // Each task reduces a range of the elements in column-major order, so
+        // vectors are split as well as matrices. The partial results are
+        // combined in order so the result does not depend on the number of
+        // threads.
+        auto reduceRange = [&](dim_t begin, dim_t end) {
+            compute_t<To> out_val = common::Binary<compute_t<To>, op>::init();
+            dim_t i               = begin % dims[0];
+            for (dim_t r = begin / dims[0], idx = begin; idx < end;
+                 r++, i = 0) {
+                dim_t j   = r % dims[1];
+                dim_t k   = (r / dims[1]) % dims[2];
+                dim_t l   = r / (dims[1] * dims[2]);
+                dim_t off = j * strides[1] + k * strides[2] + l * strides[3];
+
+                const dim_t stop = std::min(dims[0], i + (end - idx));
+                idx += stop - i;
+                for (; i < stop; i++) {
+                    compute_t<To> in_val = transform(inPtr[i + off]);
+                    if (change_nan) {
+                        in_val = IS_NAN(in_val) ? nanval : in_val;
                     }
+                    out_val = reduce(in_val, out_val);
                 }
             }
-        }
+            return out_val;
+        };
+
+        compute_t<To> out_val = parallel_reduce(
+            0, dims.elements(), kReduceGrainElements,
+            common::Binary<compute_t<To>, op>::init(), reduceRange,
+            [&](compute_t<To> lhs, compute_t<To> rhs) {
+                return reduce(rhs, lhs);
+            });
 
         *outPtr = data_t<To>(out_val);
     }
@@ -0,0 +1,321 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Param.hpp>
+#include <common/Binary.hpp>
+#include <common/Transform.hpp>
+#include <common/dispatch.hpp>
+#include <common/jit/Node.hpp>
+#include <jit/Tape.hpp>
+#include <kernel/Array.hpp>
+#include <kernel/reduce.hpp>
+#include <parallel.hpp>
+
+#include <algorithm>
+#include <vector>
+
+// The kernels in this file reduce the result of a JIT tree without writing it
+// to memory. The tree is evaluated one chunk of the length chosen for its tape
+// at a time and each chunk is accumulated as soon as it has been computed.
+// When the buffers of the tree are linear, the chunks follow the linear index
+// instead of the rows, so a short first dimension does not shorten them.
+//
+// The reduction itself is described by an accumulator with the following
+// interface:
+//
+//   using acc_t = ...;                      // The running state
+//   acc_t init();                           // The state of an empty range
+//   void operator()(acc_t &acc, data_t<Ti>) // Adds a value to the state
+//   acc_t combine(acc_t lhs, acc_t rhs)     // Merges two partial states
+//   data_t<To> result(const acc_t &acc)     // The final value of a state
+
+namespace arrayfire {
+namespace cpu {
+namespace kernel {
+
+/// Accumulates values using the binary operation \p op. Matches the semantics
+/// of reduce_dim and reduce_all.
+template<af_op_t op, typename Ti, typename To>
+struct ReduceAccumulator {
+    using acc_t = compute_t<To>;
+
+    common::Transform<data_t<Ti>, compute_t<To>, op> transform;
+    common::Binary<compute_t<To>, op> reduce;
+    bool change_nan;
+    double nanval;
+
+    ReduceAccumulator(bool change_nan_, double nanval_)
+        : change_nan(change_nan_), nanval(nanval_) {}
+
+    acc_t init() const { return common::Binary<compute_t<To>, op>::init(); }
+
+    void operator()(acc_t &acc, data_t<Ti> val) {
+        compute_t<To> in_val = transform(val);
+        if (change_nan) in_val = IS_NAN(in_val) ? nanval : in_val;
+        acc = reduce(in_val, acc);
+    }
+
+    acc_t combine(acc_t lhs, acc_t rhs) { return reduce(rhs, lhs); }
+
+    data_t<To> result(const acc_t &acc) const { return data_t<To>(acc); }
+};
+
+/// Returns true if \p strides are the strides of a packed array of \p dims
+inline bool isPacked(const af::dim4 &dims, const af::dim4 &strides) {
+    dim_t expected = 1;
+    for (int i = 0; i < 4; i++) {
+        if (dims[i] > 1 && strides[i] != expected) { return false; }
+        expected *= dims[i];
+    }
+    return true;
+}
+
+/// Runs \p reduceChunks over the chunks [0, nchunks) in blocks of \p grain
+/// chunks
+template<typename Acc, typename Func>
+void forEachChunkBlock(Acc &acc, const dim_t nchunks, const dim_t grain,
+                       Func reduceChunks) {
+    if (nchunks < 2 * grain || getNumThreads() == 1) {
+        reduceChunks(acc, 0, nchunks);
+        return;
+    }
+    parallel_for(0, nchunks, grain, [&](dim_t begin, dim_t end) {
+        Acc a = acc;
+        reduceChunks(a, begin, end);
+    });
+}
+
+/// Reduces the output of a linear JIT tree along the dimension \p dim > 0
+/// into the packed buffer \p outPtr
+///
+/// The elements reduced together are idims[0] * ... * idims[dim - 1] apart.
+/// Each chunk covers consecutive elements of these slices, whatever the length
+/// of the first dimension.
+template<typename Ti, typename To, typename Acc>
+void reduce_dim_jit_linear(data_t<To> *const outPtr,
+                           const jit::TapeBinding &binding,
+                           const af::dim4 &idims, const int dim, Acc &acc) {
+    using acc_t = typename Acc::acc_t;
+
+    const int length = binding.tape->chunk_length;
+    dim_t inner      = 1;
+    dim_t outer      = 1;
+    for (int d = 0; d < dim; d++) { inner *= idims[d]; }
+    for (int d = dim + 1; d < 4; d++) { outer *= idims[d]; }
+    const dim_t reduced      = idims[dim];
+    const dim_t inner_chunks = divup(inner, length);
+    const dim_t nchunks      = outer * inner_chunks;
+    const dim_t grain        = std::max(
+        kReduceGrainElements / std::max(length * reduced, dim_t(1)), dim_t(1));
+
+    forEachChunkBlock(acc, nchunks, grain, [&](Acc &a, dim_t begin, dim_t end) {
+        jit::Frame frame(binding);
+        std::vector<acc_t> vals(length, a.init());
+        for (dim_t c = begin; c < end; c++) {
+            const dim_t o = c / inner_chunks;
+            const dim_t j = (c % inner_chunks) * length;
+            const int lim =
+                static_cast<int>(std::min<dim_t>(length, inner - j));
+            std::fill(vals.begin(), vals.begin() + lim, a.init());
+            for (dim_t k = 0; k < reduced; k++) {
+                frame.eval((o * reduced + k) * inner + j, lim);
+                const compute_t<Ti> *in = frame.output<Ti>(0);
+                for (int i = 0; i < lim; i++) {
+                    a(vals[i], data_t<Ti>(in[i]));
+                }
+            }
+            data_t<To> *const dst = outPtr + o * inner + j;
+            for (int i = 0; i < lim; i++) { dst[i] = a.result(vals[i]); }
+        }
+    });
+}
+
+/// Reduces the rows of a linear JIT tree shorter than a chunk into the packed
+/// buffer \p outPtr. Each chunk covers as many whole rows as it can hold.
+template<typename Ti, typename To, typename Acc>
+void reduce_rows_jit_linear(data_t<To> *const outPtr,
+                            const jit::TapeBinding &binding,
+                            const af::dim4 &idims, Acc &acc) {
+    using acc_t = typename Acc::acc_t;
+
+    const dim_t row_elems      = idims[0];
+    const dim_t nrows          = idims[1] * idims[2] * idims[3];
+    const dim_t rows_per_chunk = binding.tape->chunk_length / row_elems;
+    const dim_t nchunks        = divup(nrows, rows_per_chunk);
+    const dim_t grain          = std::max(
+        kReduceGrainElements / (rows_per_chunk * row_elems), dim_t(1));
+
+    forEachChunkBlock(acc, nchunks, grain, [&](Acc &a, dim_t begin, dim_t end) {
+        jit::Frame frame(binding);
+        for (dim_t c = begin; c < end; c++) {
+            const dim_t first = c * rows_per_chunk;
+            const dim_t count = std::min(rows_per_chunk, nrows - first);
+            frame.eval(first * row_elems, static_cast<int>(count * row_elems));
+            const compute_t<Ti> *in = frame.output<Ti>(0);
+            for (dim_t r = 0; r < count; r++, in += row_elems) {
+                acc_t val = a.init();
+                for (dim_t i = 0; i < row_elems; i++) {
+                    a(val, data_t<Ti>(in[i]));
+                }
+                outPtr[first + r] = a.result(val);
+            }
+        }
+    });
+}
+
+/// Reduces the output of the JIT tree \p node with the shape \p idims along
+/// the dimension \p dim and writes the result to \p out
+template<typename Ti, typename To, typename Acc>
+void reduce_dim_jit(Param<To> out, common::Node_ptr node, const af::dim4 idims,
+                    const int dim, Acc acc) {
+    using acc_t = typename Acc::acc_t;
+
+    const af::dim4 ostrides  = out.strides();
+    data_t<To> *const outPtr = out.get();
+
+    const jit::TapeBinding binding = jit::compileTape({node});
+    const bool is_linear           = jit::isLinear(binding, idims);
+    const int length               = binding.tape->chunk_length;
+
+    af::dim4 odims = idims;
+    odims[dim]     = 1;
+
+    if (is_linear && isPacked(odims, ostrides)) {
+        if (dim != 0) {
+            reduce_dim_jit_linear<Ti, To>(outPtr, binding, idims, dim, acc);
+            return;
+        }
+        if (idims[0] > 0 && idims[0] < length) {
+            reduce_rows_jit_linear<Ti, To>(outPtr, binding, idims, acc);
+            return;
+        }
+    }
+
+    // Each output row along the first dimension is produced by a single task.
+    // The reduced dimension is iterated in order so the result is the same as
+    // the one of reduce_dim.
+    const dim_t nrows     = odims[1] * odims[2] * odims[3];
+    const dim_t row_elems = idims[0] * (dim == 0 ? 1 : idims[dim]);
+    const dim_t grain =
+        std::max(kReduceGrainElements / std::max(row_elems, dim_t(1)),
+                 dim_t(1));
+
+    auto reduceRows = [&](Acc &a, dim_t begin, dim_t end) {
+        jit::Frame frame(binding);
+        std::vector<acc_t> vals(length, a.init());
+        for (dim_t r = begin; r < end; r++) {
+            int c[4] = {0, static_cast<int>(r % odims[1]),
+                        static_cast<int>((r / odims[1]) % odims[2]),
+                        static_cast<int>(r / (odims[1] * odims[2]))};
+            data_t<To> *const rowPtr = outPtr + c[1] * ostrides[1] +
+                                       c[2] * ostrides[2] + c[3] * ostrides[3];
+
+            if (dim == 0) {
+                acc_t val = a.init();
+                for (int x = 0; x < idims[0]; x += length) {
+                    int lim = std::min<int>(length, idims[0] - x);
+                    const compute_t<Ti> *in = evalChunk<Ti>(
+                        frame, is_linear, idims, x, c[1], c[2], c[3], lim);
+                    for (int i = 0; i < lim; i++) {
+                        a(val, data_t<Ti>(in[i]));
+                    }
+                }
+                *rowPtr = a.result(val);
+                continue;
+            }
+
+            for (int x = 0; x < idims[0]; x += length) {
+                int lim = std::min<int>(length, idims[0] - x);
+                std::fill(vals.begin(), vals.begin() + lim, a.init());
+                for (int k = 0; k < idims[dim]; k++) {
+                    c[dim] = k;
+                    const compute_t<Ti> *in = evalChunk<Ti>(
+                        frame, is_linear, idims, x, c[1], c[2], c[3], lim);
+                    for (int i = 0; i < lim; i++) {
+                        a(vals[i], data_t<Ti>(in[i]));
+                    }
+                }
+                for (int i = 0; i < lim; i++) {
+                    rowPtr[x + i] = a.result(vals[i]);
+                }
+            }
+        }
+    };
+
+    if (nrows < 2 * grain || getNumThreads() == 1) {
+        reduceRows(acc, 0, nrows);
+        return;
+    }
+    parallel_for(0, nrows, grain, [&](dim_t begin, dim_t end) {
+        Acc a = acc;
+        reduceRows(a, begin, end);
+    });
+}
+
+/// Reduces all the elements of the JIT tree \p node with the shape \p idims
+/// and writes the result to the first element of \p out
+template<typename Ti, typename To, typename Acc>
+void reduce_all_jit(Param<To> out, common::Node_ptr node, const af::dim4 idims,
+                    Acc acc) {
+    using acc_t = typename Acc::acc_t;
+
+    const jit::TapeBinding binding = jit::compileTape({node});
+    const bool is_linear           = jit::isLinear(binding, idims);
+    const int length               = binding.tape->chunk_length;
+
+    // The rows are split into the same blocks as reduce_all so the result
+    // does not depend on the number of threads
+    const dim_t nrows = idims[1] * idims[2] * idims[3];
+    const dim_t grain =
+        std::max(kReduceGrainElements / std::max(idims[0], dim_t(1)),
+                 dim_t(1));
+
+    auto reduceRows = [&](Acc &a, dim_t begin, dim_t end) {
+        jit::Frame frame(binding);
+        acc_t val = a.init();
+        if (is_linear) {
+            // The rows of the block are consecutive in the linear index
+            const dim_t last = end * idims[0];
+            for (dim_t i = begin * idims[0]; i < last; i += length) {
+                int lim = static_cast<int>(std::min<dim_t>(length, last - i));
+                frame.eval(i, lim);
+                const compute_t<Ti> *in = frame.output<Ti>(0);
+                for (int j = 0; j < lim; j++) { a(val, data_t<Ti>(in[j])); }
+            }
+            return val;
+        }
+        for (dim_t r = begin; r < end; r++) {
+            int y = static_cast<int>(r % idims[1]);
+            int z = static_cast<int>((r / idims[1]) % idims[2]);
+            int w = static_cast<int>(r / (idims[1] * idims[2]));
+            for (int x = 0; x < idims[0]; x += length) {
+                int lim = std::min<int>(length, idims[0] - x);
+                const compute_t<Ti> *in =
+                    evalChunk<Ti>(frame, is_linear, idims, x, y, z, w, lim);
+                for (int i = 0; i < lim; i++) { a(val, data_t<Ti>(in[i])); }
+            }
+        }
+        return val;
+    };
+
+    acc_t val = parallel_reduce(
+        0, nrows, grain, acc.init(),
+        [&](dim_t begin, dim_t end) {
+            Acc a = acc;
+            return reduceRows(a, begin, end);
+        },
+        [&](acc_t lhs, acc_t rhs) { return acc.combine(lhs, rhs); });
+
+    *out.get() = acc.result(val);
+}
+
+}  // namespace kernel
+}  // namespace cpu
+}  // namespace arrayfire
@@ -0,0 +1,130 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <mapped_file.hpp>
+
+#include <common/err_common.hpp>
+#include <platform.hpp>
+#include <queue.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#if !defined(OS_WIN)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using std::lock_guard;
+using std::mutex;
+using std::shared_ptr;
+using std::string;
+
+namespace arrayfire {
+namespace cpu {
+
+namespace {
+
+/// The data of the live mappings
+struct MappingRegistry {
+    mutex registry_mutex;
+    std::unordered_set<const void *> buffers;
+    std::atomic<size_t> count{0};
+};
+
+MappingRegistry &registry() {
+    static MappingRegistry reg;
+    return reg;
+}
+
+#if !defined(OS_WIN)
+void registerBuffer(const void *ptr) {
+    MappingRegistry &reg = registry();
+    lock_guard<mutex> lock(reg.registry_mutex);
+    reg.buffers.insert(ptr);
+    reg.count++;
+}
+
+void unregisterBuffer(const void *ptr) {
+    MappingRegistry &reg = registry();
+    lock_guard<mutex> lock(reg.registry_mutex);
+    reg.buffers.erase(ptr);
+    reg.count--;
+}
+#endif
+
+}  // namespace
+
+shared_ptr<void> mapFile(const char *filename, size_t offset, size_t bytes) {
+#if defined(OS_WIN)
+    UNUSED(filename);
+    UNUSED(offset);
+    UNUSED(bytes);
+    AF_ERROR("Mapping files is not supported on Windows",
+             AF_ERR_NOT_SUPPORTED);
+#else
+    const int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        string errStr = "Failed to open: " + string(filename);
+        AF_ERROR(errStr.c_str(), AF_ERR_ARG);
+    }
+
+    struct stat file_info {};
+    const bool fits = fstat(fd, &file_info) == 0 &&
+                      bytes <= static_cast<size_t>(file_info.st_size) &&
+                      offset <= static_cast<size_t>(file_info.st_size) - bytes;
+    if (!fits) {
+        close(fd);
+        AF_ERROR("The file is smaller than the array", AF_ERR_ARG);
+    }
+
+    // The mapping starts on a page boundary
+    const auto page_bytes = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t head     = offset % page_bytes;
+    const size_t length   = head + bytes;
+    // The read-only arrays are also mapped writable as a few functions write
+    // to the arrays they are given without checking if they own their data.
+    // The written pages become private copies either way.
+    int flags = MAP_PRIVATE;
+#if defined(MAP_NORESERVE)
+    flags |= MAP_NORESERVE;
+#endif
+    void *base = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, fd,
+                      static_cast<off_t>(offset - head));
+    // The mapping keeps the file open
+    close(fd);
+    if (base == MAP_FAILED) {
+        string errStr = "Failed to map: " + string(filename);
+        AF_ERROR(errStr.c_str(), AF_ERR_RUNTIME);
+    }
+
+    void *data = static_cast<char *>(base) + head;
+    registerBuffer(data);
+    return shared_ptr<void>(data, [base, length](void *ptr) {
+        unregisterBuffer(ptr);
+        // The tasks enqueued before the last array was released can still
+        // read the pages
+        getQueue().retire([base, length]() { munmap(base, length); });
+    });
+#endif
+}
+
+bool isMappedBuffer(const void *ptr) {
+    MappingRegistry &reg = registry();
+    if (reg.count.load(std::memory_order_acquire) == 0) { return false; }
+    lock_guard<mutex> lock(reg.registry_mutex);
+    return reg.buffers.count(ptr) != 0;
+}
+
+}  // namespace cpu
+}  // namespace arrayfire
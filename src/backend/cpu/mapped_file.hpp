@@ -0,0 +1,37 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace arrayfire {
+namespace cpu {
+
+/// Maps \p bytes bytes of a file in memory
+///
+/// The pages are read from the file when they are first accessed. The file is
+/// never modified: the pages written to become private copies.
+///
+/// \param[in] filename the path of the file
+/// \param[in] offset   the position of the data in the file
+/// \param[in] bytes    the size of the data
+///
+/// \returns the data. The file is unmapped once the last reference is
+///          released and the tasks enqueued before have completed.
+std::shared_ptr<void> mapFile(const char *filename, size_t offset,
+                              size_t bytes);
+
+/// Returns true if \p ptr is the data of a mapping created by \ref mapFile.
+/// These buffers are not owned by the memory manager.
+bool isMappedBuffer(const void *ptr);
+
+}  // namespace cpu
+}  // namespace arrayfire
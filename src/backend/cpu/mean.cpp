@@ -10,6 +10,7 @@
 #include <Array.hpp>
 #include <common/half.hpp>
 #include <kernel/mean.hpp>
+#include <kernel/reduce_jit.hpp>
 #include <mean.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
@@ -33,6 +34,15 @@ Array<To> mean(const Array<Ti> &in, const int dim) {
     dim4 odims    = in.dims();
     odims[dim]    = 1;
     Array<To> out = createEmptyArray<To>(odims);
+
+    // Average JIT trees as they are evaluated instead of materializing them
+    if (!in.isReady()) {
+        using Acc = kernel::MeanAccumulator<Ti, Tw, To>;
+        getQueue().enqueue(kernel::reduce_dim_jit<Ti, To, Acc>, out,
+                           in.getNode(), in.dims(), dim, Acc());
+        return out;
+    }
+
     static const mean_dim_func<Ti, Tw, To> mean_funcs[] = {
         kernel::mean_dim<Ti, Tw, To, 1>(), kernel::mean_dim<Ti, Tw, To, 2>(),
         kernel::mean_dim<Ti, Tw, To, 3>(), kernel::mean_dim<Ti, Tw, To, 4>()};
@@ -100,7 +110,14 @@ T mean(const Array<T> &in, const Array<Tw> &wt) {
 template<typename Ti, typename Tw, typename To>
 To mean(const Array<Ti> &in) {
     using MeanOpT = kernel::MeanOp<compute_t<Ti>, compute_t<To>, compute_t<Tw>>;
-    in.eval();
+    if (!in.isReady()) {
+        using Acc     = kernel::MeanAccumulator<Ti, Tw, To>;
+        Array<To> out = createEmptyArray<To>(1);
+        getQueue().enqueue(kernel::reduce_all_jit<Ti, To, Acc>, out,
+                           in.getNode(), in.dims(), Acc());
+        getQueue().sync();
+        return *out.get();
+    }
     getQueue().sync();
 
     af::dim4 dims    = in.dims();
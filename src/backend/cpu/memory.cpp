@@ -9,18 +9,31 @@
 
 #include <memory.hpp>
 
+#include <Graph.hpp>
+#include <allocation_policy.hpp>
+#include <arena.hpp>
 #include <common/DefaultMemoryManager.hpp>
 #include <common/Logger.hpp>
+#include <common/dispatch.hpp>
 #include <common/half.hpp>
 #include <err_cpu.hpp>
+#include <mapped_file.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <spdlog/spdlog.h>
 #include <types.hpp>
 #include <af/dim4.hpp>
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <utility>
 
+#if defined(OS_LNX)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 using af::dim4;
 using arrayfire::common::bytesToString;
 using arrayfire::common::half;
@@ -30,6 +43,26 @@ using std::unique_ptr;
 
 namespace arrayfire {
 namespace cpu {
+
+namespace {
+
+/// Returns the size of a buffer allocated by memAlloc
+size_t allocatedBytes(void *ptr) {
+    if (auto buffer = findArenaBuffer(ptr)) { return buffer->bytes(); }
+    return memoryManager().allocated(ptr);
+}
+
+/// Releases the lock of ArrayFire on a buffer allocated by memAlloc
+void unlockBuffer(void *ptr) {
+    if (auto buffer = findArenaBuffer(ptr)) {
+        buffer->unlock(false);
+    } else {
+        memoryManager().unlock(ptr, false);
+    }
+}
+
+}  // namespace
+
 float getMemoryPressure() { return memoryManager().getMemoryPressure(); }
 float getMemoryPressureThreshold() {
     return memoryManager().getMemoryPressureThreshold();
@@ -45,6 +78,10 @@ void setMemStepSize(size_t step_bytes) {
 
 size_t getMemStepSize() { return memoryManager().getMemStepSize(); }
 
+void setMemCacheBudget(size_t bytes) { memoryManager().setCacheBudget(bytes); }
+
+size_t getMemCacheBudget() { return memoryManager().getCacheBudget(); }
+
 void signalMemoryCleanup() { memoryManager().signalMemoryCleanup(); }
 
 void shutdownMemoryManager() { memoryManager().shutdown(); }
@@ -57,9 +94,11 @@ template<typename T>
 unique_ptr<T[], function<void(void *)>> memAlloc(const size_t &elements) {
     // TODO: make memAlloc aware of array shapes
     dim4 dims(elements);
-    T *ptr = static_cast<T *>(
-        memoryManager().alloc(false, 1, dims.get(), sizeof(T)));
-    return unique_ptr<T[], function<void(void *)>>(ptr, memFree);
+    // The arena of the calling thread skips the bookkeeping of the manager
+    void *ptr = arenaAlloc(elements * sizeof(T));
+    if (!ptr) { ptr = memoryManager().alloc(false, 1, dims.get(), sizeof(T)); }
+    return unique_ptr<T[], function<void(void *)>>(static_cast<T *>(ptr),
+                                                   memFree);
 }
 
 void *memAllocUser(const size_t &bytes) {
@@ -68,15 +107,61 @@ void *memAllocUser(const size_t &bytes) {
     return ptr;
 }
 
-void memFree(void *ptr) { return memoryManager().unlock(ptr, false); }
+void memFree(void *ptr) {
+    const bool deferred = isThreadQueueEnabled() || hasGraphs();
+    const size_t bytes = deferred && ptr ? allocatedBytes(ptr) : 0;
+    if (bytes == 0) { return unlockBuffer(ptr); }
+
+    // The graphs replay their tasks on the buffers they were captured with
+    if (retainByGraphs(ptr, bytes)) { return; }
+    if (!isThreadQueueEnabled()) { return unlockBuffer(ptr); }
+
+    // The tasks of the calling thread can still use the buffer, and so can
+    // the tasks of the threads the array was shared with. It is returned to
+    // the pool shared by the queues of all the threads once the tasks of the
+    // calling thread accessing it and the tasks already enqueued on the other
+    // queues have completed.
+    auto remaining = std::make_shared<std::atomic<int>>(1);
+    auto release   = [ptr, remaining]() {
+        if (remaining->fetch_sub(1) == 1) { unlockBuffer(ptr); }
+    };
+    queue &own = getQueue();
+    forEachQueue([&](queue &q) {
+        // The workers do not use the queue of the calling thread
+        if (&q == &own && !own.is_worker()) { return; }
+        remaining->fetch_add(1);
+        q.retire(release);
+    });
+    const auto begin = reinterpret_cast<std::uintptr_t>(ptr);
+    own.enqueueRelease({begin, begin + bytes, true}, release);
+}
 
 void memFreeUser(void *ptr) { memoryManager().unlock(ptr, true); }
 
-void memLock(const void *ptr) { memoryManager().userLock(ptr); }
+// The mapped files are released with their arrays, the user locks do not
+// apply to them
+void memLock(const void *ptr) {
+    if (auto buffer = findArenaBuffer(ptr)) {
+        buffer->userLock();
+    } else if (!isMappedBuffer(ptr)) {
+        memoryManager().userLock(ptr);
+    }
+}
 
-bool isLocked(const void *ptr) { return memoryManager().isUserLocked(ptr); }
+bool isLocked(const void *ptr) {
+    if (auto buffer = findArenaBuffer(ptr)) {
+        return buffer->isUserLocked();
+    }
+    return !isMappedBuffer(ptr) && memoryManager().isUserLocked(ptr);
+}
 
-void memUnlock(const void *ptr) { memoryManager().userUnlock(ptr); }
+void memUnlock(const void *ptr) {
+    if (auto buffer = findArenaBuffer(ptr)) {
+        buffer->unlock(true);
+    } else if (!isMappedBuffer(ptr)) {
+        memoryManager().userUnlock(ptr);
+    }
+}
 
 void deviceMemoryInfo(size_t *alloc_bytes, size_t *alloc_buffers,
                       size_t *lock_bytes, size_t *lock_buffers) {
@@ -84,6 +169,12 @@ void deviceMemoryInfo(size_t *alloc_bytes, size_t *alloc_buffers,
                               lock_buffers);
 }
 
+void deviceMemoryStats(af_memory_stats *stats) {
+    memoryManager().memoryStats(stats);
+}
+
+void resetMemoryStats() { memoryManager().resetMemoryStats(); }
+
 template<typename T>
 T *pinnedAlloc(const size_t &elements) {
     // TODO: make pinnedAlloc aware of array shapes
@@ -143,18 +234,119 @@ size_t Allocator::getMaxMemorySize(int id) {
 }
 
 void *Allocator::nativeAlloc(const size_t bytes) {
-    void *ptr = malloc(bytes);  // NOLINT(hicpp-no-malloc)
+    size_t mapped_bytes = 0;
+    void *ptr           = allocateHost(bytes, &mapped_bytes);
+    if (!ptr) {
+        // The buffers freed by the garbage collection are released once the
+        // tasks which were pending when they were freed complete
+        getQueue().wait();
+        ptr = allocateHost(bytes, &mapped_bytes);
+    }
     AF_TRACE("nativeAlloc: {:>7} {}", bytesToString(bytes), ptr);
     if (!ptr) { AF_ERROR("Unable to allocate memory", AF_ERR_NO_MEM); }
+    if (mapped_bytes) {
+        std::lock_guard<std::mutex> lock(mapped_mutex);
+        mapped[ptr] = mapped_bytes;
+    }
     return ptr;
 }
 
 void Allocator::nativeFree(void *ptr) {
     AF_TRACE("nativeFree: {: >8} {}", " ", ptr);
-    // Make sure this pointer is not being used on the queue before freeing the
-    // memory.
-    getQueue().sync();
-    free(ptr);  // NOLINT(hicpp-no-malloc)
+    size_t mapped_bytes = 0;
+    {
+        std::lock_guard<std::mutex> lock(mapped_mutex);
+        auto iter = mapped.find(ptr);
+        if (iter != mapped.end()) {
+            mapped_bytes = iter->second;
+            mapped.erase(iter);
+        }
+    }
+
+    // The tasks enqueued before this call can still use the memory. It is
+    // freed once they have completed without waiting for the tasks enqueued
+    // after it.
+    auto remaining = std::make_shared<std::atomic<int>>(1);
+    auto release   = [ptr, mapped_bytes, remaining]() {
+        if (remaining->fetch_sub(1) == 1) { freeHost(ptr, mapped_bytes); }
+    };
+
+    // The pages must not be released once the memory belongs to someone
+    // else. A decommit which has not started is dropped, one in progress
+    // frees the memory when it is done. This call can run on a queue worker
+    // so it never waits for the decommit.
+    if (std::shared_ptr<Decommit> decommit = takeDecommit(ptr)) {
+        std::lock_guard<std::mutex> lock(decommit->mutex);
+        if (!decommit->running) {
+            decommit->cancelled = true;
+        } else if (!decommit->done) {
+            remaining->fetch_add(1);
+            decommit->after = release;
+        }
+    }
+    getQueue().retire(release);
+}
+
+void Allocator::nativeDecommit(void *ptr, const size_t bytes) {
+#if defined(OS_LNX)
+    // Only the pages fully inside the buffer can be released
+    const auto page_bytes = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto address    = reinterpret_cast<std::uintptr_t>(ptr);
+    const auto begin      = divup(address, page_bytes) * page_bytes;
+    const auto end        = (address + bytes) / page_bytes * page_bytes;
+    if (end <= begin) { return; }
+
+    AF_TRACE("nativeDecommit: {:>7} {}", bytesToString(end - begin), ptr);
+    auto decommit = std::make_shared<Decommit>();
+    {
+        std::lock_guard<std::mutex> lock(decommit_mutex);
+        decommits[ptr] = decommit;
+    }
+    // The tasks enqueued before the buffer was freed can still use it. The
+    // pages read as zeros once released, like the ones of a new mapping.
+    getQueue().retire([begin, end, decommit]() {
+        {
+            std::lock_guard<std::mutex> lock(decommit->mutex);
+            if (decommit->cancelled) { return; }
+            decommit->running = true;
+        }
+        madvise(reinterpret_cast<void *>(begin), end - begin, MADV_DONTNEED);
+        std::function<void()> after;
+        {
+            std::lock_guard<std::mutex> lock(decommit->mutex);
+            decommit->done = true;
+            after          = std::move(decommit->after);
+        }
+        decommit->cv.notify_all();
+        if (after) { after(); }
+    });
+#else
+    UNUSED(ptr);
+    UNUSED(bytes);
+#endif
+}
+
+void Allocator::nativeRecommit(void *ptr) {
+    // The released pages are mapped again when they are touched. A decommit
+    // which has not started is dropped. One in progress only waits for
+    // madvise, not for the tasks of the queues.
+    std::shared_ptr<Decommit> decommit = takeDecommit(ptr);
+    if (!decommit) { return; }
+    std::unique_lock<std::mutex> lock(decommit->mutex);
+    if (!decommit->running) {
+        decommit->cancelled = true;
+        return;
+    }
+    decommit->cv.wait(lock, [&decommit]() { return decommit->done; });
+}
+
+std::shared_ptr<Allocator::Decommit> Allocator::takeDecommit(void *ptr) {
+    std::lock_guard<std::mutex> lock(decommit_mutex);
+    auto iter = decommits.find(ptr);
+    if (iter == decommits.end()) { return nullptr; }
+    std::shared_ptr<Decommit> decommit = std::move(iter->second);
+    decommits.erase(iter);
+    return decommit;
 }
 }  // namespace cpu
 }  // namespace arrayfire
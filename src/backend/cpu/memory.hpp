@@ -10,9 +10,13 @@
 
 #include <common/AllocatorInterface.hpp>
 #include <af/defines.h>
+#include <af/device.h>
 
+#include <condition_variable>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 namespace arrayfire {
 namespace cpu {
@@ -40,6 +44,8 @@ void pinnedFree(void *ptr);
 
 void deviceMemoryInfo(size_t *alloc_bytes, size_t *alloc_buffers,
                       size_t *lock_bytes, size_t *lock_buffers);
+void deviceMemoryStats(af_memory_stats *stats);
+void resetMemoryStats();
 void signalMemoryCleanup();
 void shutdownMemoryManager();
 void pinnedGarbageCollect();
@@ -51,6 +57,8 @@ float getMemoryPressureThreshold();
 bool jitTreeExceedsMemoryPressure(size_t bytes);
 void setMemStepSize(size_t step_bytes);
 size_t getMemStepSize(void);
+void setMemCacheBudget(size_t bytes);
+size_t getMemCacheBudget();
 
 class Allocator final : public common::AllocatorInterface {
    public:
@@ -61,6 +69,33 @@ class Allocator final : public common::AllocatorInterface {
     size_t getMaxMemorySize(int id) override;
     void *nativeAlloc(const size_t bytes) override;
     void nativeFree(void *ptr) override;
+    void nativeDecommit(void *ptr, const size_t bytes) override;
+    void nativeRecommit(void *ptr) override;
+
+   private:
+    /// The release of the pages of a free buffer, retired on a queue
+    struct Decommit {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool cancelled = false;
+        bool running   = false;
+        bool done      = false;
+
+        /// Called once the pages have been released
+        std::function<void()> after;
+    };
+
+    /// Removes the decommit of \p ptr from decommits. Returns nullptr if the
+    /// buffer was not decommitted.
+    std::shared_ptr<Decommit> takeDecommit(void *ptr);
+
+    /// The lengths of the buffers mapped by allocateHost
+    std::mutex mapped_mutex;
+    std::unordered_map<void *, size_t> mapped;
+
+    /// The decommits of the buffers in the cache of the memory manager
+    std::mutex decommit_mutex;
+    std::unordered_map<void *, std::shared_ptr<Decommit>> decommits;
 };
 
 }  // namespace cpu
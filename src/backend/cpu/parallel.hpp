@@ -0,0 +1,102 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/dispatch.hpp>
+#include <platform.hpp>
+#include <thread_pool.hpp>
+#include <af/defines.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace arrayfire {
+namespace cpu {
+
+/// The number of tasks created for each thread of the pool by parallel_for.
+/// Using more tasks than threads lets idle threads steal work from threads
+/// that were handed more expensive parts of the range.
+constexpr int kTasksPerThread = 4;
+
+/// Calls \p func on disjoint sub-ranges covering [\p begin, \p end) using the
+/// threads of the cpu backend's ThreadPool.
+///
+/// This function must be called from a kernel executing on the cpu::queue. It
+/// returns once \p func has returned for every sub-range.
+///
+/// \param[in] begin The first index of the range
+/// \param[in] end   One past the last index of the range
+/// \param[in] grain The minimum number of indices handed to each call of
+///                  \p func. Ranges smaller than twice this are evaluated by
+///                  the calling thread.
+/// \param[in] func  A callable with the signature void(dim_t b, dim_t e)
+template<typename F>
+void parallel_for(dim_t begin, dim_t end, dim_t grain, F &&func) {
+    const dim_t count = end - begin;
+    if (count <= 0) { return; }
+    grain = std::max(grain, dim_t(1));
+
+    std::shared_ptr<ThreadPool> pool = getThreadPool();
+    const int num_tasks =
+        static_cast<int>(std::min(count / grain, dim_t(kTasksPerThread) *
+                                                     dim_t(pool->size())));
+    if (num_tasks <= 1) {
+        func(begin, end);
+        return;
+    }
+
+    const dim_t task_count = divup(count, dim_t(num_tasks));
+    pool->run(num_tasks, [&](int task) {
+        dim_t b = begin + task * task_count;
+        dim_t e = std::min(end, b + task_count);
+        if (b < e) { func(b, e); }
+    });
+}
+
+/// Reduces [\p begin, \p end) in parallel using the threads of the cpu
+/// backend's ThreadPool.
+///
+/// The range is split into blocks of \p grain indices. \p func computes the
+/// partial result of a single block and the partial results are combined in
+/// order using \p reduce. The split only depends on the range and the grain so
+/// the result does not change with the number of threads.
+///
+/// \param[in] begin    The first index of the range
+/// \param[in] end      One past the last index of the range
+/// \param[in] grain    The number of indices in each block
+/// \param[in] identity The result of reducing an empty range
+/// \param[in] func     A callable with the signature T(dim_t b, dim_t e)
+/// \param[in] reduce   A callable with the signature T(T lhs, T rhs)
+template<typename T, typename F, typename R>
+T parallel_reduce(dim_t begin, dim_t end, dim_t grain, T identity, F &&func,
+                  R &&reduce) {
+    const dim_t count = end - begin;
+    if (count <= 0) { return identity; }
+    grain = std::max(grain, dim_t(1));
+
+    const dim_t num_blocks = divup(count, grain);
+    if (num_blocks == 1) { return reduce(identity, func(begin, end)); }
+
+    std::vector<T> partials(num_blocks, identity);
+    parallel_for(0, num_blocks, 1, [&](dim_t first, dim_t last) {
+        for (dim_t blk = first; blk < last; blk++) {
+            dim_t b       = begin + blk * grain;
+            partials[blk] = func(b, std::min(end, b + grain));
+        }
+    });
+
+    T result = identity;
+    for (const T &partial : partials) { result = reduce(result, partial); }
+    return result;
+}
+
+}  // namespace cpu
+}  // namespace arrayfire
@@ -27,6 +27,7 @@ using arrayfire::common::ltrim;
 using arrayfire::common::MemoryManagerBase;
 using std::endl;
 using std::ostringstream;
+using std::shared_ptr;
 using std::stoi;
 using std::string;
 using std::unique_ptr;
@@ -131,6 +132,18 @@ size_t getDeviceMemorySize(int device) {
 
 size_t getHostMemorySize() { return common::getHostMemorySize(); }
 
+size_t getL1CacheSize() {
+    static const size_t size =
+        DeviceManager::getInstance().getCPUInfo().l1CacheSize();
+    return size;
+}
+
+size_t getL2CacheSize() {
+    static const size_t size =
+        DeviceManager::getInstance().getCPUInfo().l2CacheSize();
+    return size;
+}
+
 int setDevice(int device) {
     thread_local bool flag = false;
     if (!flag && device != 0) {
@@ -144,14 +157,38 @@ int setDevice(int device) {
     return 0;
 }
 
+bool isThreadQueueEnabled() {
+    return DeviceManager::getInstance().isThreadQueueEnabled();
+}
+
+void setThreadQueueEnabled(bool enable) {
+    DeviceManager::getInstance().setThreadQueues(enable);
+}
+
+void forEachQueue(const std::function<void(queue&)>& func) {
+    DeviceManager::getInstance().forEachQueue(func);
+}
+
 queue& getQueue(int device) {
-    return DeviceManager::getInstance().queues[device];
+    DeviceManager& inst = DeviceManager::getInstance();
+    if (inst.isThreadQueueEnabled()) { return inst.getThreadQueue(device); }
+    return inst.queues[device];
 }
 
 queue* getQueueHandle(int device) { return &getQueue(device); }
 
 void sync(int device) { getQueue(device).sync(); }
 
+shared_ptr<ThreadPool> getThreadPool() {
+    return std::atomic_load(&DeviceManager::getInstance().threadPool);
+}
+
+int getNumThreads() { return getThreadPool()->size(); }
+
+void setNumThreads(int num_threads) {
+    DeviceManager::getInstance().setThreadCount(num_threads);
+}
+
 bool& evalFlag() {
     thread_local bool flag = true;
     return flag;
@@ -10,6 +10,8 @@
 #pragma once
 
 #include <queue.hpp>
+#include <functional>
+#include <memory>
 #include <string>
 
 namespace arrayfire {
@@ -24,6 +26,8 @@ using arrayfire::common::MemoryManagerBase;
 namespace arrayfire {
 namespace cpu {
 
+class ThreadPool;
+
 int getBackend();
 
 std::string getDeviceInfo() noexcept;
@@ -46,8 +50,31 @@ size_t getDeviceMemorySize(int device);
 
 size_t getHostMemorySize();
 
+/// Returns the size in bytes of the level 1 data cache of a core
+size_t getL1CacheSize();
+
+/// Returns the size in bytes of the level 2 cache of a core
+size_t getL2CacheSize();
+
 int setDevice(int device);
 
+/// Returns true if each host thread uses its own queues
+///
+/// The default is read from the AF_CPU_THREAD_QUEUES environment variable
+/// when the backend starts. The threads share a single queue per device
+/// otherwise.
+bool isThreadQueueEnabled();
+
+/// Makes each host thread use its own queues if \p enable is true
+///
+/// \note This waits for all the work on the queues to finish
+void setThreadQueueEnabled(bool enable);
+
+/// Calls \p func on every queue, including the queues of the other host
+/// threads
+void forEachQueue(const std::function<void(queue&)>& func);
+
+/// Returns the queue of \p device used by the calling thread
 queue& getQueue(int device = 0);
 
 /// Return a handle to the queue for the device.
@@ -58,6 +85,20 @@ queue* getQueueHandle(int device);
 
 void sync(int device);
 
+/// Returns the pool of threads shared by the kernels of the cpu backend
+///
+/// The pool can be replaced by setNumThreads at any time. The callers keep
+/// the returned pointer while they use the pool.
+std::shared_ptr<ThreadPool> getThreadPool();
+
+/// Returns the number of threads used by the kernels of the cpu backend
+int getNumThreads();
+
+/// Sets the number of threads used by the kernels of the cpu backend
+///
+/// \note This waits for all the work on the queue to finish
+void setNumThreads(int num_threads);
+
 bool& evalFlag();
 
 MemoryManagerBase& memoryManager();
@@ -8,105 +8,304 @@
  ********************************************************/
 #pragma once
 
+#include <Graph.hpp>
 #include <Param.hpp>
+#include <common/half.hpp>
 #include <common/util.hpp>
 #include <memory.hpp>
+#include <task_scheduler.hpp>
+#include <af/dim4.hpp>
+#include <af/seq.h>
 
 #include <algorithm>
+#include <array>
+#include <complex>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 // FIXME: Is there a better way to check for std::future not being supported ?
 #if defined(AF_DISABLE_CPU_ASYNC) || \
     (defined(__GNUC__) &&            \
      (__GCC_ATOMIC_INT_LOCK_FREE < 2 || __GCC_ATOMIC_POINTER_LOCK_FREE < 2))
-
-#include <functional>
-using std::function;
-#include <err_cpu.hpp>
 #define __SYNCHRONOUS_ARCH 1
-class queue_impl {
-   public:
-    template<typename F, typename... Args>
-    void enqueue(const F func, Args... args) const {
-        AF_ERROR("Incorrectly configured", AF_ERR_INTERNAL);
-    }
+#else
+#define __SYNCHRONOUS_ARCH 0
+#endif
 
-    void sync() const { AF_ERROR("Incorrectly configured", AF_ERR_INTERNAL); }
+namespace arrayfire {
+namespace cpu {
 
-    bool is_worker() const {
-        AF_ERROR("Incorrectly configured", AF_ERR_INTERNAL);
-        return false;
-    }
+/// The memory read and written by a task. Tasks whose arguments cannot be
+/// described are barriers which run after all the previous tasks and before
+/// all the following ones.
+struct TaskAccesses {
+    std::vector<MemoryAccess> accesses;
+    bool barrier = false;
+
+    /// False if the task takes pointers which may not be valid anymore when
+    /// the task is replayed by a Graph
+    bool replayable = true;
 };
 
-#else
+/// Returns the range of memory spanned by the elements of an array
+inline MemoryAccess getMemoryAccess(const void *ptr, const dim_t *dims,
+                                    const dim_t *strides, size_t element_size,
+                                    bool write) {
+    const auto base = reinterpret_cast<std::uintptr_t>(ptr);
+    dim_t lo = 0, hi = 0;
+    for (int i = 0; i < 4; i++) {
+        if (dims[i] == 0) { return {base, base, write}; }
+        const dim_t extent = (dims[i] - 1) * strides[i];
+        (extent < 0 ? lo : hi) += extent;
+    }
+    return {static_cast<std::uintptr_t>(base + lo * element_size),
+            static_cast<std::uintptr_t>(base + (hi + 1) * element_size),
+            write};
+}
 
-#include <threads/async_queue.hpp>
-#include <threads/event.hpp>
-#define __SYNCHRONOUS_ARCH 0
-using queue_impl = threads::async_queue;
-using event_impl = threads::event;
+/// True for the task arguments which do not refer to any memory
+template<typename T>
+struct is_passive_argument
+    : std::integral_constant<bool, std::is_arithmetic<T>::value ||
+                                       std::is_enum<T>::value ||
+                                       std::is_empty<T>::value> {};
+template<>
+struct is_passive_argument<af::dim4> : std::true_type {};
+template<>
+struct is_passive_argument<af_seq> : std::true_type {};
+template<>
+struct is_passive_argument<common::half> : std::true_type {};
+template<typename T>
+struct is_passive_argument<std::complex<T>> : std::true_type {};
+template<typename T, size_t N>
+struct is_passive_argument<std::array<T, N>> : is_passive_argument<T> {};
 
-#endif
+template<typename T>
+void addAccess(TaskAccesses &task, const T &) {
+    if (!is_passive_argument<T>::value) { task.barrier = true; }
+    if (std::is_pointer<T>::value) { task.replayable = false; }
+}
 
-namespace arrayfire {
-namespace cpu {
+template<typename T>
+void addAccess(TaskAccesses &task, Param<T> param) {
+    task.accesses.push_back(getMemoryAccess(param.get(), param.dims().get(),
+                                            param.strides().get(), sizeof(T),
+                                            true));
+}
+
+template<typename T>
+void addAccess(TaskAccesses &task, const CParam<T> &param) {
+    task.accesses.push_back(getMemoryAccess(param.get(), param.dims().get(),
+                                            param.strides().get(), sizeof(T),
+                                            false));
+}
 
-/// Wraps the async_queue class
+template<typename T>
+void addAccess(TaskAccesses &task, const std::vector<T> &values) {
+    if constexpr (!is_passive_argument<T>::value) {
+        for (const T &value : values) { addAccess(task, value); }
+    }
+}
+
+/// Wraps the TaskScheduler class
+///
+/// The memory accessed by a task is deduced from its Param and CParam
+/// arguments so tasks working on different buffers run concurrently when the
+/// scheduler has more than one worker. Tasks taking any other argument which
+/// can refer to memory, such as a pointer or a JIT node, run in the order
+/// they were enqueued. Tasks accessing only a few bytes run directly on the
+/// calling thread when the queue is idle.
 class queue {
    public:
     queue()
-        : count(0)
-        , sync_calls(__SYNCHRONOUS_ARCH == 1 ||
-                     common::getEnvVar("AF_SYNCHRONOUS_CALLS") == "1") {}
+        : sync_calls(__SYNCHRONOUS_ARCH == 1 ||
+                     common::getEnvVar("AF_SYNCHRONOUS_CALLS") == "1")
+        , inline_bytes(getDefaultInlineTaskBytes()) {
+        if (!sync_calls) {
+            scheduler = std::make_unique<TaskScheduler>(
+                getDefaultQueueThreadCount(), getDefaultQueueDepth());
+        }
+    }
 
     template<typename F, typename... Args>
     void enqueue(const F func, Args &&...args) {
-        count++;
-        if (sync_calls) {
+        TaskAccesses task;
+        (addAccess(task, toParam(args)), ...);
+        enqueueAccessing(std::move(task), func, std::forward<Args>(args)...);
+    }
+
+    /// Enqueues \p func which accesses the memory described by \p task. The
+    /// arguments are not inspected.
+    template<typename F, typename... Args>
+    void enqueueAccessing(TaskAccesses task, const F func, Args &&...args) {
+        Graph *graph = getCapturingGraph();
+        if (graph && !is_worker()) {
+            // The task is kept by the graph so it can be enqueued again
+            auto recorded = std::make_shared<const TaskScheduler::Task>(
+                std::bind(func, toParam(std::forward<Args>(args))...));
+            graph->record(recorded, task.accesses, task.barrier,
+                          task.replayable);
+            enqueueRecorded(std::move(recorded), std::move(task.accesses),
+                            task.barrier);
+        } else if (sync_calls) {
             func(toParam(std::forward<Args>(args))...);
+        } else if (TaskScheduler::current()) {
+            // Tasks enqueued by a running task are part of it
+            func(toParam(std::forward<Args>(args))...);
+            return;
+        } else if (isSmallTask(task) &&
+                   scheduler->runInline(task.accesses, [&]() {
+                       func(toParam(std::forward<Args>(args))...);
+                   })) {
+            // Small tasks skip the workers when nothing else is pending
         } else {
-            aQueue.enqueue(func, toParam(std::forward<Args>(args))...);
+            scheduler->enqueue(
+                std::bind(func, toParam(std::forward<Args>(args))...),
+                std::move(task.accesses), task.barrier);
         }
 #ifndef NDEBUG
         sync();
 #else
-        if (getMemoryPressure() >= getMemoryPressureThreshold() ||
-            count >= 25) {
-            sync();
-        }
+        if (getMemoryPressure() >= getMemoryPressureThreshold()) { sync(); }
 #endif
     }
 
+    /// Enqueues \p task recorded by a Graph. The task accesses the memory
+    /// ranges \p accesses and conflicts with every other task if \p barrier
+    /// is true.
+    void enqueueRecorded(Graph::Task task, std::vector<MemoryAccess> accesses,
+                         bool barrier) {
+        if (sync_calls) {
+            // The tasks enqueued by the task are part of it
+            CapturePause pause;
+            (*task)();
+        } else {
+            scheduler->enqueue([task]() { (*task)(); }, std::move(accesses),
+                               barrier);
+        }
+    }
+
+    /// Runs \p func once the earlier tasks accessing \p access have
+    /// completed. When called from a running task, \p func is enqueued on the
+    /// scheduler running it instead of being executed inline.
+    void enqueueRelease(MemoryAccess access, std::function<void()> func) {
+        if (sync_calls) {
+            func();
+        } else if (TaskScheduler *owner = TaskScheduler::current()) {
+            owner->enqueue(std::move(func), {access}, false);
+        } else {
+            scheduler->enqueue(std::move(func), {access}, false);
+        }
+    }
+
+    /// Calls \p release once the tasks enqueued so far have completed without
+    /// waiting for them. \p release must not enqueue tasks.
+    void retire(std::function<void()> release) {
+        if (sync_calls) {
+            release();
+        } else {
+            scheduler->retire(std::move(release));
+        }
+    }
+
+    /// Waits for the enqueued tasks to complete. A running task cannot wait
+    /// for the queue so the call does nothing on the workers.
     void sync() {
-        count = 0;
-        if (!sync_calls) aQueue.sync();
+        if (!sync_calls && !is_worker()) scheduler->sync();
     }
 
-    bool is_worker() const {
-        return (!sync_calls) ? aQueue.is_worker() : false;
+    /// Waits for the enqueued tasks to complete without reporting their
+    /// errors. The errors are reported by the next call to sync.
+    void wait() {
+        if (!sync_calls && !is_worker()) scheduler->wait();
     }
 
-    friend class queue_event;
+    /// Returns true if the calling thread runs the tasks of any queue
+    bool is_worker() const {
+        return (!sync_calls) ? TaskScheduler::current() != nullptr : false;
+    }
 
    private:
-    int count;
+    /// Returns true if \p task accesses few enough bytes to run on the
+    /// calling thread
+    bool isSmallTask(const TaskAccesses &task) const {
+        if (task.barrier || inline_bytes == 0) { return false; }
+        std::uintptr_t bytes = 0;
+        for (const MemoryAccess &access : task.accesses) {
+            bytes += access.end - access.begin;
+        }
+        return bytes <= static_cast<std::uintptr_t>(inline_bytes);
+    }
+
     const bool sync_calls;
-    queue_impl aQueue;
+    const int inline_bytes;
+    std::unique_ptr<TaskScheduler> scheduler;
 };
 
 class queue_event {
-    event_impl event_;
+    struct State {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool signaled = false;
+
+        void signal() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                signaled = true;
+            }
+            cv.notify_all();
+        }
+
+        void wait() {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this] { return signaled; });
+        }
+    };
+
+    /// The state of the last mark. Tasks waiting on earlier marks keep their
+    /// own copy.
+    std::shared_ptr<State> state_;
 
    public:
     queue_event() = default;
-    queue_event(int val) : event_(val) {}
+    queue_event(int) {}
 
-    int create() { return event_.create(); }
+    /// Creates an event which has no work to wait for
+    int create() {
+        state_           = std::make_shared<State>();
+        state_->signaled = true;
+        return 0;
+    }
+
+    /// Signals the event once the tasks enqueued on \p q have completed
+    int mark(queue &q) {
+        std::shared_ptr<State> state = std::make_shared<State>();
+        state_                       = state;
+        q.enqueueAccessing({{}, true}, [state]() { state->signal(); });
+        return 0;
+    }
+
+    /// Makes the tasks enqueued on \p q after this call wait for the event
+    int wait(queue &q) {
+        std::shared_ptr<State> state = state_;
+        if (state) {
+            q.enqueueAccessing({{}, true}, [state]() { state->wait(); });
+        }
+        return 0;
+    }
+
+    int sync() noexcept {
+        if (state_) { state_->wait(); }
+        return 0;
+    }
 
-    int mark(queue &q) { return event_.mark(q.aQueue); }
-    int wait(queue &q) { return event_.wait(q.aQueue); }
-    int sync() noexcept { return event_.sync(); }
-    operator bool() const noexcept { return event_; }
+    operator bool() const noexcept { return static_cast<bool>(state_); }
 };
 }  // namespace cpu
 }  // namespace arrayfire
@@ -12,6 +12,7 @@
 #include <common/Transform.hpp>
 #include <common/half.hpp>
 #include <kernel/reduce.hpp>
+#include <kernel/reduce_jit.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <reduce.hpp>
@@ -52,6 +53,16 @@ Array<To> reduce(const Array<Ti> &in, const int dim, bool change_nan,
     odims[dim] = 1;
 
     Array<To> out = createEmptyArray<To>(odims);
+
+    // Reduce JIT trees as they are evaluated instead of materializing them
+    if (!in.isReady()) {
+        using Acc = kernel::ReduceAccumulator<op, Ti, To>;
+        getQueue().enqueue(kernel::reduce_dim_jit<Ti, To, Acc>, out,
+                           in.getNode(), in.dims(), dim,
+                           Acc(change_nan, nanval));
+        return out;
+    }
+
     static const reduce_dim_func<op, Ti, To> reduce_funcs[4] = {
         kernel::reduce_dim<op, Ti, To, 1>(),
         kernel::reduce_dim<op, Ti, To, 2>(),
@@ -113,12 +124,16 @@ using reduce_all_func =
 
 template<af_op_t op, typename Ti, typename To>
 Array<To> reduce_all(const Array<Ti> &in, bool change_nan, double nanval) {
-    in.eval();
-
     Array<To> out = createEmptyArray<To>(1);
-    static const reduce_all_func<op, Ti, To> reduce_all_kernel =
-        kernel::reduce_all<op, Ti, To>();
-    getQueue().enqueue(reduce_all_kernel, out, in, change_nan, nanval);
+    if (in.isReady()) {
+        static const reduce_all_func<op, Ti, To> reduce_all_kernel =
+            kernel::reduce_all<op, Ti, To>();
+        getQueue().enqueue(reduce_all_kernel, out, in, change_nan, nanval);
+    } else {
+        using Acc = kernel::ReduceAccumulator<op, Ti, To>;
+        getQueue().enqueue(kernel::reduce_all_jit<Ti, To, Acc>, out,
+                           in.getNode(), in.dims(), Acc(change_nan, nanval));
+    }
     getQueue().sync();
     return out;
 }
@@ -6,41 +6,116 @@
  * The complete license agreement can be obtained at:
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
-#include <kernel/select.hpp>
 #include <select.hpp>
 
 #include <Array.hpp>
 #include <common/half.hpp>
-#include <platform.hpp>
-#include <queue.hpp>
+#include <common/jit/JitStats.hpp>
+#include <jit/SelectNode.hpp>
+
+#include <algorithm>
+#include <array>
+#include <memory>
 
 using af::dim4;
 using arrayfire::common::half;
+using arrayfire::common::Node;
+using arrayfire::common::Node_ptr;
+using std::make_shared;
+using std::max;
 
 namespace arrayfire {
 namespace cpu {
 
+template<typename T>
+Array<T> createSelectNode(const Array<char> &cond, const Array<T> &a,
+                          const Array<T> &b, const dim4 &odims) {
+    auto cond_node   = cond.getNode();
+    auto a_node      = a.getNode();
+    auto b_node      = b.getNode();
+    auto a_height    = a_node->getHeight();
+    auto b_height    = b_node->getHeight();
+    auto cond_height = cond_node->getHeight();
+
+    Node_ptr node = make_shared<jit::SelectNode<T, af_select_t>>(
+        cond_node, a_node, b_node);
+    std::array<Node *, 1> nodes{node.get()};
+    const kJITHeuristics heuristic = passesJitHeuristics<T>(nodes);
+    if (heuristic != kJITHeuristics::Pass) {
+        common::recordJitHeuristic(heuristic);
+        if (a_height > max(b_height, cond_height)) {
+            a.eval();
+        } else if (b_height > cond_height) {
+            b.eval();
+        } else {
+            cond.eval();
+        }
+        return createSelectNode<T>(cond, a, b, odims);
+    }
+    return createNodeArray<T>(odims, node);
+}
+
+template<typename T, bool flip>
+Array<T> createSelectNode(const Array<char> &cond, const Array<T> &a,
+                          const T &b_val, const dim4 &odims) {
+    auto cond_node   = cond.getNode();
+    auto a_node      = a.getNode();
+    auto b_node      = createValueArray<T>(odims, b_val).getNode();
+    auto a_height    = a_node->getHeight();
+    auto cond_height = cond_node->getHeight();
+
+    Node_ptr node;
+    if (flip) {
+        node = make_shared<jit::SelectNode<T, af_not_select_t>>(
+            cond_node, a_node, b_node);
+    } else {
+        node = make_shared<jit::SelectNode<T, af_select_t>>(cond_node, a_node,
+                                                            b_node);
+    }
+    std::array<Node *, 1> nodes{node.get()};
+    const kJITHeuristics heuristic = passesJitHeuristics<T>(nodes);
+    if (heuristic != kJITHeuristics::Pass) {
+        common::recordJitHeuristic(heuristic);
+        if (a_height > cond_height) {
+            a.eval();
+        } else {
+            cond.eval();
+        }
+        return createSelectNode<T, flip>(cond, a, b_val, odims);
+    }
+    return createNodeArray<T>(odims, node);
+}
+
 template<typename T>
 void select(Array<T> &out, const Array<char> &cond, const Array<T> &a,
             const Array<T> &b) {
-    getQueue().enqueue(kernel::select<T>, out, cond, a, b);
+    out = createSelectNode<T>(cond, a, b, out.dims());
 }
 
 template<typename T, bool flip>
 void select_scalar(Array<T> &out, const Array<char> &cond, const Array<T> &a,
                    const T &b) {
-    getQueue().enqueue(kernel::select_scalar<T, flip>, out, cond, a, b);
+    out = createSelectNode<T, flip>(cond, a, b, out.dims());
 }
 
-#define INSTANTIATE(T)                                                   \
-    template void select<T>(Array<T> & out, const Array<char> &cond,     \
-                            const Array<T> &a, const Array<T> &b);       \
-    template void select_scalar<T, true>(Array<T> & out,                 \
-                                         const Array<char> &cond,        \
-                                         const Array<T> &a, const T &b); \
-    template void select_scalar<T, false>(Array<T> & out,                \
-                                          const Array<char> &cond,       \
-                                          const Array<T> &a, const T &b);
+#define INSTANTIATE(T)                                                    \
+    template void select<T>(Array<T> & out, const Array<char> &cond,      \
+                            const Array<T> &a, const Array<T> &b);        \
+    template void select_scalar<T, true>(Array<T> & out,                  \
+                                         const Array<char> &cond,         \
+                                         const Array<T> &a, const T &b);  \
+    template void select_scalar<T, false>(Array<T> & out,                 \
+                                          const Array<char> &cond,        \
+                                          const Array<T> &a, const T &b); \
+    template Array<T> createSelectNode<T>(                                \
+        const Array<char> &cond, const Array<T> &a, const Array<T> &b,    \
+        const af::dim4 &odims);                                           \
+    template Array<T> createSelectNode<T, true>(                          \
+        const Array<char> &cond, const Array<T> &a, const T &b_val,       \
+        const af::dim4 &odims);                                           \
+    template Array<T> createSelectNode<T, false>(                         \
+        const Array<char> &cond, const Array<T> &a, const T &b_val,       \
+        const af::dim4 &odims);
 
 INSTANTIATE(float)
 INSTANTIATE(double)
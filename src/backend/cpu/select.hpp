@@ -21,18 +21,10 @@ void select_scalar(Array<T> &out, const Array<char> &cond, const Array<T> &a,
 
 template<typename T>
 Array<T> createSelectNode(const Array<char> &cond, const Array<T> &a,
-                          const Array<T> &b, const af::dim4 &odims) {
-    Array<T> out = createEmptyArray<T>(odims);
-    select(out, cond, a, b);
-    return out;
-}
+                          const Array<T> &b, const af::dim4 &odims);
 
 template<typename T, bool flip>
 Array<T> createSelectNode(const Array<char> &cond, const Array<T> &a,
-                          const T &b, const af::dim4 &odims) {
-    Array<T> out = createEmptyArray<T>(odims);
-    select_scalar<T, flip>(out, cond, a, b);
-    return out;
-}
+                          const T &b_val, const af::dim4 &odims);
 }  // namespace cpu
 }  // namespace arrayfire
@@ -8,22 +8,39 @@
  ********************************************************/
 
 #include <Array.hpp>
-#include <kernel/shift.hpp>
-#include <platform.hpp>
-#include <queue.hpp>
+#include <jit/GeneratorNode.hpp>
 #include <shift.hpp>
 
+#include <cassert>
+#include <memory>
+
+using af::dim4;
+using std::make_shared;
+
 namespace arrayfire {
 namespace cpu {
 
 template<typename T>
 Array<T> shift(const Array<T> &in, const int sdims[4]) {
-    Array<T> out = createEmptyArray<T>(in.dims());
-    const af::dim4 temp(sdims[0], sdims[1], sdims[2], sdims[3]);
-
-    getQueue().enqueue(kernel::shift<T>, out, in, temp);
-
-    return out;
+    // The shifted array reads the buffer of its input
+    in.eval();
+
+    const dim4 &iDims = in.dims();
+    dim4 shifts;
+    for (int i = 0; i < 4; i++) {
+        // shifts[i] will always be positive and always [0, iDims[i]].
+        // Negative shifts are converted to position by going the other way
+        // round
+        shifts[i] = -(sdims[i] % static_cast<int>(iDims[i])) +
+                    iDims[i] * (sdims[i] > 0);
+        assert(shifts[i] >= 0 && shifts[i] <= iDims[i]);
+    }
+
+    auto node = make_shared<jit::GeneratorNode<T, jit::ShiftGenerator<T>>>(
+        iDims, shifts);
+    node->setData(in.getData(), in.getDataDims().elements() * sizeof(T),
+                  in.getOffset(), in.strides().get());
+    return createNodeArray<T>(iDims, node);
 }
 
 #define INSTANTIATE(T) \
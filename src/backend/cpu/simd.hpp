@@ -0,0 +1,791 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+/// \file simd.hpp
+///
+/// A minimal wrapper around the vector registers of the instruction set the
+/// cpu backend is compiled for. batch<T> holds batch<T>::size values of type
+/// T and mask<T> holds the result of comparing two batches.
+///
+/// The widest of the following instruction sets enabled by the compiler flags
+/// is used:
+///
+///  - AVX-512F
+///  - AVX2 with FMA
+///  - SSE2 (always available on x86-64)
+///  - NEON on AArch64
+///
+/// AF_CPU_SIMD is defined to 1 when one of them is available. Otherwise
+/// is_vectorized<T> is false for every type and callers keep using their
+/// scalar code paths.
+
+#include <type_traits>
+
+#if defined(__AVX512F__)
+#define AF_CPU_SIMD 1
+#define AF_CPU_SIMD_AVX512 1
+#include <immintrin.h>
+#elif defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define AF_CPU_SIMD 1
+#define AF_CPU_SIMD_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AF_CPU_SIMD 1
+#define AF_CPU_SIMD_SSE2 1
+#include <emmintrin.h>
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define AF_CPU_SIMD 1
+#define AF_CPU_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace arrayfire {
+namespace cpu {
+namespace simd {
+
+/// True if batch<T> and mask<T> are defined for \p T
+template<typename T>
+struct is_vectorized : std::false_type {};
+
+template<typename T>
+struct batch;
+
+template<typename T>
+struct mask;
+
+#if defined(AF_CPU_SIMD)
+template<>
+struct is_vectorized<float> : std::true_type {};
+template<>
+struct is_vectorized<double> : std::true_type {};
+#endif
+
+#if defined(AF_CPU_SIMD_AVX512)
+
+template<>
+struct batch<float> {
+    static constexpr int size = 16;
+    __m512 v;
+    static batch load(const float *p) { return {_mm512_loadu_ps(p)}; }
+    static batch broadcast(float x) { return {_mm512_set1_ps(x)}; }
+    void store(float *p) const { _mm512_storeu_ps(p, v); }
+};
+
+template<>
+struct batch<double> {
+    static constexpr int size = 8;
+    __m512d v;
+    static batch load(const double *p) { return {_mm512_loadu_pd(p)}; }
+    static batch broadcast(double x) { return {_mm512_set1_pd(x)}; }
+    void store(double *p) const { _mm512_storeu_pd(p, v); }
+};
+
+template<>
+struct mask<float> {
+    __mmask16 m;
+};
+
+template<>
+struct mask<double> {
+    __mmask8 m;
+};
+
+inline batch<float> operator+(batch<float> a, batch<float> b) {
+    return {_mm512_add_ps(a.v, b.v)};
+}
+inline batch<float> operator-(batch<float> a, batch<float> b) {
+    return {_mm512_sub_ps(a.v, b.v)};
+}
+inline batch<float> operator*(batch<float> a, batch<float> b) {
+    return {_mm512_mul_ps(a.v, b.v)};
+}
+inline batch<float> operator/(batch<float> a, batch<float> b) {
+    return {_mm512_div_ps(a.v, b.v)};
+}
+inline batch<float> fma(batch<float> a, batch<float> b, batch<float> c) {
+    return {_mm512_fmadd_ps(a.v, b.v, c.v)};
+}
+inline batch<float> min(batch<float> a, batch<float> b) {
+    return {_mm512_min_ps(a.v, b.v)};
+}
+inline batch<float> max(batch<float> a, batch<float> b) {
+    return {_mm512_max_ps(a.v, b.v)};
+}
+inline batch<float> sqrt(batch<float> a) { return {_mm512_sqrt_ps(a.v)}; }
+inline batch<float> round_nearest(batch<float> a) {
+    return {_mm512_roundscale_ps(
+        a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+inline batch<float> bit_and(batch<float> a, batch<float> b) {
+    return {_mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a.v),
+                                                 _mm512_castps_si512(b.v)))};
+}
+inline batch<float> bit_or(batch<float> a, batch<float> b) {
+    return {_mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(a.v),
+                                                _mm512_castps_si512(b.v)))};
+}
+inline batch<float> bit_xor(batch<float> a, batch<float> b) {
+    return {_mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a.v),
+                                                 _mm512_castps_si512(b.v)))};
+}
+template<int S>
+batch<float> shift_left(batch<float> a) {
+    return {_mm512_castsi512_ps(
+        _mm512_slli_epi32(_mm512_castps_si512(a.v), S))};
+}
+template<int S>
+batch<float> shift_right(batch<float> a) {
+    return {_mm512_castsi512_ps(
+        _mm512_srli_epi32(_mm512_castps_si512(a.v), S))};
+}
+inline mask<float> operator<(batch<float> a, batch<float> b) {
+    return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ)};
+}
+inline mask<float> operator<=(batch<float> a, batch<float> b) {
+    return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ)};
+}
+inline mask<float> operator>(batch<float> a, batch<float> b) {
+    return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ)};
+}
+inline mask<float> operator>=(batch<float> a, batch<float> b) {
+    return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_GE_OQ)};
+}
+inline mask<float> operator==(batch<float> a, batch<float> b) {
+    return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_EQ_OQ)};
+}
+inline mask<float> operator!=(batch<float> a, batch<float> b) {
+    return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_NEQ_UQ)};
+}
+inline mask<float> operator|(mask<float> a, mask<float> b) {
+    return {static_cast<__mmask16>(a.m | b.m)};
+}
+inline mask<float> operator&(mask<float> a, mask<float> b) {
+    return {static_cast<__mmask16>(a.m & b.m)};
+}
+inline batch<float> select(mask<float> m, batch<float> a, batch<float> b) {
+    return {_mm512_mask_blend_ps(m.m, b.v, a.v)};
+}
+inline unsigned bitmask(mask<float> m) { return m.m; }
+
+inline batch<double> operator+(batch<double> a, batch<double> b) {
+    return {_mm512_add_pd(a.v, b.v)};
+}
+inline batch<double> operator-(batch<double> a, batch<double> b) {
+    return {_mm512_sub_pd(a.v, b.v)};
+}
+inline batch<double> operator*(batch<double> a, batch<double> b) {
+    return {_mm512_mul_pd(a.v, b.v)};
+}
+inline batch<double> operator/(batch<double> a, batch<double> b) {
+    return {_mm512_div_pd(a.v, b.v)};
+}
+inline batch<double> fma(batch<double> a, batch<double> b, batch<double> c) {
+    return {_mm512_fmadd_pd(a.v, b.v, c.v)};
+}
+inline batch<double> min(batch<double> a, batch<double> b) {
+    return {_mm512_min_pd(a.v, b.v)};
+}
+inline batch<double> max(batch<double> a, batch<double> b) {
+    return {_mm512_max_pd(a.v, b.v)};
+}
+inline batch<double> sqrt(batch<double> a) { return {_mm512_sqrt_pd(a.v)}; }
+inline batch<double> round_nearest(batch<double> a) {
+    return {_mm512_roundscale_pd(
+        a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+inline batch<double> bit_and(batch<double> a, batch<double> b) {
+    return {_mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(a.v),
+                                                 _mm512_castpd_si512(b.v)))};
+}
+inline batch<double> bit_or(batch<double> a, batch<double> b) {
+    return {_mm512_castsi512_pd(_mm512_or_si512(_mm512_castpd_si512(a.v),
+                                                _mm512_castpd_si512(b.v)))};
+}
+inline batch<double> bit_xor(batch<double> a, batch<double> b) {
+    return {_mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a.v),
+                                                 _mm512_castpd_si512(b.v)))};
+}
+template<int S>
+batch<double> shift_left(batch<double> a) {
+    return {_mm512_castsi512_pd(
+        _mm512_slli_epi64(_mm512_castpd_si512(a.v), S))};
+}
+template<int S>
+batch<double> shift_right(batch<double> a) {
+    return {_mm512_castsi512_pd(
+        _mm512_srli_epi64(_mm512_castpd_si512(a.v), S))};
+}
+inline mask<double> operator<(batch<double> a, batch<double> b) {
+    return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ)};
+}
+inline mask<double> operator<=(batch<double> a, batch<double> b) {
+    return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_LE_OQ)};
+}
+inline mask<double> operator>(batch<double> a, batch<double> b) {
+    return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_GT_OQ)};
+}
+inline mask<double> operator>=(batch<double> a, batch<double> b) {
+    return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_GE_OQ)};
+}
+inline mask<double> operator==(batch<double> a, batch<double> b) {
+    return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_EQ_OQ)};
+}
+inline mask<double> operator!=(batch<double> a, batch<double> b) {
+    return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_NEQ_UQ)};
+}
+inline mask<double> operator|(mask<double> a, mask<double> b) {
+    return {static_cast<__mmask8>(a.m | b.m)};
+}
+inline mask<double> operator&(mask<double> a, mask<double> b) {
+    return {static_cast<__mmask8>(a.m & b.m)};
+}
+inline batch<double> select(mask<double> m, batch<double> a, batch<double> b) {
+    return {_mm512_mask_blend_pd(m.m, b.v, a.v)};
+}
+inline unsigned bitmask(mask<double> m) { return m.m; }
+
+#elif defined(AF_CPU_SIMD_AVX2) || defined(AF_CPU_SIMD_SSE2)
+
+#if defined(AF_CPU_SIMD_AVX2)
+template<>
+struct batch<float> {
+    static constexpr int size = 8;
+    __m256 v;
+    static batch load(const float *p) { return {_mm256_loadu_ps(p)}; }
+    static batch broadcast(float x) { return {_mm256_set1_ps(x)}; }
+    void store(float *p) const { _mm256_storeu_ps(p, v); }
+};
+
+template<>
+struct batch<double> {
+    static constexpr int size = 4;
+    __m256d v;
+    static batch load(const double *p) { return {_mm256_loadu_pd(p)}; }
+    static batch broadcast(double x) { return {_mm256_set1_pd(x)}; }
+    void store(double *p) const { _mm256_storeu_pd(p, v); }
+};
+
+template<>
+struct mask<float> {
+    __m256 m;
+};
+
+template<>
+struct mask<double> {
+    __m256d m;
+};
+
+inline batch<float> fma(batch<float> a, batch<float> b, batch<float> c) {
+    return {_mm256_fmadd_ps(a.v, b.v, c.v)};
+}
+inline batch<float> round_nearest(batch<float> a) {
+    return {_mm256_round_ps(a.v,
+                            _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+template<int S>
+batch<float> shift_left(batch<float> a) {
+    return {_mm256_castsi256_ps(
+        _mm256_slli_epi32(_mm256_castps_si256(a.v), S))};
+}
+template<int S>
+batch<float> shift_right(batch<float> a) {
+    return {_mm256_castsi256_ps(
+        _mm256_srli_epi32(_mm256_castps_si256(a.v), S))};
+}
+inline mask<float> operator<(batch<float> a, batch<float> b) {
+    return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)};
+}
+inline mask<float> operator<=(batch<float> a, batch<float> b) {
+    return {_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)};
+}
+inline mask<float> operator>(batch<float> a, batch<float> b) {
+    return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)};
+}
+inline mask<float> operator>=(batch<float> a, batch<float> b) {
+    return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)};
+}
+inline mask<float> operator==(batch<float> a, batch<float> b) {
+    return {_mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ)};
+}
+inline mask<float> operator!=(batch<float> a, batch<float> b) {
+    return {_mm256_cmp_ps(a.v, b.v, _CMP_NEQ_UQ)};
+}
+
+inline batch<double> fma(batch<double> a, batch<double> b, batch<double> c) {
+    return {_mm256_fmadd_pd(a.v, b.v, c.v)};
+}
+inline batch<double> round_nearest(batch<double> a) {
+    return {_mm256_round_pd(a.v,
+                            _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+template<int S>
+batch<double> shift_left(batch<double> a) {
+    return {_mm256_castsi256_pd(
+        _mm256_slli_epi64(_mm256_castpd_si256(a.v), S))};
+}
+template<int S>
+batch<double> shift_right(batch<double> a) {
+    return {_mm256_castsi256_pd(
+        _mm256_srli_epi64(_mm256_castpd_si256(a.v), S))};
+}
+inline mask<double> operator<(batch<double> a, batch<double> b) {
+    return {_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ)};
+}
+inline mask<double> operator<=(batch<double> a, batch<double> b) {
+    return {_mm256_cmp_pd(a.v, b.v, _CMP_LE_OQ)};
+}
+inline mask<double> operator>(batch<double> a, batch<double> b) {
+    return {_mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ)};
+}
+inline mask<double> operator>=(batch<double> a, batch<double> b) {
+    return {_mm256_cmp_pd(a.v, b.v, _CMP_GE_OQ)};
+}
+inline mask<double> operator==(batch<double> a, batch<double> b) {
+    return {_mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ)};
+}
+inline mask<double> operator!=(batch<double> a, batch<double> b) {
+    return {_mm256_cmp_pd(a.v, b.v, _CMP_NEQ_UQ)};
+}
+
+#define AF_SIMD_X86(X) _mm256_##X
+#else
+template<>
+struct batch<float> {
+    static constexpr int size = 4;
+    __m128 v;
+    static batch load(const float *p) { return {_mm_loadu_ps(p)}; }
+    static batch broadcast(float x) { return {_mm_set1_ps(x)}; }
+    void store(float *p) const { _mm_storeu_ps(p, v); }
+};
+
+template<>
+struct batch<double> {
+    static constexpr int size = 2;
+    __m128d v;
+    static batch load(const double *p) { return {_mm_loadu_pd(p)}; }
+    static batch broadcast(double x) { return {_mm_set1_pd(x)}; }
+    void store(double *p) const { _mm_storeu_pd(p, v); }
+};
+
+template<>
+struct mask<float> {
+    __m128 m;
+};
+
+template<>
+struct mask<double> {
+    __m128d m;
+};
+
+inline batch<float> fma(batch<float> a, batch<float> b, batch<float> c) {
+    return {_mm_add_ps(_mm_mul_ps(a.v, b.v), c.v)};
+}
+template<int S>
+batch<float> shift_left(batch<float> a) {
+    return {_mm_castsi128_ps(_mm_slli_epi32(_mm_castps_si128(a.v), S))};
+}
+template<int S>
+batch<float> shift_right(batch<float> a) {
+    return {_mm_castsi128_ps(_mm_srli_epi32(_mm_castps_si128(a.v), S))};
+}
+inline mask<float> operator<(batch<float> a, batch<float> b) {
+    return {_mm_cmplt_ps(a.v, b.v)};
+}
+inline mask<float> operator<=(batch<float> a, batch<float> b) {
+    return {_mm_cmple_ps(a.v, b.v)};
+}
+inline mask<float> operator>(batch<float> a, batch<float> b) {
+    return {_mm_cmpgt_ps(a.v, b.v)};
+}
+inline mask<float> operator>=(batch<float> a, batch<float> b) {
+    return {_mm_cmpge_ps(a.v, b.v)};
+}
+inline mask<float> operator==(batch<float> a, batch<float> b) {
+    return {_mm_cmpeq_ps(a.v, b.v)};
+}
+inline mask<float> operator!=(batch<float> a, batch<float> b) {
+    return {_mm_cmpneq_ps(a.v, b.v)};
+}
+
+inline batch<double> fma(batch<double> a, batch<double> b, batch<double> c) {
+    return {_mm_add_pd(_mm_mul_pd(a.v, b.v), c.v)};
+}
+template<int S>
+batch<double> shift_left(batch<double> a) {
+    return {_mm_castsi128_pd(_mm_slli_epi64(_mm_castpd_si128(a.v), S))};
+}
+template<int S>
+batch<double> shift_right(batch<double> a) {
+    return {_mm_castsi128_pd(_mm_srli_epi64(_mm_castpd_si128(a.v), S))};
+}
+inline mask<double> operator<(batch<double> a, batch<double> b) {
+    return {_mm_cmplt_pd(a.v, b.v)};
+}
+inline mask<double> operator<=(batch<double> a, batch<double> b) {
+    return {_mm_cmple_pd(a.v, b.v)};
+}
+inline mask<double> operator>(batch<double> a, batch<double> b) {
+    return {_mm_cmpgt_pd(a.v, b.v)};
+}
+inline mask<double> operator>=(batch<double> a, batch<double> b) {
+    return {_mm_cmpge_pd(a.v, b.v)};
+}
+inline mask<double> operator==(batch<double> a, batch<double> b) {
+    return {_mm_cmpeq_pd(a.v, b.v)};
+}
+inline mask<double> operator!=(batch<double> a, batch<double> b) {
+    return {_mm_cmpneq_pd(a.v, b.v)};
+}
+
+#if defined(__SSE4_1__)
+inline batch<float> round_nearest(batch<float> a) {
+    return {_mm_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+inline batch<double> round_nearest(batch<double> a) {
+    return {_mm_round_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+#else
+// Adding and subtracting 1.5 * 2^(mantissa bits) rounds to the nearest
+// integer for all the values used by the math functions
+inline batch<float> round_nearest(batch<float> a) {
+    const __m128 magic = _mm_set1_ps(12582912.0f);
+    return {_mm_sub_ps(_mm_add_ps(a.v, magic), magic)};
+}
+inline batch<double> round_nearest(batch<double> a) {
+    const __m128d magic = _mm_set1_pd(6755399441055744.0);
+    return {_mm_sub_pd(_mm_add_pd(a.v, magic), magic)};
+}
+#endif
+
+#define AF_SIMD_X86(X) _mm_##X
+#endif
+
+// The operations which only differ by the width of the registers between
+// SSE2 and AVX2
+inline batch<float> operator+(batch<float> a, batch<float> b) {
+    return {AF_SIMD_X86(add_ps)(a.v, b.v)};
+}
+inline batch<float> operator-(batch<float> a, batch<float> b) {
+    return {AF_SIMD_X86(sub_ps)(a.v, b.v)};
+}
+inline batch<float> operator*(batch<float> a, batch<float> b) {
+    return {AF_SIMD_X86(mul_ps)(a.v, b.v)};
+}
+inline batch<float> operator/(batch<float> a, batch<float> b) {
+    return {AF_SIMD_X86(div_ps)(a.v, b.v)};
+}
+inline batch<float> min(batch<float> a, batch<float> b) {
+    return {AF_SIMD_X86(min_ps)(a.v, b.v)};
+}
+inline batch<float> max(batch<float> a, batch<float> b) {
+    return {AF_SIMD_X86(max_ps)(a.v, b.v)};
+}
+inline batch<float> sqrt(batch<float> a) { return {AF_SIMD_X86(sqrt_ps)(a.v)}; }
+inline batch<float> bit_and(batch<float> a, batch<float> b) {
+    return {AF_SIMD_X86(and_ps)(a.v, b.v)};
+}
+inline batch<float> bit_or(batch<float> a, batch<float> b) {
+    return {AF_SIMD_X86(or_ps)(a.v, b.v)};
+}
+inline batch<float> bit_xor(batch<float> a, batch<float> b) {
+    return {AF_SIMD_X86(xor_ps)(a.v, b.v)};
+}
+inline mask<float> operator|(mask<float> a, mask<float> b) {
+    return {AF_SIMD_X86(or_ps)(a.m, b.m)};
+}
+inline mask<float> operator&(mask<float> a, mask<float> b) {
+    return {AF_SIMD_X86(and_ps)(a.m, b.m)};
+}
+inline batch<float> select(mask<float> m, batch<float> a, batch<float> b) {
+    return {AF_SIMD_X86(or_ps)(AF_SIMD_X86(and_ps)(m.m, a.v),
+                               AF_SIMD_X86(andnot_ps)(m.m, b.v))};
+}
+inline unsigned bitmask(mask<float> m) {
+    return static_cast<unsigned>(AF_SIMD_X86(movemask_ps)(m.m));
+}
+
+inline batch<double> operator+(batch<double> a, batch<double> b) {
+    return {AF_SIMD_X86(add_pd)(a.v, b.v)};
+}
+inline batch<double> operator-(batch<double> a, batch<double> b) {
+    return {AF_SIMD_X86(sub_pd)(a.v, b.v)};
+}
+inline batch<double> operator*(batch<double> a, batch<double> b) {
+    return {AF_SIMD_X86(mul_pd)(a.v, b.v)};
+}
+inline batch<double> operator/(batch<double> a, batch<double> b) {
+    return {AF_SIMD_X86(div_pd)(a.v, b.v)};
+}
+inline batch<double> min(batch<double> a, batch<double> b) {
+    return {AF_SIMD_X86(min_pd)(a.v, b.v)};
+}
+inline batch<double> max(batch<double> a, batch<double> b) {
+    return {AF_SIMD_X86(max_pd)(a.v, b.v)};
+}
+inline batch<double> sqrt(batch<double> a) {
+    return {AF_SIMD_X86(sqrt_pd)(a.v)};
+}
+inline batch<double> bit_and(batch<double> a, batch<double> b) {
+    return {AF_SIMD_X86(and_pd)(a.v, b.v)};
+}
+inline batch<double> bit_or(batch<double> a, batch<double> b) {
+    return {AF_SIMD_X86(or_pd)(a.v, b.v)};
+}
+inline batch<double> bit_xor(batch<double> a, batch<double> b) {
+    return {AF_SIMD_X86(xor_pd)(a.v, b.v)};
+}
+inline mask<double> operator|(mask<double> a, mask<double> b) {
+    return {AF_SIMD_X86(or_pd)(a.m, b.m)};
+}
+inline mask<double> operator&(mask<double> a, mask<double> b) {
+    return {AF_SIMD_X86(and_pd)(a.m, b.m)};
+}
+inline batch<double> select(mask<double> m, batch<double> a, batch<double> b) {
+    return {AF_SIMD_X86(or_pd)(AF_SIMD_X86(and_pd)(m.m, a.v),
+                               AF_SIMD_X86(andnot_pd)(m.m, b.v))};
+}
+inline unsigned bitmask(mask<double> m) {
+    return static_cast<unsigned>(AF_SIMD_X86(movemask_pd)(m.m));
+}
+
+#undef AF_SIMD_X86
+
+#elif defined(AF_CPU_SIMD_NEON)
+
+template<>
+struct batch<float> {
+    static constexpr int size = 4;
+    float32x4_t v;
+    static batch load(const float *p) { return {vld1q_f32(p)}; }
+    static batch broadcast(float x) { return {vdupq_n_f32(x)}; }
+    void store(float *p) const { vst1q_f32(p, v); }
+};
+
+template<>
+struct batch<double> {
+    static constexpr int size = 2;
+    float64x2_t v;
+    static batch load(const double *p) { return {vld1q_f64(p)}; }
+    static batch broadcast(double x) { return {vdupq_n_f64(x)}; }
+    void store(double *p) const { vst1q_f64(p, v); }
+};
+
+template<>
+struct mask<float> {
+    uint32x4_t m;
+};
+
+template<>
+struct mask<double> {
+    uint64x2_t m;
+};
+
+inline batch<float> operator+(batch<float> a, batch<float> b) {
+    return {vaddq_f32(a.v, b.v)};
+}
+inline batch<float> operator-(batch<float> a, batch<float> b) {
+    return {vsubq_f32(a.v, b.v)};
+}
+inline batch<float> operator*(batch<float> a, batch<float> b) {
+    return {vmulq_f32(a.v, b.v)};
+}
+inline batch<float> operator/(batch<float> a, batch<float> b) {
+    return {vdivq_f32(a.v, b.v)};
+}
+inline batch<float> fma(batch<float> a, batch<float> b, batch<float> c) {
+    return {vfmaq_f32(c.v, a.v, b.v)};
+}
+inline batch<float> min(batch<float> a, batch<float> b) {
+    return {vminq_f32(a.v, b.v)};
+}
+inline batch<float> max(batch<float> a, batch<float> b) {
+    return {vmaxq_f32(a.v, b.v)};
+}
+inline batch<float> sqrt(batch<float> a) { return {vsqrtq_f32(a.v)}; }
+inline batch<float> round_nearest(batch<float> a) { return {vrndnq_f32(a.v)}; }
+inline batch<float> bit_and(batch<float> a, batch<float> b) {
+    return {vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a.v),
+                                            vreinterpretq_u32_f32(b.v)))};
+}
+inline batch<float> bit_or(batch<float> a, batch<float> b) {
+    return {vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a.v),
+                                            vreinterpretq_u32_f32(b.v)))};
+}
+inline batch<float> bit_xor(batch<float> a, batch<float> b) {
+    return {vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a.v),
+                                            vreinterpretq_u32_f32(b.v)))};
+}
+template<int S>
+batch<float> shift_left(batch<float> a) {
+    return {vreinterpretq_f32_u32(vshlq_n_u32(vreinterpretq_u32_f32(a.v), S))};
+}
+template<int S>
+batch<float> shift_right(batch<float> a) {
+    return {vreinterpretq_f32_u32(vshrq_n_u32(vreinterpretq_u32_f32(a.v), S))};
+}
+inline mask<float> operator<(batch<float> a, batch<float> b) {
+    return {vcltq_f32(a.v, b.v)};
+}
+inline mask<float> operator<=(batch<float> a, batch<float> b) {
+    return {vcleq_f32(a.v, b.v)};
+}
+inline mask<float> operator>(batch<float> a, batch<float> b) {
+    return {vcgtq_f32(a.v, b.v)};
+}
+inline mask<float> operator>=(batch<float> a, batch<float> b) {
+    return {vcgeq_f32(a.v, b.v)};
+}
+inline mask<float> operator==(batch<float> a, batch<float> b) {
+    return {vceqq_f32(a.v, b.v)};
+}
+inline mask<float> operator!=(batch<float> a, batch<float> b) {
+    return {vmvnq_u32(vceqq_f32(a.v, b.v))};
+}
+inline mask<float> operator|(mask<float> a, mask<float> b) {
+    return {vorrq_u32(a.m, b.m)};
+}
+inline mask<float> operator&(mask<float> a, mask<float> b) {
+    return {vandq_u32(a.m, b.m)};
+}
+inline batch<float> select(mask<float> m, batch<float> a, batch<float> b) {
+    return {vbslq_f32(m.m, a.v, b.v)};
+}
+
+inline batch<double> operator+(batch<double> a, batch<double> b) {
+    return {vaddq_f64(a.v, b.v)};
+}
+inline batch<double> operator-(batch<double> a, batch<double> b) {
+    return {vsubq_f64(a.v, b.v)};
+}
+inline batch<double> operator*(batch<double> a, batch<double> b) {
+    return {vmulq_f64(a.v, b.v)};
+}
+inline batch<double> operator/(batch<double> a, batch<double> b) {
+    return {vdivq_f64(a.v, b.v)};
+}
+inline batch<double> fma(batch<double> a, batch<double> b, batch<double> c) {
+    return {vfmaq_f64(c.v, a.v, b.v)};
+}
+inline batch<double> min(batch<double> a, batch<double> b) {
+    return {vminq_f64(a.v, b.v)};
+}
+inline batch<double> max(batch<double> a, batch<double> b) {
+    return {vmaxq_f64(a.v, b.v)};
+}
+inline batch<double> sqrt(batch<double> a) { return {vsqrtq_f64(a.v)}; }
+inline batch<double> round_nearest(batch<double> a) {
+    return {vrndnq_f64(a.v)};
+}
+inline batch<double> bit_and(batch<double> a, batch<double> b) {
+    return {vreinterpretq_f64_u64(vandq_u64(vreinterpretq_u64_f64(a.v),
+                                            vreinterpretq_u64_f64(b.v)))};
+}
+inline batch<double> bit_or(batch<double> a, batch<double> b) {
+    return {vreinterpretq_f64_u64(vorrq_u64(vreinterpretq_u64_f64(a.v),
+                                            vreinterpretq_u64_f64(b.v)))};
+}
+inline batch<double> bit_xor(batch<double> a, batch<double> b) {
+    return {vreinterpretq_f64_u64(veorq_u64(vreinterpretq_u64_f64(a.v),
+                                            vreinterpretq_u64_f64(b.v)))};
+}
+template<int S>
+batch<double> shift_left(batch<double> a) {
+    return {vreinterpretq_f64_u64(vshlq_n_u64(vreinterpretq_u64_f64(a.v), S))};
+}
+template<int S>
+batch<double> shift_right(batch<double> a) {
+    return {vreinterpretq_f64_u64(vshrq_n_u64(vreinterpretq_u64_f64(a.v), S))};
+}
+inline mask<double> operator<(batch<double> a, batch<double> b) {
+    return {vcltq_f64(a.v, b.v)};
+}
+inline mask<double> operator<=(batch<double> a, batch<double> b) {
+    return {vcleq_f64(a.v, b.v)};
+}
+inline mask<double> operator>(batch<double> a, batch<double> b) {
+    return {vcgtq_f64(a.v, b.v)};
+}
+inline mask<double> operator>=(batch<double> a, batch<double> b) {
+    return {vcgeq_f64(a.v, b.v)};
+}
+inline mask<double> operator==(batch<double> a, batch<double> b) {
+    return {vceqq_f64(a.v, b.v)};
+}
+inline mask<double> operator!=(batch<double> a, batch<double> b) {
+    return {vreinterpretq_u64_u32(
+        vmvnq_u32(vreinterpretq_u32_u64(vceqq_f64(a.v, b.v))))};
+}
+inline mask<double> operator|(mask<double> a, mask<double> b) {
+    return {vorrq_u64(a.m, b.m)};
+}
+inline mask<double> operator&(mask<double> a, mask<double> b) {
+    return {vandq_u64(a.m, b.m)};
+}
+inline batch<double> select(mask<double> m, batch<double> a, batch<double> b) {
+    return {vbslq_f64(m.m, a.v, b.v)};
+}
+
+inline unsigned bitmask(mask<float> m) {
+    const uint32x4_t bits = {1, 2, 4, 8};
+    return vaddvq_u32(vandq_u32(m.m, bits));
+}
+
+inline unsigned bitmask(mask<double> m) {
+    const uint64x2_t bits = {1, 2};
+    return static_cast<unsigned>(vaddvq_u64(vandq_u64(m.m, bits)));
+}
+
+#endif
+
+#if defined(AF_CPU_SIMD)
+
+/// Returns true if any lane of \p m is set
+template<typename T>
+bool any(mask<T> m) {
+    return bitmask(m) != 0;
+}
+
+template<typename T>
+batch<T> operator-(batch<T> a) {
+    return bit_xor(a, batch<T>::broadcast(T(-0.0)));
+}
+
+template<typename T>
+batch<T> abs(batch<T> a) {
+    return bit_xor(a, bit_and(a, batch<T>::broadcast(T(-0.0))));
+}
+
+/// Returns true for the lanes of \p a which are NaN
+template<typename T>
+mask<T> is_nan(batch<T> a) {
+    return a != a;
+}
+
+#else
+
+// Only declared so that the vectorized code paths, which are discarded when
+// is_vectorized<T> is false, can refer to them
+template<typename T>
+batch<T> sqrt(batch<T> a);
+template<int S, typename T>
+batch<T> shift_left(batch<T> a);
+template<int S, typename T>
+batch<T> shift_right(batch<T> a);
+
+#endif
+
+}  // namespace simd
+}  // namespace cpu
+}  // namespace arrayfire
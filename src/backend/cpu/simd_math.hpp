@@ -0,0 +1,379 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <simd.hpp>
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+/// \file simd_math.hpp
+///
+/// Vectorized versions of the math functions used by the JIT evaluators. They
+/// are built only from the operations of simd.hpp so they work on all the
+/// supported instruction sets. The results are within a few ulp of the ones
+/// of the standard library. Values outside of the range handled by the
+/// polynomial approximations fall back to the standard library.
+
+namespace arrayfire {
+namespace cpu {
+namespace simd {
+
+template<typename T>
+struct float_traits;
+
+template<>
+struct float_traits<float> {
+    static constexpr int mantissa_bits = 23;
+    static constexpr int exponent_bits = 8;
+    static constexpr float bias        = 127.0f;
+    static constexpr float min_normal  = 1.17549435e-38f;
+
+    // log(FLT_MAX) and the log of the smallest denormal
+    static constexpr float exp_max = 88.7228393f;
+    static constexpr float exp_min = -103.972084f;
+    static constexpr int exp_degree = 7;
+
+    // ln(2) split so that k * ln2_hi is exact
+    static constexpr float ln2_hi = 0.693359375f;
+    static constexpr float ln2_lo = -2.12194440e-4f;
+    static constexpr int log_terms = 5;
+
+    // pi / 2 split so that the first two products are exact
+    static constexpr float pio2_1   = 1.5703125f;
+    static constexpr float pio2_2   = 4.837512969970703125e-4f;
+    static constexpr float pio2_3   = 7.54978995489188216e-8f;
+    static constexpr float trig_max = 8192.0f;
+    static constexpr int sin_terms  = 5;
+    static constexpr int cos_terms  = 6;
+};
+
+template<>
+struct float_traits<double> {
+    static constexpr int mantissa_bits = 52;
+    static constexpr int exponent_bits = 11;
+    static constexpr double bias       = 1023.0;
+    static constexpr double min_normal = 2.2250738585072014e-308;
+
+    static constexpr double exp_max = 709.782712893384;
+    static constexpr double exp_min = -745.1332191019412;
+    static constexpr int exp_degree = 13;
+
+    static constexpr double ln2_hi = 6.93147180369123816490e-01;
+    static constexpr double ln2_lo = 1.90821492927058770002e-10;
+    static constexpr int log_terms = 10;
+
+    static constexpr double pio2_1   = 1.57079632673412561417e+00;
+    static constexpr double pio2_2   = 6.07710050630396597660e-11;
+    static constexpr double pio2_3   = 2.02226624879595063154e-21;
+    static constexpr double trig_max = 65536.0;
+    static constexpr int sin_terms   = 9;
+    static constexpr int cos_terms   = 10;
+};
+
+/// Replaces the lanes of \p res selected by \p m with \p fn applied to the
+/// matching lanes of \p x
+template<typename T, typename F>
+batch<T> fix_lanes(batch<T> res, batch<T> x, mask<T> m, F fn) {
+    unsigned bits = bitmask(m);
+    if (bits == 0) { return res; }
+    T xs[batch<T>::size];
+    T rs[batch<T>::size];
+    x.store(xs);
+    res.store(rs);
+    for (int i = 0; i < batch<T>::size; i++) {
+        if ((bits >> i) & 1) { rs[i] = fn(xs[i]); }
+    }
+    return batch<T>::load(rs);
+}
+
+/// Returns 2^k for integral valued \p k in the normal exponent range
+template<typename T>
+batch<T> pow2(batch<T> k) {
+    using B = batch<T>;
+    using F = float_traits<T>;
+    // The mantissa of k + 2^mantissa_bits + bias holds the biased exponent
+    const T magic = std::ldexp(T(1), F::mantissa_bits) + F::bias;
+    return shift_left<F::mantissa_bits>(k + B::broadcast(magic));
+}
+
+template<typename T>
+batch<T> exp(batch<T> x) {
+    using B = batch<T>;
+    using F = float_traits<T>;
+
+    B xc = min(max(x, B::broadcast(F::exp_min)), B::broadcast(F::exp_max));
+
+    // exp(x) = 2^k * exp(r) with |r| <= ln(2) / 2
+    B k = round_nearest(xc * B::broadcast(T(1.44269504088896340736)));
+    B r = fma(k, B::broadcast(-F::ln2_hi), xc);
+    r   = fma(k, B::broadcast(-F::ln2_lo), r);
+
+    // Taylor series of exp(r)
+    T coeff = T(1);
+    for (int i = 2; i <= F::exp_degree; i++) { coeff /= T(i); }
+    B p = B::broadcast(coeff);
+    for (int i = F::exp_degree; i > 0; i--) {
+        coeff *= T(i);
+        p = fma(p, r, B::broadcast(coeff));
+    }
+
+    // 2^k is applied in two steps so that denormal results and k one past
+    // the largest exponent are handled
+    B k1  = round_nearest(k * B::broadcast(T(0.5)));
+    B res = p * pow2(k1) * pow2(k - k1);
+
+    res = select(x > B::broadcast(F::exp_max),
+                 B::broadcast(std::numeric_limits<T>::infinity()), res);
+    res = select(x < B::broadcast(F::exp_min), B::broadcast(T(0)), res);
+    return select(is_nan(x), x, res);
+}
+
+/// Returns the exponent \p e and the mantissa \p m in [sqrt(0.5), sqrt(2)) of
+/// the positive values of \p x so that x = m * 2^e
+template<typename T>
+void frexp_sqrt2(batch<T> x, batch<T> &m, batch<T> &e) {
+    using B = batch<T>;
+    using F = float_traits<T>;
+
+    // Scale denormals into the normal range
+    const T scale = std::ldexp(T(1), F::mantissa_bits);
+    mask<T> tiny  = x < B::broadcast(F::min_normal);
+    B xs          = select(tiny, x * B::broadcast(scale), x);
+    B bias = select(tiny, B::broadcast(F::bias + F::mantissa_bits),
+                    B::broadcast(F::bias));
+
+    // The biased exponent is converted to a floating point value by placing
+    // it in the mantissa of 2^mantissa_bits
+    B ebits = shift_right<F::mantissa_bits>(xs);
+    e       = bit_or(ebits, B::broadcast(scale)) - B::broadcast(scale) - bias;
+
+    constexpr int exp_sign_bits = F::exponent_bits + 1;
+    m = shift_right<exp_sign_bits>(shift_left<exp_sign_bits>(xs));
+    m = bit_or(m, B::broadcast(T(1)));
+
+    mask<T> big = m > B::broadcast(T(1.41421356237309504880));
+    m           = select(big, m * B::broadcast(T(0.5)), m);
+    e           = select(big, e + B::broadcast(T(1)), e);
+}
+
+/// Returns log(m) for m in [sqrt(0.5), sqrt(2))
+template<typename T>
+batch<T> log_mantissa(batch<T> m) {
+    using B = batch<T>;
+    using F = float_traits<T>;
+
+    // log(m) = 2 * atanh(s) with s = (m - 1) / (m + 1)
+    B f  = m - B::broadcast(T(1));
+    B s  = f / (f + B::broadcast(T(2)));
+    B s2 = s * s;
+    B p  = B::broadcast(T(1) / T(2 * F::log_terms - 1));
+    for (int i = F::log_terms - 2; i >= 0; i--) {
+        p = fma(p, s2, B::broadcast(T(1) / T(2 * i + 1)));
+    }
+    return (s + s) * p;
+}
+
+/// Returns the result of the logarithm of the special values of \p x. The
+/// other lanes are taken from \p res
+template<typename T>
+batch<T> log_special(batch<T> x, batch<T> res) {
+    using B          = batch<T>;
+    using limits     = std::numeric_limits<T>;
+    const B zero     = B::broadcast(T(0));
+    const B infinity = B::broadcast(limits::infinity());
+    res = select(x < zero, B::broadcast(limits::quiet_NaN()), res);
+    res = select(x == zero, -infinity, res);
+    res = select(x == infinity, infinity, res);
+    return select(is_nan(x), x, res);
+}
+
+template<typename T>
+batch<T> log(batch<T> x) {
+    using B = batch<T>;
+    using F = float_traits<T>;
+    B m, e;
+    frexp_sqrt2(x, m, e);
+    B res = fma(e, B::broadcast(F::ln2_hi),
+                fma(e, B::broadcast(F::ln2_lo), log_mantissa(m)));
+    return log_special(x, res);
+}
+
+template<typename T>
+batch<T> log2(batch<T> x) {
+    using B = batch<T>;
+    B m, e;
+    frexp_sqrt2(x, m, e);
+    // Powers of two have m == 1 so their logarithm is exact
+    B res =
+        fma(log_mantissa(m), B::broadcast(T(1.44269504088896340736)), e);
+    return log_special(x, res);
+}
+
+/// Computes the sine and cosine of \p x for |x| <= float_traits<T>::trig_max
+template<typename T>
+void sincos_reduced(batch<T> x, batch<T> &s, batch<T> &c) {
+    using B = batch<T>;
+    using F = float_traits<T>;
+
+    // x = r + j * pi / 2 with |r| <= pi / 4
+    B j = round_nearest(x * B::broadcast(T(0.63661977236758134308)));
+    B r = fma(j, B::broadcast(-F::pio2_1), x);
+    r   = fma(j, B::broadcast(-F::pio2_2), r);
+    r   = fma(j, B::broadcast(-F::pio2_3), r);
+
+    // Taylor series of sin(r) and cos(r)
+    B r2 = r * r;
+    T sc = T(1);
+    for (int i = 2; i <= 2 * F::sin_terms - 1; i++) { sc /= -T(i); }
+    B sp = B::broadcast(sc);
+    for (int i = F::sin_terms - 1; i > 1; i--) {
+        sc *= -T(2 * i + 1) * T(2 * i);
+        sp = fma(sp, r2, B::broadcast(sc));
+    }
+    sp   = fma(sp * r2, r, r);
+    T cc = T(1);
+    for (int i = 2; i <= 2 * F::cos_terms - 2; i++) { cc /= -T(i); }
+    B cp = B::broadcast(cc);
+    for (int i = F::cos_terms - 1; i > 0; i--) {
+        cc *= -T(2 * i) * T(2 * i - 1);
+        cp = fma(cp, r2, B::broadcast(cc));
+    }
+
+    // The quadrant j mod 4 selects which of the two is used and its sign
+    B q = j - B::broadcast(T(4)) *
+                  round_nearest((j - B::broadcast(T(1.5))) *
+                                B::broadcast(T(0.25)));
+    mask<T> q1   = q == B::broadcast(T(1));
+    mask<T> q2   = q == B::broadcast(T(2));
+    mask<T> q3   = q == B::broadcast(T(3));
+    mask<T> swap = q1 | q3;
+    s            = select(swap, cp, sp);
+    s            = select(q2 | q3, -s, s);
+    c            = select(swap, sp, cp);
+    c            = select(q1 | q2, -c, c);
+}
+
+template<typename T>
+batch<T> sin(batch<T> x) {
+    using B = batch<T>;
+    B s, c;
+    sincos_reduced(x, s, c);
+    mask<T> big = abs(x) > B::broadcast(float_traits<T>::trig_max);
+    return fix_lanes(s, x, big, [](T v) { return std::sin(v); });
+}
+
+template<typename T>
+batch<T> cos(batch<T> x) {
+    using B = batch<T>;
+    B s, c;
+    sincos_reduced(x, s, c);
+    mask<T> big = abs(x) > B::broadcast(float_traits<T>::trig_max);
+    return fix_lanes(c, x, big, [](T v) { return std::cos(v); });
+}
+
+template<typename T>
+batch<T> tan(batch<T> x) {
+    using B = batch<T>;
+    B s, c;
+    sincos_reduced(x, s, c);
+    mask<T> big = abs(x) > B::broadcast(float_traits<T>::trig_max);
+    return fix_lanes(s / c, x, big, [](T v) { return std::tan(v); });
+}
+
+template<typename T>
+batch<T> rsqrt(batch<T> x) {
+    return batch<T>::broadcast(T(1)) / sqrt(x);
+}
+
+template<typename T>
+batch<T> sigmoid(batch<T> x) {
+    using B = batch<T>;
+    return B::broadcast(T(1)) / (B::broadcast(T(1)) + exp(-x));
+}
+
+/// True if erf is vectorized for \p T. The approximation below is only
+/// accurate enough for single precision.
+template<typename T>
+struct has_erf
+    : std::integral_constant<bool, is_vectorized<T>::value &&
+                                       std::is_same<T, float>::value> {};
+
+template<typename T>
+batch<T> erf(batch<T> x) {
+    static_assert(std::is_same<T, float>::value,
+                  "erf is only vectorized for float");
+    using B = batch<T>;
+
+    // Taylor series of erf for |x| < 1.5. The coefficient of x^(2n + 1) is
+    // 2 / sqrt(pi) * (-1)^n / (n! * (2n + 1))
+    constexpr int taylor_terms       = 14;
+    constexpr double two_over_sqrtpi = 1.12837916709551257390;
+    B x2     = x * x;
+    double f = 1.0;
+    for (int n = 1; n < taylor_terms; n++) { f *= -n; }
+    B p = B::broadcast(T(two_over_sqrtpi / (f * (2 * taylor_terms - 1))));
+    for (int n = taylor_terms - 2; n >= 0; n--) {
+        f /= -(n + 1);
+        p = fma(p, x2, B::broadcast(T(two_over_sqrtpi / (f * (2 * n + 1)))));
+    }
+    B small = p * x;
+
+    // Continued fraction of erfc for larger values
+    constexpr int fraction_terms = 16;
+    B ax = abs(x);
+    B t  = ax;
+    for (int k = fraction_terms; k > 0; k--) {
+        t = ax + B::broadcast(T(0.5) * T(k)) / t;
+    }
+    B erfc  = exp(-x2) / (t * B::broadcast(T(1.77245385090551602730)));
+    B large = B::broadcast(T(1)) - erfc;
+    large   = bit_or(large, bit_and(x, B::broadcast(T(-0.0))));
+
+    return select(ax < B::broadcast(T(1.5)), small, large);
+}
+
+/// Applies \p fn to the first \p lim values of \p in and stores the results
+/// in \p out. Both arrays must be padded to a multiple of batch<T>::size.
+template<typename T, typename F>
+void apply(T *out, const T *in, int lim, F fn) {
+    using B = batch<T>;
+    for (int i = 0; i < lim; i += B::size) {
+        fn(B::load(in + i)).store(out + i);
+    }
+}
+
+/// Applies \p fn to the first \p lim values of \p lhs and \p rhs and stores
+/// the results in \p out. The arrays must be padded to a multiple of
+/// batch<T>::size.
+template<typename T, typename F>
+void apply(T *out, const T *lhs, const T *rhs, int lim, F fn) {
+    using B = batch<T>;
+    for (int i = 0; i < lim; i += B::size) {
+        fn(B::load(lhs + i), B::load(rhs + i)).store(out + i);
+    }
+}
+
+/// Stores 1 in \p out where the comparison \p fn of \p lhs and \p rhs is true
+/// and 0 otherwise. The arrays must be padded to a multiple of
+/// batch<T>::size.
+template<typename T, typename F>
+void compare(char *out, const T *lhs, const T *rhs, int lim, F fn) {
+    using B = batch<T>;
+    for (int i = 0; i < lim; i += B::size) {
+        unsigned bits = bitmask(fn(B::load(lhs + i), B::load(rhs + i)));
+        for (int j = 0; j < B::size; j++) { out[i + j] = (bits >> j) & 1; }
+    }
+}
+
+}  // namespace simd
+}  // namespace cpu
+}  // namespace arrayfire
@@ -0,0 +1,256 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <task_scheduler.hpp>
+
+#include <common/util.hpp>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+using std::exception_ptr;
+using std::lock_guard;
+using std::mutex;
+using std::string;
+using std::unique_lock;
+using std::unique_ptr;
+using std::vector;
+
+namespace arrayfire {
+namespace cpu {
+
+namespace {
+
+/// The scheduler owning the calling thread if it is a worker
+thread_local TaskScheduler *current_scheduler = nullptr;
+
+int getEnvVarAtLeast(const char *name, int min_value, int default_value) {
+    const string value = common::getEnvVar(name);
+    if (!value.empty()) {
+        try {
+            const int parsed = std::stoi(value);
+            if (parsed >= min_value) { return parsed; }
+        } catch (...) {}
+    }
+    return default_value;
+}
+
+}  // namespace
+
+TaskScheduler::TaskScheduler(int num_workers, int max_pending)
+    : max_pending(std::max(1, max_pending)) {
+    num_workers = std::max(1, num_workers);
+    workers.reserve(num_workers);
+    for (int i = 0; i < num_workers; i++) {
+        workers.emplace_back(&TaskScheduler::workerLoop, this);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        unique_lock<mutex> lock(state_mutex);
+        done_cv.wait(lock, [this] { return idle(); });
+        stop = true;
+    }
+    ready_cv.notify_all();
+    for (std::thread &worker : workers) { worker.join(); }
+}
+
+bool TaskScheduler::conflicts(const Node &a, const Node &b) noexcept {
+    if (a.barrier || b.barrier) { return true; }
+    for (const MemoryAccess &x : a.accesses) {
+        for (const MemoryAccess &y : b.accesses) {
+            if ((x.write || y.write) && x.begin < y.end && y.begin < x.end) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::enqueue(Task task, vector<MemoryAccess> accesses,
+                            bool barrier) {
+    // A single worker keeps the order of an in-order queue, which the tasks
+    // reading memory their arguments do not describe rely on
+    auto node      = std::make_unique<Node>();
+    node->task     = std::move(task);
+    node->accesses = std::move(accesses);
+    node->barrier  = barrier || workers.size() == 1;
+
+    // The workers cannot wait for the tasks to complete as they may be the
+    // ones running them
+    const bool can_block = !is_worker();
+    bool is_ready        = false;
+    {
+        unique_lock<mutex> lock(state_mutex);
+        done_cv.wait(lock, [this, can_block] {
+            return !can_block ||
+                   static_cast<int>(pending.size()) < max_pending;
+        });
+
+        // A task only needs to wait for the last barrier and the tasks
+        // enqueued after it. The earlier tasks complete before the barrier.
+        auto first = pending.begin();
+        for (auto it = pending.begin(); it != pending.end(); ++it) {
+            if ((*it)->barrier) { first = it; }
+        }
+        for (auto it = first; it != pending.end(); ++it) {
+            if (conflicts(**it, *node)) {
+                (*it)->dependents.push_back(node.get());
+                node->dependencies++;
+            }
+        }
+
+        node->position = ++enqueued;
+        is_ready       = node->dependencies == 0;
+        if (is_ready) { ready.push_back(node.get()); }
+        pending.push_back(std::move(node));
+    }
+    if (is_ready) { ready_cv.notify_one(); }
+}
+
+void TaskScheduler::sync() {
+    unique_lock<mutex> lock(state_mutex);
+    done_cv.wait(lock, [this] { return idle(); });
+    if (error) {
+        exception_ptr err = std::exchange(error, nullptr);
+        std::rethrow_exception(err);
+    }
+}
+
+void TaskScheduler::wait() {
+    unique_lock<mutex> lock(state_mutex);
+    done_cv.wait(lock, [this] { return idle(); });
+}
+
+void TaskScheduler::retire(std::function<void()> release) {
+    {
+        lock_guard<mutex> lock(state_mutex);
+        if (!pending.empty()) {
+            retired.emplace_back(enqueued, std::move(release));
+            return;
+        }
+    }
+    release();
+}
+
+void TaskScheduler::releaseRetired(vector<std::function<void()>> &released) {
+    // The tasks complete out of order. Every task enqueued before the oldest
+    // pending one has completed.
+    const std::uint64_t completed =
+        pending.empty() ? enqueued : pending.front()->position - 1;
+    while (!retired.empty() && retired.front().first <= completed) {
+        released.push_back(std::move(retired.front().second));
+        retired.pop_front();
+    }
+}
+
+bool TaskScheduler::is_worker() const noexcept {
+    return current_scheduler == this;
+}
+
+TaskScheduler *TaskScheduler::current() noexcept { return current_scheduler; }
+
+void TaskScheduler::complete(Node *node) {
+    // The node is destroyed outside of the lock because releasing the
+    // buffers captured by the task can call back into the queue
+    unique_ptr<Node> owner;
+    vector<std::function<void()>> retired_fns;
+    int released = 0;
+    {
+        lock_guard<mutex> lock(state_mutex);
+        for (Node *dependent : node->dependents) {
+            if (--dependent->dependencies == 0) {
+                ready.push_back(dependent);
+                released++;
+            }
+        }
+        auto it = std::find_if(pending.begin(), pending.end(),
+                               [node](const unique_ptr<Node> &other) {
+                                   return other.get() == node;
+                               });
+        owner = std::move(*it);
+        pending.erase(it);
+        releaseRetired(retired_fns);
+        if (!retired_fns.empty()) { releasing++; }
+    }
+    for (int i = 0; i < released; i++) { ready_cv.notify_one(); }
+
+    // The retired functions can be slow, such as the calls releasing memory
+    // to the system, and do not hold up the other threads
+    if (!retired_fns.empty()) {
+        for (auto &release : retired_fns) { release(); }
+        lock_guard<mutex> lock(state_mutex);
+        releasing--;
+    }
+    done_cv.notify_all();
+}
+
+TaskScheduler::Node *TaskScheduler::beginInline(
+    vector<MemoryAccess> &accesses) {
+    Node *node = nullptr;
+    {
+        lock_guard<mutex> lock(state_mutex);
+        if (!pending.empty()) { return nullptr; }
+        auto owner      = std::make_unique<Node>();
+        owner->accesses = std::move(accesses);
+        owner->barrier  = false;
+        owner->position = ++enqueued;
+        node            = owner.get();
+        pending.push_back(std::move(owner));
+    }
+
+    // The tasks enqueued by the inline task are part of it like the ones
+    // enqueued by the tasks running on the workers
+    current_scheduler = this;
+    return node;
+}
+
+void TaskScheduler::endInline(Node *node) {
+    current_scheduler = nullptr;
+    complete(node);
+}
+
+void TaskScheduler::workerLoop() {
+    current_scheduler = this;
+    while (true) {
+        Node *node = nullptr;
+        {
+            unique_lock<mutex> lock(state_mutex);
+            ready_cv.wait(lock, [this] { return stop || !ready.empty(); });
+            if (ready.empty()) { return; }
+            node = ready.front();
+            ready.pop_front();
+        }
+
+        try {
+            node->task();
+        } catch (...) {
+            lock_guard<mutex> lock(state_mutex);
+            if (!error) { error = std::current_exception(); }
+        }
+        complete(node);
+    }
+}
+
+int getDefaultQueueThreadCount() {
+    return getEnvVarAtLeast("AF_CPU_QUEUE_THREADS", 1, 1);
+}
+
+int getDefaultQueueDepth() {
+    return getEnvVarAtLeast("AF_CPU_QUEUE_DEPTH", 1, 64);
+}
+
+int getDefaultInlineTaskBytes() {
+    return getEnvVarAtLeast("AF_CPU_INLINE_BYTES", 0, 4096);
+}
+
+}  // namespace cpu
+}  // namespace arrayfire
@@ -0,0 +1,178 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace arrayfire {
+namespace cpu {
+
+/// A range of memory read or written by a task
+struct MemoryAccess {
+    std::uintptr_t begin;
+    std::uintptr_t end;
+    bool write;
+};
+
+/// Executes the tasks of a queue on a small set of worker threads.
+///
+/// Each task describes the memory it reads and writes. A task only starts
+/// once every task enqueued before it which writes memory it accesses, or
+/// which accesses memory it writes, has completed. Tasks without conflicts
+/// run concurrently. Barrier tasks conflict with every other task so they
+/// behave like the tasks of an in-order queue. With a single worker every
+/// task is a barrier and the tasks run in the order they were enqueued.
+///
+/// The number of tasks which have not completed is bounded. Enqueuing a task
+/// blocks the calling thread while the scheduler is full unless the thread is
+/// one of the workers.
+class TaskScheduler {
+   public:
+    using Task = std::function<void()>;
+
+    /// Creates a scheduler executing tasks on \p num_workers threads with at
+    /// most \p max_pending tasks in flight
+    TaskScheduler(int num_workers, int max_pending);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler &)            = delete;
+    TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+    /// Enqueues \p task which accesses the memory ranges \p accesses. The
+    /// task conflicts with every other task if \p barrier is true.
+    void enqueue(Task task, std::vector<MemoryAccess> accesses, bool barrier);
+
+    /// Waits for all the enqueued tasks to complete. The first exception
+    /// thrown by a task since the last call is rethrown here.
+    void sync();
+
+    /// Waits for all the enqueued tasks to complete without rethrowing the
+    /// exceptions of the tasks
+    void wait();
+
+    /// Calls \p release once the tasks enqueued so far have completed. The
+    /// tasks enqueued later are not waited for. \p release is called right
+    /// away if no task is pending.
+    ///
+    /// \p release runs outside of the scheduler lock, on the thread
+    /// completing the last task it waits for, and must not enqueue tasks.
+    /// sync and wait return once it has run.
+    void retire(std::function<void()> release);
+
+    /// Runs \p func on the calling thread if no other task is pending and
+    /// returns true. Returns false without calling \p func otherwise.
+    ///
+    /// \p func behaves like a task accessing \p accesses. The tasks enqueued
+    /// while it runs wait for it when they conflict with it. The ranges are
+    /// moved from \p accesses only if \p func runs. Its exceptions are
+    /// thrown to the caller.
+    template<typename F>
+    bool runInline(std::vector<MemoryAccess> &accesses, F &&func) {
+        Node *node = beginInline(accesses);
+        if (!node) { return false; }
+        try {
+            func();
+        } catch (...) {
+            endInline(node);
+            throw;
+        }
+        endInline(node);
+        return true;
+    }
+
+    /// Returns true if the calling thread is one of the workers
+    bool is_worker() const noexcept;
+
+    /// Returns the scheduler owning the calling thread or nullptr if the
+    /// thread is not a worker
+    static TaskScheduler *current() noexcept;
+
+   private:
+    struct Node {
+        Task task;
+        std::vector<MemoryAccess> accesses;
+        bool barrier;
+        std::uint64_t position = 0;
+        int dependencies       = 0;
+        std::vector<Node *> dependents;
+    };
+
+    static bool conflicts(const Node &a, const Node &b) noexcept;
+
+    void workerLoop();
+    void complete(Node *node);
+    void releaseRetired(std::vector<std::function<void()>> &released);
+
+    /// True once the tasks and the retired functions have all completed.
+    /// Called with the lock held.
+    bool idle() const noexcept { return pending.empty() && releasing == 0; }
+
+    Node *beginInline(std::vector<MemoryAccess> &accesses);
+    void endInline(Node *node);
+
+    std::vector<std::thread> workers;
+    const int max_pending;
+
+    std::mutex state_mutex;
+    std::condition_variable ready_cv;
+    std::condition_variable done_cv;
+
+    /// The tasks which have not completed in the order they were enqueued
+    std::list<std::unique_ptr<Node>> pending;
+
+    /// The tasks whose dependencies have all completed
+    std::list<Node *> ready;
+
+    /// The position of the last task enqueued
+    std::uint64_t enqueued = 0;
+
+    /// The functions passed to retire with the position of the last task
+    /// enqueued before them
+    std::deque<std::pair<std::uint64_t, std::function<void()>>> retired;
+
+    /// The batches of retired functions running outside of the lock
+    int releasing = 0;
+
+    bool stop = false;
+    std::exception_ptr error;
+};
+
+/// Returns the number of threads executing the tasks of a queue
+///
+/// The value is read from the AF_CPU_QUEUE_THREADS environment variable and
+/// defaults to 1. The memory accessed by a task is only deduced from its
+/// Param and CParam arguments, so running tasks concurrently is opt-in.
+int getDefaultQueueThreadCount();
+
+/// Returns the maximum number of tasks in flight on a queue
+///
+/// The value is read from the AF_CPU_QUEUE_DEPTH environment variable and
+/// defaults to 64.
+int getDefaultQueueDepth();
+
+/// Returns the number of bytes below which a task runs on the calling thread
+/// when its queue is idle
+///
+/// The value is read from the AF_CPU_INLINE_BYTES environment variable and
+/// defaults to 4096. Setting it to 0 always runs the tasks on the workers.
+int getDefaultInlineTaskBytes();
+
+}  // namespace cpu
+}  // namespace arrayfire
@@ -0,0 +1,176 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <thread_pool.hpp>
+
+#include <common/util.hpp>
+
+#include <algorithm>
+#include <string>
+
+using arrayfire::common::getEnvVar;
+using std::condition_variable;
+using std::exception_ptr;
+using std::function;
+using std::lock_guard;
+using std::mutex;
+using std::string;
+using std::thread;
+using std::unique_lock;
+
+namespace arrayfire {
+namespace cpu {
+
+namespace {
+/// True on the threads owned by a ThreadPool and on threads executing the
+/// tasks of a ThreadPool::run call
+thread_local bool in_pool_task = false;
+}  // namespace
+
+ThreadPool::ThreadPool(int num_threads)
+    : ranges(new TaskRange[std::max(num_threads, 1)]) {
+    int num_workers = std::max(num_threads, 1) - 1;
+    workers.reserve(num_workers);
+    for (int i = 0; i < num_workers; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i + 1);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(state_mutex);
+        stop = true;
+    }
+    work_cv.notify_all();
+    for (thread &worker : workers) { worker.join(); }
+}
+
+bool ThreadPool::popTask(int slot, int &idx) {
+    TaskRange &range = ranges[slot];
+    lock_guard<mutex> lock(range.mutex);
+    if (range.begin == range.end) { return false; }
+    idx = range.begin++;
+    return true;
+}
+
+bool ThreadPool::stealTasks(int slot) {
+    const int num_slots = size();
+    for (int i = 1; i < num_slots; i++) {
+        TaskRange &victim = ranges[(slot + i) % num_slots];
+        int begin, end;
+        {
+            lock_guard<mutex> lock(victim.mutex);
+            int count = victim.end - victim.begin;
+            if (count == 0) { continue; }
+            end        = victim.end;
+            begin      = victim.end - (count + 1) / 2;
+            victim.end = begin;
+        }
+        TaskRange &own = ranges[slot];
+        lock_guard<mutex> lock(own.mutex);
+        own.begin = begin;
+        own.end   = end;
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::executeTasks(int slot, const function<void(int)> &task) {
+    int idx;
+    while (popTask(slot, idx) || (stealTasks(slot) && popTask(slot, idx))) {
+        try {
+            task(idx);
+        } catch (...) {
+            lock_guard<mutex> lock(state_mutex);
+            if (!error) { error = std::current_exception(); }
+        }
+        if (remaining_tasks.fetch_sub(1) == 1) {
+            lock_guard<mutex> lock(state_mutex);
+            done_cv.notify_all();
+        }
+    }
+}
+
+void ThreadPool::workerLoop(int slot) {
+    in_pool_task  = true;
+    unsigned seen = 0;
+    while (true) {
+        const function<void(int)> *task;
+        {
+            unique_lock<mutex> lock(state_mutex);
+            work_cv.wait(lock, [&] { return stop || generation != seen; });
+            if (stop) { return; }
+            seen = generation;
+            task = current_task;
+            active_workers++;
+        }
+        if (task) { executeTasks(slot, *task); }
+        {
+            lock_guard<mutex> lock(state_mutex);
+            active_workers--;
+        }
+        done_cv.notify_all();
+    }
+}
+
+void ThreadPool::run(int num_tasks, const function<void(int)> &task) {
+    if (num_tasks <= 0) { return; }
+    if (num_tasks == 1 || workers.empty() || in_pool_task) {
+        for (int i = 0; i < num_tasks; i++) { task(i); }
+        return;
+    }
+
+    lock_guard<mutex> serialize(run_mutex);
+    {
+        unique_lock<mutex> lock(state_mutex);
+        // Workers which woke up late for the previous batch may still be
+        // reading its state
+        done_cv.wait(lock, [&] { return active_workers == 0; });
+        const int num_slots = size();
+        for (int s = 0; s < num_slots; s++) {
+            lock_guard<mutex> range_lock(ranges[s].mutex);
+            ranges[s].begin = static_cast<int>(
+                static_cast<long long>(num_tasks) * s / num_slots);
+            ranges[s].end = static_cast<int>(
+                static_cast<long long>(num_tasks) * (s + 1) / num_slots);
+        }
+        current_task    = &task;
+        remaining_tasks = num_tasks;
+        error           = nullptr;
+        generation++;
+    }
+    work_cv.notify_all();
+
+    in_pool_task = true;
+    executeTasks(0, task);
+    in_pool_task = false;
+
+    exception_ptr err;
+    {
+        unique_lock<mutex> lock(state_mutex);
+        done_cv.wait(lock, [&] {
+            return remaining_tasks == 0 && active_workers == 0;
+        });
+        current_task = nullptr;
+        std::swap(err, error);
+    }
+    if (err) { std::rethrow_exception(err); }
+}
+
+int getDefaultThreadCount() {
+    string env_var = getEnvVar("AF_CPU_THREADS");
+    if (!env_var.empty()) {
+        int num_threads = std::stoi(env_var);
+        if (num_threads > 0) { return num_threads; }
+    }
+    return std::max(static_cast<int>(thread::hardware_concurrency()), 1);
+}
+
+}  // namespace cpu
+}  // namespace arrayfire
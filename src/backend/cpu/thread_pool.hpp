@@ -0,0 +1,97 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace arrayfire {
+namespace cpu {
+
+/// A fixed size pool of threads used to split a single kernel across cores.
+///
+/// The pool executes one batch of tasks at a time. The indices of a batch are
+/// split into contiguous ranges, one for each thread. A thread executes the
+/// tasks of its own range from the front and steals half of another thread's
+/// remaining range from the back once its own range is empty.
+///
+/// The thread that calls \ref run also executes tasks and only returns once
+/// every task of the batch has completed. Kernels enqueued on the cpu::queue
+/// therefore still finish in order even when they use the pool internally.
+class ThreadPool {
+   public:
+    /// Creates a pool which executes tasks on \p num_threads threads. The
+    /// calling thread counts as one of them so num_threads - 1 workers are
+    /// created.
+    explicit ThreadPool(int num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &)            = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /// Returns the number of threads executing tasks, including the caller
+    int size() const noexcept { return static_cast<int>(workers.size()) + 1; }
+
+    /// Calls \p task for every index in [0, num_tasks) and waits for all of
+    /// them to complete.
+    ///
+    /// Calls made from inside a task are executed serially on the calling
+    /// thread. The first exception thrown by a task is rethrown here.
+    void run(int num_tasks, const std::function<void(int)> &task);
+
+   private:
+    /// The indices of the tasks assigned to one thread which have not
+    /// started yet
+    struct TaskRange {
+        std::mutex mutex;
+        int begin = 0;
+        int end   = 0;
+    };
+
+    void workerLoop(int slot);
+    void executeTasks(int slot, const std::function<void(int)> &task);
+    bool popTask(int slot, int &idx);
+    bool stealTasks(int slot);
+
+    std::vector<std::thread> workers;
+
+    /// The task ranges of each thread. Slot 0 belongs to the caller of run
+    std::unique_ptr<TaskRange[]> ranges;
+
+    /// Serializes concurrent callers of run
+    std::mutex run_mutex;
+
+    std::mutex state_mutex;
+    std::condition_variable work_cv;
+    std::condition_variable done_cv;
+
+    const std::function<void(int)> *current_task = nullptr;
+    unsigned generation                          = 0;
+    int active_workers                           = 0;
+    bool stop                                    = false;
+    std::exception_ptr error;
+
+    std::atomic<int> remaining_tasks{0};
+};
+
+/// Returns the number of threads used by the cpu backend kernels
+///
+/// The value is read from the AF_CPU_THREADS environment variable and defaults
+/// to the number of hardware threads.
+int getDefaultThreadCount();
+
+}  // namespace cpu
+}  // namespace arrayfire
@@ -7,14 +7,16 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
-#include <kernel/tile.hpp>
 #include <tile.hpp>
 
 #include <Array.hpp>
 #include <common/half.hpp>
-#include <platform.hpp>
+#include <jit/GeneratorNode.hpp>
+
+#include <memory>
 
 using arrayfire::common::half;
+using std::make_shared;
 
 namespace arrayfire {
 namespace cpu {
@@ -29,11 +31,14 @@ Array<T> tile(const Array<T> &in, const af::dim4 &tileDims) {
         throw std::runtime_error("Elements are 0");
     }
 
-    Array<T> out = createEmptyArray<T>(oDims);
-
-    getQueue().enqueue(kernel::tile<T>, out, in);
+    // The tiled array reads the buffer of its input
+    in.eval();
 
-    return out;
+    auto node = make_shared<jit::GeneratorNode<T, jit::TileGenerator<T>>>(
+        oDims, iDims);
+    node->setData(in.getData(), in.getDataDims().elements() * sizeof(T),
+                  in.getOffset(), in.strides().get());
+    return createNodeArray<T>(oDims, node);
 }
 
 #define INSTANTIATE(T) \
@@ -9,24 +9,13 @@
 
 #pragma once
 #include <common/kernel_type.hpp>
+#include <af/traits.hpp>
+
 #include <complex>
 
 namespace arrayfire {
 namespace cpu {
 
-namespace {
-template<typename T>
-const char *shortname(bool caps = false) {
-    return caps ? "?" : "?";
-}
-
-template<typename T>
-const char *getFullName() {
-    return "N/A";
-}
-
-}  // namespace
-
 using cdouble = std::complex<double>;
 using cfloat  = std::complex<float>;
 using intl    = long long;
@@ -35,6 +24,68 @@ using uchar   = unsigned char;
 using uintl   = unsigned long long;
 using ushort  = unsigned short;
 
+namespace {
+template<typename T>
+inline const char *shortname(bool caps = false) {
+    return caps ? "X" : "x";
+}
+
+template<>
+inline const char *shortname<float>(bool caps) {
+    return caps ? "S" : "s";
+}
+template<>
+inline const char *shortname<double>(bool caps) {
+    return caps ? "D" : "d";
+}
+template<>
+inline const char *shortname<cfloat>(bool caps) {
+    return caps ? "C" : "c";
+}
+template<>
+inline const char *shortname<cdouble>(bool caps) {
+    return caps ? "Z" : "z";
+}
+template<>
+inline const char *shortname<int>(bool caps) {
+    return caps ? "I" : "i";
+}
+template<>
+inline const char *shortname<uint>(bool caps) {
+    return caps ? "U" : "u";
+}
+template<>
+inline const char *shortname<char>(bool caps) {
+    return caps ? "J" : "j";
+}
+template<>
+inline const char *shortname<uchar>(bool caps) {
+    return caps ? "V" : "v";
+}
+template<>
+inline const char *shortname<intl>(bool caps) {
+    return caps ? "L" : "l";
+}
+template<>
+inline const char *shortname<uintl>(bool caps) {
+    return caps ? "K" : "k";
+}
+template<>
+inline const char *shortname<short>(bool caps) {
+    return caps ? "P" : "p";
+}
+template<>
+inline const char *shortname<ushort>(bool caps) {
+    return caps ? "Q" : "q";
+}
+
+/// The names of the types in the source of the native JIT kernels
+template<typename T>
+inline const char *getFullName() {
+    return af::dtype_traits<T>::getName();
+}
+}  // namespace
+
 template<typename T>
 using compute_t = typename common::kernel_type<T>::compute;
 
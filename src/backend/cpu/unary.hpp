@@ -12,6 +12,7 @@
 #include <err_cpu.hpp>
 #include <jit/UnaryNode.hpp>
 #include <optypes.hpp>
+#include <simd_math.hpp>
 #include <cmath>
 
 namespace arrayfire {
@@ -36,11 +37,29 @@ T rsqrt(T in) {
         }                                                         \
     };
 
+// Uses the batch<T> implementation of simd_math.hpp when \p vectorized is
+// true for the compute type and \p fn otherwise
+#define UNARY_OP_SIMD_FN(op, fn, vectorized)                              \
+    template<typename T>                                                  \
+    struct UnOp<T, T, af_##op##_t> {                                      \
+        void eval(jit::array<compute_t<T>> &out,                          \
+                  const jit::array<compute_t<T>> &in, int lim) {          \
+            using C = compute_t<T>;                                       \
+            if constexpr (vectorized<C>::value) {                         \
+                simd::apply(out.data(), in.data(), lim,                   \
+                            [](simd::batch<C> v) { return simd::op(v); }); \
+            } else {                                                      \
+                for (int i = 0; i < lim; i++) { out[i] = fn(in[i]); }     \
+            }                                                             \
+        }                                                                 \
+    };
+
 #define UNARY_OP(op) UNARY_OP_FN(op, std::op)
+#define UNARY_OP_SIMD(op) UNARY_OP_SIMD_FN(op, std::op, simd::is_vectorized)
 
-UNARY_OP(sin)
-UNARY_OP(cos)
-UNARY_OP(tan)
+UNARY_OP_SIMD(sin)
+UNARY_OP_SIMD(cos)
+UNARY_OP_SIMD(tan)
 
 UNARY_OP(asin)
 UNARY_OP(acos)
@@ -60,19 +79,19 @@ UNARY_OP(signbit)
 UNARY_OP(floor)
 UNARY_OP(ceil)
 
-UNARY_OP(exp)
-UNARY_OP_FN(sigmoid, sigmoid)
+UNARY_OP_SIMD(exp)
+UNARY_OP_SIMD_FN(sigmoid, sigmoid, simd::is_vectorized)
 UNARY_OP(expm1)
-UNARY_OP(erf)
+UNARY_OP_SIMD_FN(erf, std::erf, simd::has_erf)
 UNARY_OP(erfc)
 
-UNARY_OP(log)
+UNARY_OP_SIMD(log)
 UNARY_OP(log10)
 UNARY_OP(log1p)
-UNARY_OP(log2)
+UNARY_OP_SIMD(log2)
 
-UNARY_OP(sqrt)
-UNARY_OP_FN(rsqrt, rsqrt)
+UNARY_OP_SIMD(sqrt)
+UNARY_OP_SIMD_FN(rsqrt, rsqrt, simd::is_vectorized)
 UNARY_OP(cbrt)
 
 UNARY_OP(tgamma)
@@ -81,7 +100,9 @@ UNARY_OP_FN(noop, )  /// Empty second parameter so it does nothing
 
 UNARY_OP_FN(bitnot, ~)
 
+#undef UNARY_OP_SIMD
 #undef UNARY_OP
+#undef UNARY_OP_SIMD_FN
 #undef UNARY_OP_FN
 
 template<typename T, af_op_t op>
@@ -19,6 +19,7 @@
 #include <common/DefaultMemoryManager.hpp>
 #include <common/Logger.hpp>
 #include <common/MemoryManagerBase.hpp>
+#include <common/SizeClassMemoryManager.hpp>
 #include <common/defines.hpp>
 #include <common/graphics_common.hpp>
 #include <common/host_memory.hpp>
@@ -396,9 +397,9 @@ void DeviceManager::setMemoryManager(
 
 void DeviceManager::resetMemoryManager() {
     // Replace with default memory manager
-    std::unique_ptr<MemoryManagerBase> mgr(
-        new common::DefaultMemoryManager(getDeviceCount(), common::MAX_BUFFERS,
-                                         AF_MEM_DEBUG || AF_CUDA_MEM_DEBUG));
+    std::unique_ptr<MemoryManagerBase> mgr = common::createDefaultMemoryManager(
+        getDeviceCount(), common::MAX_BUFFERS,
+        AF_MEM_DEBUG || AF_CUDA_MEM_DEBUG);
     setMemoryManager(std::move(mgr));
 }
 
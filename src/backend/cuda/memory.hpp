@@ -9,6 +9,7 @@
 #pragma once
 
 #include <common/AllocatorInterface.hpp>
+#include <af/device.h>
 
 #include <cstdlib>
 #include <functional>
@@ -45,6 +46,8 @@ void pinnedFree(void *ptr);
 
 void deviceMemoryInfo(size_t *alloc_bytes, size_t *alloc_buffers,
                       size_t *lock_bytes, size_t *lock_buffers);
+void deviceMemoryStats(af_memory_stats *stats);
+void resetMemoryStats();
 void signalMemoryCleanup();
 void shutdownMemoryManager();
 void pinnedGarbageCollect();
@@ -56,6 +59,8 @@ float getMemoryPressureThreshold();
 bool jitTreeExceedsMemoryPressure(size_t bytes);
 void setMemStepSize(size_t step_bytes);
 size_t getMemStepSize(void);
+void setMemCacheBudget(size_t bytes);
+size_t getMemCacheBudget();
 
 class Allocator final : public arrayfire::common::AllocatorInterface {
    public:
@@ -20,6 +20,7 @@
 #include <build_version.hpp>
 #include <common/DefaultMemoryManager.hpp>
 #include <common/Logger.hpp>
+#include <common/SizeClassMemoryManager.hpp>
 #include <common/defines.hpp>
 #include <common/err_common.hpp>
 #include <common/graphics_common.hpp>
@@ -450,7 +451,7 @@ MemoryManagerBase &memoryManager() {
 
     call_once(flag, [&]() {
         // By default, create an instance of the default memory manager
-        inst.memManager = make_unique<common::DefaultMemoryManager>(
+        inst.memManager = common::createDefaultMemoryManager(
             getDeviceCount(), common::MAX_BUFFERS,
             AF_MEM_DEBUG || AF_CUDA_MEM_DEBUG);
         // Set the memory manager's device memory manager
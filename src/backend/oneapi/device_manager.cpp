@@ -13,6 +13,7 @@
 #include <build_version.hpp>
 #include <common/DefaultMemoryManager.hpp>
 #include <common/Logger.hpp>
+#include <common/SizeClassMemoryManager.hpp>
 #include <common/defines.hpp>
 #include <common/graphics_common.hpp>
 #include <common/host_memory.hpp>
@@ -253,9 +254,9 @@ void DeviceManager::setMemoryManager(
 
 void DeviceManager::resetMemoryManager() {
     // Replace with default memory manager
-    std::unique_ptr<MemoryManagerBase> mgr(
-        new common::DefaultMemoryManager(getDeviceCount(), common::MAX_BUFFERS,
-                                         AF_MEM_DEBUG || AF_ONEAPI_MEM_DEBUG));
+    std::unique_ptr<MemoryManagerBase> mgr = common::createDefaultMemoryManager(
+        getDeviceCount(), common::MAX_BUFFERS,
+        AF_MEM_DEBUG || AF_ONEAPI_MEM_DEBUG);
     setMemoryManager(std::move(mgr));
 }
 
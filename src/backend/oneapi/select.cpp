@@ -44,7 +44,9 @@ Array<T> createSelectNode(const Array<char> &cond, const Array<T> &a,
         static_cast<af::dtype>(af::dtype_traits<T>::af_type), "__select", 3,
         {{cond_node, a_node, b_node}}, af_select_t, height));
     std::array<common::Node *, 1> nodes{node.get()};
-    if (detail::passesJitHeuristics<T>(nodes) != kJITHeuristics::Pass) {
+    const kJITHeuristics heuristic = detail::passesJitHeuristics<T>(nodes);
+    if (heuristic != kJITHeuristics::Pass) {
+        common::recordJitHeuristic(heuristic);
         if (a_height > max(b_height, cond_height)) {
             a.eval();
         } else if (b_height > cond_height) {
@@ -75,7 +77,9 @@ Array<T> createSelectNode(const Array<char> &cond, const Array<T> &a,
         (flip ? af_not_select_t : af_select_t), height));
 
     std::array<common::Node *, 1> nodes{node.get()};
-    if (detail::passesJitHeuristics<T>(nodes) != kJITHeuristics::Pass) {
+    const kJITHeuristics heuristic = detail::passesJitHeuristics<T>(nodes);
+    if (heuristic != kJITHeuristics::Pass) {
+        common::recordJitHeuristic(heuristic);
         if (a_height > max(b_height, cond_height)) {
             a.eval();
         } else if (b_height > cond_height) {
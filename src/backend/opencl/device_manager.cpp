@@ -18,6 +18,7 @@
 #include <common/ArrayFireTypesIO.hpp>
 #include <common/DefaultMemoryManager.hpp>
 #include <common/Logger.hpp>
+#include <common/SizeClassMemoryManager.hpp>
 #include <common/Version.hpp>
 #include <common/defines.hpp>
 #include <common/host_memory.hpp>
@@ -400,9 +401,9 @@ void DeviceManager::setMemoryManager(
 
 void DeviceManager::resetMemoryManager() {
     // Replace with default memory manager
-    std::unique_ptr<MemoryManagerBase> mgr(
-        new common::DefaultMemoryManager(getDeviceCount(), common::MAX_BUFFERS,
-                                         AF_MEM_DEBUG || AF_OPENCL_MEM_DEBUG));
+    std::unique_ptr<MemoryManagerBase> mgr = common::createDefaultMemoryManager(
+        getDeviceCount(), common::MAX_BUFFERS,
+        AF_MEM_DEBUG || AF_OPENCL_MEM_DEBUG);
     setMemoryManager(std::move(mgr));
 }
 
@@ -44,6 +44,10 @@ void setMemStepSize(size_t step_bytes) {
 
 size_t getMemStepSize() { return memoryManager().getMemStepSize(); }
 
+void setMemCacheBudget(size_t bytes) { memoryManager().setCacheBudget(bytes); }
+
+size_t getMemCacheBudget() { return memoryManager().getCacheBudget(); }
+
 void signalMemoryCleanup() { memoryManager().signalMemoryCleanup(); }
 
 void shutdownMemoryManager() { memoryManager().shutdown(); }
@@ -136,6 +140,12 @@ void deviceMemoryInfo(size_t *alloc_bytes, size_t *alloc_buffers,
                               lock_buffers);
 }
 
+void deviceMemoryStats(af_memory_stats *stats) {
+    memoryManager().memoryStats(stats);
+}
+
+void resetMemoryStats() { memoryManager().resetMemoryStats(); }
+
 template<typename T>
 T *pinnedAlloc(const size_t &elements) {
     // TODO: make pinnedAlloc aware of array shapes
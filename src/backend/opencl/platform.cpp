@@ -18,6 +18,7 @@
 #include <common/ArrayFireTypesIO.hpp>
 #include <common/DefaultMemoryManager.hpp>
 #include <common/Logger.hpp>
+#include <common/SizeClassMemoryManager.hpp>
 #include <common/Version.hpp>
 #include <common/host_memory.hpp>
 #include <common/util.hpp>
@@ -687,7 +688,7 @@ MemoryManagerBase& memoryManager() {
 
     call_once(flag, [&]() {
         // By default, create an instance of the default memory manager
-        inst.memManager = make_unique<common::DefaultMemoryManager>(
+        inst.memManager = common::createDefaultMemoryManager(
             getDeviceCount(), common::MAX_BUFFERS,
             AF_MEM_DEBUG || AF_OPENCL_MEM_DEBUG);
         // Set the memory manager's device memory manager
@@ -13,6 +13,7 @@
 #include <testHelpers.hpp>
 
 #include <complex>
+#include <fstream>
 #include <string>
 #include <vector>
 
@@ -20,6 +21,7 @@ using af::allTrue;
 using af::array;
 using af::constant;
 using af::dim4;
+using af::mapArray;
 using af::readArray;
 using af::saveArray;
 using std::complex;
@@ -128,3 +130,45 @@ TEST(ArrayIO, Save) {
     ASSERT_ARRAYS_EQ(a, aread);
     ASSERT_ARRAYS_EQ(b, bread);
 }
+
+TEST(ArrayIO, MapArray) {
+    vector<float> values(164);
+    for (size_t i = 0; i < values.size(); i++) { values[i] = i; }
+    {
+        std::ofstream file("mapped.raw", std::ios::binary);
+        file.write(reinterpret_cast<const char *>(values.data()),
+                   values.size() * sizeof(float));
+    }
+
+    const size_t offset = 64 * sizeof(float);
+    dim_t dims[]        = {10, 10};
+    af_array handle     = 0;
+    af_err err = af_create_array_from_file(&handle, "mapped.raw", offset, 2,
+                                           dims, f32, false);
+    if (err == AF_ERR_NOT_SUPPORTED) {
+        GTEST_SKIP() << "Mapping files is not supported";
+    }
+    ASSERT_SUCCESS(err);
+    array mapped(handle);
+
+    vector<float> gold(values.begin() + 64, values.end());
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(10, 10), mapped);
+
+    array writable = mapArray("mapped.raw", dim4(10, 10), f32, offset, true);
+    writable(0)    = -1;
+    ASSERT_EQ(-1, writable.scalar<float>());
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(10, 10), mapped);
+
+    // The file is not modified
+    float first = 0;
+    {
+        std::ifstream file("mapped.raw", std::ios::binary);
+        file.seekg(offset);
+        file.read(reinterpret_cast<char *>(&first), sizeof(float));
+    }
+    ASSERT_EQ(gold[0], first);
+
+    array empty = mapArray("mapped.raw", dim4(0, 10), f32, 0);
+    ASSERT_TRUE(empty.isempty());
+    ASSERT_EQ(dim4(0, 10), empty.dims());
+}
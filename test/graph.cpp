@@ -0,0 +1,108 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <gtest/gtest.h>
+#include <testHelpers.hpp>
+#include <af/graph.h>
+
+#include <vector>
+
+using af::array;
+using af::dim4;
+using af::graph;
+using std::vector;
+
+class GraphTests : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        if (af::getActiveBackend() != AF_BACKEND_CPU) {
+            ASSERT_EQ(AF_ERR_NOT_SUPPORTED, af_begin_capture());
+            GTEST_SKIP() << "Graphs are only supported by the CPU backend";
+        }
+    }
+};
+
+TEST_F(GraphTests, CaptureAndRelease) {
+    af_graph handle = 0;
+    ASSERT_SUCCESS(af_begin_capture());
+    ASSERT_EQ(AF_ERR_RUNTIME, af_begin_capture());
+    ASSERT_SUCCESS(af_end_capture(&handle));
+    ASSERT_EQ(AF_ERR_RUNTIME, af_end_capture(&handle));
+    ASSERT_SUCCESS(af_replay_graph(handle));
+    ASSERT_SUCCESS(af_release_graph(handle));
+}
+
+TEST_F(GraphTests, ReplayReadsNewInputs) {
+    const int n = 64;
+    vector<float> values(n * n, 1.f);
+    array in(n, n, values.data());
+
+    af::beginCapture();
+    array out = in * 2 + 1;
+    out.eval();
+    array sum = af::sum(out, 0);
+    sum.eval();
+    graph g = af::endCapture();
+
+    vector<float> gold_out(n * n), gold_sum(n);
+    for (int iter = 2; iter < 5; iter++) {
+        for (int i = 0; i < n * n; i++) { values[i] = float(iter * i % 7); }
+        in.write(values.data(), values.size() * sizeof(float));
+        g.replay();
+
+        for (int i = 0; i < n * n; i++) { gold_out[i] = values[i] * 2 + 1; }
+        for (int c = 0; c < n; c++) {
+            gold_sum[c] = 0;
+            for (int r = 0; r < n; r++) { gold_sum[c] += gold_out[c * n + r]; }
+        }
+        ASSERT_VEC_ARRAY_EQ(gold_out, dim4(n, n), out);
+        ASSERT_VEC_ARRAY_EQ(gold_sum, dim4(1, n), sum);
+    }
+}
+
+TEST_F(GraphTests, ReplayKeepsTemporaries) {
+    const int n = 32;
+    vector<float> values(n * n, 2.f);
+    array in(n, n, values.data());
+
+    af::beginCapture();
+    array out;
+    {
+        // The temporary is freed during the capture but the graph still
+        // writes it
+        array tmp = in + 1;
+        tmp.eval();
+        out = af::matmul(tmp, tmp);
+    }
+    graph g = af::endCapture();
+
+    // The memory of the temporary must not be handed out again
+    vector<array> others;
+    for (int i = 0; i < 8; i++) {
+        others.push_back(af::constant(-1, n, n));
+        others.back().eval();
+    }
+
+    in.write(vector<float>(n * n, 1.f).data(), n * n * sizeof(float));
+    g.replay();
+
+    ASSERT_VEC_ARRAY_EQ(vector<float>(n * n, 4.f * n), dim4(n, n), out);
+    for (const array &other : others) {
+        ASSERT_VEC_ARRAY_EQ(vector<float>(n * n, -1.f), dim4(n, n), other);
+    }
+}
+
+TEST_F(GraphTests, RandomNumbersCannotBeReplayed) {
+    af_graph handle = 0;
+    ASSERT_SUCCESS(af_begin_capture());
+    array r = af::randu(100, 100);
+    r.eval();
+    ASSERT_EQ(AF_ERR_NOT_SUPPORTED, af_end_capture(&handle));
+}
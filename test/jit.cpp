@@ -8,27 +8,33 @@
  ********************************************************/
 
 #include <gtest/gtest.h>
+#include <src/api/c/jit_test_api.h>
 #include <testHelpers.hpp>
 #include <af/algorithm.h>
 #include <af/arith.h>
 #include <af/array.h>
+#include <af/backend.h>
 #include <af/data.h>
 #include <af/device.h>
 #include <af/gfor.h>
 #include <af/random.h>
 
+#include <cstdlib>
 #include <numeric>
+#include <string>
 #include <tuple>
 
 using af::array;
 using af::constant;
 using af::dim4;
+using af::end;
 using af::eval;
 using af::freeHost;
 using af::gforSet;
 using af::randn;
 using af::randu;
 using af::seq;
+using af::span;
 using std::get;
 using std::to_string;
 using std::tuple;
@@ -335,6 +341,36 @@ TEST(JIT, NonLinearLargeX) {
     ASSERT_SUCCESS(af_release_array(s));
 }
 
+TEST(JIT, NonLinearMultiLargeOddShape) {
+    // The dimensions are not multiples of the CPU JIT chunk length so the
+    // ranges evaluated by each thread end in the middle of a row
+    const int d0 = 1001;
+    const int d1 = 517;
+    array a      = randu(d0);
+    array b      = randu(1, d1);
+
+    array x = tile(a, 1, d1) + tile(b, d0, 1);
+    array y = tile(a, 1, d1) * tile(b, d0, 1);
+    eval(x, y);
+
+    vector<float> ha(d0);
+    vector<float> hb(d1);
+    vector<float> hx(d0 * d1);
+    vector<float> hy(d0 * d1);
+
+    a.host(ha.data());
+    b.host(hb.data());
+
+    for (int j = 0; j < d1; j++) {
+        for (int i = 0; i < d0; i++) {
+            hx[i + j * d0] = ha[i] + hb[j];
+            hy[i + j * d0] = ha[i] * hb[j];
+        }
+    }
+    ASSERT_VEC_ARRAY_EQ(hx, dim4(d0, d1), x);
+    ASSERT_VEC_ARRAY_EQ(hy, dim4(d0, d1), y);
+}
+
 TEST(JIT, ISSUE_1894) {
     array a = randu(1);
     array b = tile(a, 2 * (1 << 20));
@@ -760,6 +796,313 @@ TEST(JIT, IndexingRow) {
     ASSERT_VEC_ARRAY_EQ(gold, dim4(1, 512), c);
 }
 
+TEST(JIT, SameStructureDifferentData) {
+    // Trees with the same structure share their compiled form so the data of
+    // each evaluation must come from its own buffers and constants
+    for (int i = 0; i < 4; i++) {
+        array a = constant(i, 100, 10);
+        array b = constant(2 * i, 100, 10);
+        a.eval();
+        b.eval();
+
+        array c = moddims(a * b + (i + 1), 1000);
+
+        vector<float> gold(1000, float(2 * i * i + i + 1));
+        ASSERT_VEC_ARRAY_EQ(gold, dim4(1000), c);
+    }
+}
+
+TEST(JIT, SharedSubtreeMultipleOutputs) {
+    array a = randu(1000);
+    array b = randu(1000);
+    a.eval();
+    b.eval();
+
+    array s = a + b;
+    array c = s * s;
+    array d = s - 1.0f;
+    eval(c, d);
+
+    vector<float> ha(1000), hb(1000);
+    a.host(ha.data());
+    b.host(hb.data());
+    vector<float> gold_c(1000), gold_d(1000);
+    for (int i = 0; i < 1000; i++) {
+        float v   = ha[i] + hb[i];
+        gold_c[i] = v * v;
+        gold_d[i] = v - 1.0f;
+    }
+    ASSERT_VEC_ARRAY_EQ(gold_c, dim4(1000), c);
+    ASSERT_VEC_ARRAY_EQ(gold_d, dim4(1000), d);
+}
+
+TEST(JIT, EquivalentSubtrees) {
+    // The subtrees are built independently but compute the same values so
+    // they are evaluated once and must still produce the right results
+    array a = randu(1000);
+    array b = randu(1000);
+    a.eval();
+    b.eval();
+
+    array c = exp(a * 2.0f) + b;
+    array d = exp(a * 2.0f) - b;
+    array e = moddims(a + 1.0f, 10, 100) * moddims(a + 1.0f, 10, 100);
+    eval(c, d);
+
+    vector<float> ha(1000), hb(1000);
+    a.host(ha.data());
+    b.host(hb.data());
+    vector<float> gold_c(1000), gold_d(1000), gold_e(1000);
+    for (int i = 0; i < 1000; i++) {
+        gold_c[i] = std::exp(ha[i] * 2.0f) + hb[i];
+        gold_d[i] = std::exp(ha[i] * 2.0f) - hb[i];
+        gold_e[i] = (ha[i] + 1.0f) * (ha[i] + 1.0f);
+    }
+    ASSERT_VEC_ARRAY_NEAR(gold_c, dim4(1000), c, 1e-5);
+    ASSERT_VEC_ARRAY_NEAR(gold_d, dim4(1000), d, 1e-5);
+    ASSERT_VEC_ARRAY_NEAR(gold_e, dim4(10, 100), e, 1e-6);
+}
+
+TEST(JIT, EvalMultipleTypesAndShapes) {
+    array a = randu(1000);
+    array b = randu(1000);
+    array c = randu(10, 10);
+    a.eval();
+    b.eval();
+    c.eval();
+
+    array s    = a + b;
+    array loss = s * s;
+    array mask = s > 1.0f;
+    array acc  = s.as(f64) + 1.0;
+    array d    = c * 2.0f;
+    eval(loss, mask, acc, d);
+
+    vector<float> ha(1000), hb(1000), hc(100);
+    a.host(ha.data());
+    b.host(hb.data());
+    c.host(hc.data());
+    vector<float> gold_loss(1000), gold_d(100);
+    vector<char> gold_mask(1000);
+    vector<double> gold_acc(1000);
+    for (int i = 0; i < 1000; i++) {
+        float v      = ha[i] + hb[i];
+        gold_loss[i] = v * v;
+        gold_mask[i] = v > 1.0f;
+        gold_acc[i]  = double(v) + 1.0;
+    }
+    for (int i = 0; i < 100; i++) { gold_d[i] = hc[i] * 2.0f; }
+    ASSERT_VEC_ARRAY_EQ(gold_loss, dim4(1000), loss);
+    ASSERT_VEC_ARRAY_EQ(gold_mask, dim4(1000), mask);
+    ASSERT_VEC_ARRAY_EQ(gold_acc, dim4(1000), acc);
+    ASSERT_VEC_ARRAY_EQ(gold_d, dim4(10, 10), d);
+}
+
+TEST(JIT, StridedViews) {
+    const int nx = 37, ny = 23;
+    array a = randu(nx, ny);
+    array b = randu(nx / 2 + 1, ny / 2 + 1);
+
+    array c = a(seq(0, end, 2), seq(end, 0, -2)) + b;
+    array v = a(seq(1, end, 3), span);
+    array d = v(span, seq(2, 10, 4)) * 2.0f;
+
+    vector<float> ha(nx * ny), hb(b.elements());
+    a.host(ha.data());
+    b.host(hb.data());
+
+    const int cx = nx / 2 + 1, cy = ny / 2 + 1;
+    vector<float> gold_c(cx * cy);
+    for (int y = 0; y < cy; y++) {
+        for (int x = 0; x < cx; x++) {
+            gold_c[y * cx + x] =
+                ha[(ny - 1 - 2 * y) * nx + 2 * x] + hb[y * cx + x];
+        }
+    }
+    const int dx = nx / 3, dy = 3;
+    vector<float> gold_d(dx * dy);
+    for (int y = 0; y < dy; y++) {
+        for (int x = 0; x < dx; x++) {
+            gold_d[y * dx + x] = ha[(2 + 4 * y) * nx + 1 + 3 * x] * 2.0f;
+        }
+    }
+    ASSERT_VEC_ARRAY_EQ(gold_c, dim4(cx, cy), c);
+    ASSERT_VEC_ARRAY_EQ(gold_d, dim4(dx, dy), d);
+}
+
+TEST(JIT, Generators) {
+    const int n = 50;
+    array t     = af::range(dim4(n, 3), 1) * 0.5f + 2.0f;
+    array m     = af::identity(n, n) * randu(n, n);
+    array i     = af::iota(dim4(3, 2), dim4(2, 3)) + 1;
+    array d     = af::diag(af::range(dim4(4, 2), 0), -1, false);
+
+    vector<float> hm(n * n);
+    m.host(hm.data());
+    array r = randu(n, n);
+    r.eval();
+    array e = af::diag(r, 1) + 1.0f;
+    vector<float> hr(n * n);
+    r.host(hr.data());
+
+    vector<float> gold_t(n * 3), gold_e(n - 1);
+    for (int y = 0; y < 3; y++) {
+        for (int x = 0; x < n; x++) { gold_t[y * n + x] = y * 0.5f + 2.0f; }
+    }
+    for (int x = 0; x < n * n; x++) {
+        if (x % n != x / n) { ASSERT_EQ(0.0f, hm[x]); }
+    }
+    vector<float> gold_i(36);
+    for (int y = 0; y < 6; y++) {
+        for (int x = 0; x < 6; x++) {
+            gold_i[y * 6 + x] = (y % 2) * 3 + x % 3 + 1;
+        }
+    }
+    vector<float> gold_d(5 * 5 * 2, 0.0f);
+    for (int k = 0; k < 2; k++) {
+        for (int j = 0; j < 4; j++) { gold_d[k * 25 + j * 5 + j + 1] = j; }
+    }
+    for (int x = 0; x < n - 1; x++) { gold_e[x] = hr[(x + 1) * n + x] + 1.0f; }
+
+    ASSERT_VEC_ARRAY_EQ(gold_t, dim4(n, 3), t);
+    ASSERT_VEC_ARRAY_EQ(gold_i, dim4(6, 6), i);
+    ASSERT_VEC_ARRAY_EQ(gold_d, dim4(5, 5, 2), d);
+    ASSERT_VEC_ARRAY_EQ(gold_e, dim4(n - 1), e);
+}
+
+TEST(JIT, SelectAndShift) {
+    const int nx = 300, ny = 7;
+    array x = randn(nx, ny);
+    x.eval();
+
+    array leaky = af::select(x > 0, x, 0.1f * x);
+    array grad  = af::shift(x, -1) - x;
+    array clip  = x * 2.0f;
+    af::replace(clip, clip < 1.0f, 1.0f);
+
+    vector<float> hx(nx * ny);
+    x.host(hx.data());
+    vector<float> gold_leaky(nx * ny), gold_grad(nx * ny), gold_clip(nx * ny);
+    for (int y = 0; y < ny; y++) {
+        for (int i = 0; i < nx; i++) {
+            const float v          = hx[y * nx + i];
+            gold_leaky[y * nx + i] = v > 0 ? v : 0.1f * v;
+            gold_grad[y * nx + i]  = hx[y * nx + (i + 1) % nx] - v;
+            gold_clip[y * nx + i]  = 2.0f * v < 1.0f ? 1.0f : 2.0f * v;
+        }
+    }
+    ASSERT_VEC_ARRAY_EQ(gold_leaky, dim4(nx, ny), leaky);
+    ASSERT_VEC_ARRAY_EQ(gold_grad, dim4(nx, ny), grad);
+    ASSERT_VEC_ARRAY_EQ(gold_clip, dim4(nx, ny), clip);
+}
+
+namespace {
+void setNativeJit(bool enable) {
+    // The mode is read by the threads evaluating the trees
+    af::sync();
+    af::setCpuNativeJit(enable);
+}
+
+bool hasHostCompiler() {
+#if defined(_WIN32)
+    return false;
+#else
+    const char *compiler = getenv("AF_CPU_JIT_COMPILER");
+    const std::string command = std::string(compiler ? compiler : "c++") +
+                                " --version > /dev/null 2>&1";
+    return std::system(command.c_str()) == 0;
+#endif
+}
+
+/// Trees covering the unary, binary, select and generator nodes, the linear
+/// and strided loops and a complex tree left to the interpreter
+vector<array> nativeTrees(const array &a, const array &b) {
+    const dim4 dims = a.dims();
+    array sa        = a(seq(1, end), seq(0, end - 1));
+    array sb        = b(seq(0, end - 1), seq(1, end));
+    vector<array> trees{
+        af::sin(a) * af::cos(b) + af::exp(-a),
+        af::select(a > b, a - b, af::sqrt(b)),
+        a * af::range(dims, 1) + af::iota(dims) + 2.0f,
+        sa / (sb + 1.0f) - af::abs(sa - sb),
+        af::max(sa, sb) + af::floor(sa * 10.0f),
+        af::complex(a, b) * 2.0f,
+    };
+    for (array &tree : trees) { tree.eval(); }
+    return trees;
+}
+}  // namespace
+
+TEST(JIT, NativeKernels) {
+    if (af::getActiveBackend() != AF_BACKEND_CPU) {
+        GTEST_SKIP() << "Only the CPU backend compiles native JIT kernels";
+    }
+    if (!hasHostCompiler()) { GTEST_SKIP() << "No host compiler available"; }
+
+    array a = randu(100, 100);
+    array b = randu(100, 100);
+    eval(a, b);
+
+    setNativeJit(false);
+    vector<array> gold = nativeTrees(a, b);
+    setNativeJit(true);
+    vector<array> native = nativeTrees(a, b);
+    setNativeJit(false);
+
+    for (size_t i = 0; i < gold.size(); i++) {
+        ASSERT_ARRAYS_NEAR(gold[i], native[i], 1e-5) << "tree " << i;
+    }
+}
+
+TEST(JIT, TileNonSingleton) {
+    const int nx = 5, ny = 3, tx = 3, ty = 2;
+    array x = randu(nx + 2, ny);
+    array b = randu(nx * tx);
+    x.eval();
+    b.eval();
+
+    array tiled = tile(x(seq(nx), span), tx, ty);
+    array bias  = tiled + tile(b, 1, ny * ty);
+
+    vector<float> hx((nx + 2) * ny), hb(nx * tx);
+    x.host(hx.data());
+    b.host(hb.data());
+    vector<float> gold_tiled(nx * tx * ny * ty), gold_bias(nx * tx * ny * ty);
+    for (int y = 0; y < ny * ty; y++) {
+        for (int i = 0; i < nx * tx; i++) {
+            const float v               = hx[(y % ny) * (nx + 2) + i % nx];
+            gold_tiled[y * nx * tx + i] = v;
+            gold_bias[y * nx * tx + i]  = v + hb[i];
+        }
+    }
+    ASSERT_VEC_ARRAY_EQ(gold_tiled, dim4(nx * tx, ny * ty), tiled);
+    ASSERT_VEC_ARRAY_EQ(gold_bias, dim4(nx * tx, ny * ty), bias);
+}
+
+TEST(JIT, ManyLiveValues) {
+    // The left operand of each sum is kept while the rest of the tree is
+    // evaluated so the tape holds one value per term
+    const int num = 1001, terms = 40;
+    vector<array> xs;
+    for (int i = 0; i < terms; i++) {
+        xs.push_back(randu(num));
+        xs.back().eval();
+    }
+    array res = xs[terms - 1];
+    for (int i = terms - 2; i >= 0; i--) {
+        res = xs[i] * static_cast<float>(i + 1) + res;
+    }
+
+    vector<float> gold(num, 0.0f);
+    for (int i = terms - 1; i >= 0; i--) {
+        vector<float> h(num);
+        xs[i].host(h.data());
+        const float w = i == terms - 1 ? 1.0f : static_cast<float>(i + 1);
+        for (int k = 0; k < num; k++) { gold[k] = h[k] * w + gold[k]; }
+    }
+    ASSERT_VEC_ARRAY_NEAR(gold, dim4(num), res, 1e-4);
+}
+
 TEST(JIT, DISABLED_ManyConstants) {
     array res  = constant(1, 1);
     array res2 = tile(res, 1, 10);
@@ -8,14 +8,12 @@
  ********************************************************/
 
 #include <gtest/gtest.h>
+#include <src/api/c/jit_test_api.h>
 #include <testHelpers.hpp>
+#include <af/backend.h>
 #include <af/data.h>
-
-namespace af {
-int getMaxJitLen(void);
-
-void setMaxJitLen(const int jitLen);
-}  // namespace af
+#include <af/device.h>
+#include <af/random.h>
 
 TEST(JIT, UnitMaxHeight) {
     const int oldMaxJitLen = af::getMaxJitLen();
@@ -32,3 +30,37 @@ TEST(JIT, UnitMaxHeight) {
 TEST(JIT, ZeroMaxHeight) {
     EXPECT_THROW({ af::setMaxJitLen(0); }, af::exception);
 }
+
+TEST(JIT, Stats) {
+    const int num = 100;
+    af::array a   = af::randu(num);
+    a.eval();
+    af::sync();
+    af::resetJitStats();
+
+    const int oldMaxJitLen = af::getMaxJitLen();
+    af::setMaxJitLen(2);
+    af::array b = a;
+    for (int i = 0; i < 5; i++) { b = b * 2.0f + 1.0f; }
+    b.eval();
+    af::sync();
+    af::setMaxJitLen(oldMaxJitLen);
+
+    const af_jit_stats thread = af::getJitStats(true);
+    const af_jit_stats device = af::getJitStats(false);
+    EXPECT_GE(thread.height_evals, 1ULL);
+    EXPECT_GE(device.height_evals, thread.height_evals);
+
+    // The kernels are only counted by the CPU backend
+    if (af::getActiveBackend() == AF_BACKEND_CPU) {
+        EXPECT_GE(thread.evaluations, thread.height_evals + 1);
+        EXPECT_EQ(thread.buffers_written, thread.evaluations);
+        EXPECT_EQ(thread.bytes_written,
+                  thread.evaluations * num * sizeof(float));
+        EXPECT_LE(thread.max_height, 2ULL);
+        EXPECT_GE(device.evaluations, thread.evaluations);
+    }
+
+    af::resetJitStats();
+    EXPECT_EQ(af::getJitStats(true).evaluations, 0ULL);
+}
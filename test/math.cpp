@@ -14,7 +14,9 @@
 #include <af/exception.h>
 #include <af/random.h>
 
+#include <cmath>
 #include <complex>
+#include <limits>
 
 // This makes the macros cleaner
 using af::array;
@@ -146,3 +148,49 @@ TEST(MathTests, Not) {
     af_free_host(ha);
     af_free_host(hb);
 }
+
+template<typename T>
+void checkSpecialValues(array (*func)(const array &), T (*ref)(T),
+                        double err) {
+    using lim = std::numeric_limits<T>;
+    // Covers the values handled outside of the polynomial approximations and
+    // enough elements to fill several vector registers
+    vector<T> h_in = {T(0),           T(-0.0),        T(1),
+                      T(-1),          T(0.5),         T(-2.5),
+                      T(1024),        T(20000),       T(-1e6),
+                      T(-100),        T(80),          T(700),
+                      lim::min(),     lim::denorm_min(), lim::max(),
+                      lim::infinity(), -lim::infinity(), lim::quiet_NaN()};
+    while (h_in.size() < 300) { h_in.push_back(h_in[h_in.size() % 18] / 3); }
+
+    array in(h_in.size(), &h_in.front());
+    vector<T> h_out(h_in.size());
+    func(in).host(&h_out.front());
+
+    for (size_t i = 0; i < h_in.size(); i++) {
+        T gold = ref(h_in[i]);
+        if (std::isnan(gold)) {
+            ASSERT_TRUE(std::isnan(h_out[i])) << "at input " << h_in[i];
+        } else if (std::isinf(gold)) {
+            ASSERT_EQ(gold, h_out[i]) << "at input " << h_in[i];
+        } else {
+            ASSERT_NEAR(gold, h_out[i], err * std::max(T(1), abs(gold)))
+                << "at input " << h_in[i];
+        }
+    }
+}
+
+#define MATH_SPECIAL_TEST(func)                                        \
+    TEST(MathTests, SpecialValues_##func) {                            \
+        checkSpecialValues<float>(af::func, std::func, flt_err);       \
+        SUPPORTED_TYPE_CHECK(double);                                  \
+        checkSpecialValues<double>(af::func, std::func, dbl_err);      \
+    }
+
+MATH_SPECIAL_TEST(exp)
+MATH_SPECIAL_TEST(log)
+MATH_SPECIAL_TEST(log2)
+MATH_SPECIAL_TEST(sin)
+MATH_SPECIAL_TEST(cos)
+MATH_SPECIAL_TEST(sqrt)
+MATH_SPECIAL_TEST(erf)
@@ -379,3 +379,22 @@ TEST(MeanHalf, dim0) {
     // 0.506836
     ASSERT_ARRAYS_NEAR(m16.as(f32), m32, 0.001f);
 }
+
+TEST(Mean, JIT) {
+    using af::mean;
+    using af::seq;
+    using af::span;
+
+    array a = randu(1001, 517);
+    array b = randu(1001, 517);
+
+    // The evaluated copy goes through the regular kernels while the lazy
+    // expressions are averaged as they are evaluated
+    array gold = a(seq(1, 1000), span) * b(seq(0, 999), span);
+    gold.eval();
+    array expr = a(seq(1, 1000), span) * b(seq(0, 999), span);
+
+    ASSERT_ARRAYS_EQ(mean(gold, 0), mean(expr, 0));
+    ASSERT_ARRAYS_EQ(mean(gold, 1), mean(expr, 1));
+    ASSERT_NEAR(mean<float>(gold), mean<float>(expr), 1e-5);
+}
@@ -15,6 +15,8 @@
 #include <af/memory.h>
 #include <af/traits.hpp>
 
+#include <cstdlib>
+#include <limits>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
@@ -604,6 +606,220 @@ TEST(Memory, unlock) {
     ASSERT_EQ(lock_bytes, 0u);
 }
 
+namespace {
+void setSizeClasses(bool enable) {
+#if defined(_WIN32)
+    _putenv_s("AF_MEM_SIZE_CLASSES", enable ? "1" : "0");
+#else
+    setenv("AF_MEM_SIZE_CLASSES", enable ? "1" : "0", 1);
+#endif
+    // The default memory manager reads the variable when it is created
+    ASSERT_SUCCESS(af_unset_memory_manager());
+}
+}  // namespace
+
+TEST(Memory, SizeClasses) {
+    size_t alloc_bytes, alloc_buffers;
+    size_t lock_bytes, lock_buffers;
+
+    cleanSlate();  // Clean up everything done so far
+    setSizeClasses(true);
+
+    {
+        // 9 steps are rounded up to the class of 10 steps
+        array a(9 * step_bytes / sizeof(float), f32);
+        deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+
+        ASSERT_EQ(alloc_buffers, 1u);
+        ASSERT_EQ(lock_buffers, 1u);
+        ASSERT_EQ(alloc_bytes, 10 * step_bytes);
+        ASSERT_EQ(lock_bytes, 10 * step_bytes);
+    }
+
+    {
+        // The freed buffer is reused by a request of the same class
+        array b(10 * step_bytes / sizeof(float), f32);
+        deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+
+        ASSERT_EQ(alloc_buffers, 1u);
+        ASSERT_EQ(lock_buffers, 1u);
+        ASSERT_EQ(alloc_bytes, 10 * step_bytes);
+        ASSERT_EQ(lock_bytes, 10 * step_bytes);
+    }
+
+    // The buffers cached by the thread are freed as well
+    deviceGC();
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+
+    ASSERT_EQ(alloc_buffers, 0u);
+    ASSERT_EQ(lock_buffers, 0u);
+    ASSERT_EQ(alloc_bytes, 0u);
+    ASSERT_EQ(lock_bytes, 0u);
+
+    setSizeClasses(false);
+}
+
+TEST(Memory, CpuAllocPolicy) {
+    if (af::getActiveBackend() != AF_BACKEND_CPU) {
+        af_huge_pages huge_pages;
+        ASSERT_EQ(AF_ERR_NOT_SUPPORTED,
+                  af_get_cpu_alloc_policy(&huge_pages, nullptr, nullptr));
+        GTEST_SKIP() << "The allocation policy is only supported by the CPU "
+                        "backend";
+    }
+    af::hugePages old_pages;
+    af::numaPolicy old_numa;
+    size_t old_bytes;
+    af::getCpuAllocPolicy(&old_pages, &old_numa, &old_bytes);
+    EXPECT_EQ(AF_ERR_ARG,
+              af_set_cpu_alloc_policy(static_cast<af_huge_pages>(-1),
+                                      AF_NUMA_DEFAULT, old_bytes));
+
+    // Every buffer of the test is mapped following the policy
+    af::setCpuAllocPolicy(AF_HUGE_PAGES_TRANSPARENT, AF_NUMA_LOCAL, 0);
+    af::hugePages pages;
+    af::numaPolicy numa;
+    size_t bytes;
+    af::getCpuAllocPolicy(&pages, &numa, &bytes);
+    EXPECT_EQ(AF_HUGE_PAGES_TRANSPARENT, pages);
+    EXPECT_EQ(AF_NUMA_LOCAL, numa);
+    EXPECT_EQ(0u, bytes);
+
+    deviceGC();
+    {
+        vector<float> in(1 << 20);
+        for (size_t i = 0; i < in.size(); i++) {
+            in[i] = static_cast<float>(i % 100);
+        }
+        array a(dim4(in.size()), in.data());
+        array b = a * 2;
+        for (float &value : in) { value *= 2; }
+        ASSERT_VEC_ARRAY_EQ(in, dim4(in.size()), b);
+    }
+    // The mapped buffers are released by the garbage collection
+    deviceGC();
+
+    af::setCpuAllocPolicy(old_pages, old_numa, old_bytes);
+}
+
+TEST(Memory, Stats) {
+    cleanSlate();  // Clean up everything done so far
+    af::resetDeviceMemStats();
+
+    {
+        // 1000 bytes are rounded up to the step size
+        array a(250, f32);
+        array b(250, f32);
+        a.eval();
+        b.eval();
+    }
+    {
+        // Reuses one of the freed buffers
+        array c(250, f32);
+        c.eval();
+    }
+
+    af_memory_stats stats;
+    af::deviceMemStats(&stats);
+
+    ASSERT_EQ(3u, stats.alloc_count);
+    ASSERT_EQ(1u, stats.cache_hits);
+    ASSERT_EQ(2u, stats.cache_misses);
+    ASSERT_EQ(3 * 1000u, stats.requested_bytes);
+    ASSERT_EQ(3 * (step_bytes - 1000), stats.rounding_bytes);
+    ASSERT_EQ(3u, stats.size_histogram[0]);
+    ASSERT_EQ(2u, stats.native_alloc_count);
+    ASSERT_EQ(2 * step_bytes, stats.peak_alloc_bytes);
+    ASSERT_EQ(2 * step_bytes, stats.peak_lock_bytes);
+    ASSERT_EQ(0u, stats.lock_bytes);
+
+    deviceGC();
+    af::deviceMemStats(&stats);
+
+    ASSERT_EQ(1u, stats.gc_count);
+    ASSERT_EQ(2u, stats.gc_buffers);
+    ASSERT_EQ(2 * step_bytes, stats.gc_bytes);
+    ASSERT_EQ(2u, stats.native_free_count);
+    ASSERT_EQ(0u, stats.alloc_bytes);
+
+    af::resetDeviceMemStats();
+    af::deviceMemStats(&stats);
+    ASSERT_EQ(0u, stats.alloc_count);
+    ASSERT_EQ(0u, stats.peak_alloc_bytes);
+}
+
+TEST(Memory, CacheBudget) {
+    size_t alloc_bytes, alloc_buffers;
+    size_t lock_bytes, lock_buffers;
+
+    cleanSlate();  // Clean up everything done so far
+    const size_t buffer_bytes = 4 << 20;
+    const dim_t elements      = buffer_bytes / sizeof(float);
+
+    af::setMemCacheBudget(2 * buffer_bytes);
+    ASSERT_EQ(2 * buffer_bytes, af::getMemCacheBudget());
+    {
+        array a(elements, f32);
+        array b(elements, f32);
+        array c(elements, f32);
+        array d(elements, f32);
+        a.eval();
+        b.eval();
+        c.eval();
+        d.eval();
+    }
+
+    // Only the last two freed buffers are kept
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(2u, alloc_buffers);
+    ASSERT_EQ(0u, lock_buffers);
+    ASSERT_EQ(2 * buffer_bytes, alloc_bytes);
+
+    // Lowering the budget evicts the cached buffers
+    af::setMemCacheBudget(0);
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(0u, alloc_buffers);
+    ASSERT_EQ(0u, alloc_bytes);
+
+    af::setMemCacheBudget(std::numeric_limits<size_t>::max());
+}
+
+TEST(Memory, Arena) {
+    size_t alloc_bytes, alloc_buffers;
+    size_t lock_bytes, lock_buffers;
+
+    cleanSlate();  // Clean up everything done so far
+    const bool cpu = af::getActiveBackend() == AF_BACKEND_CPU;
+
+    array escaped;
+    {
+        af::scope arena(1 << 20);
+        array a = constant(1, 100);
+        array b = a + 1;
+        a.eval();
+        b.eval();
+        escaped = b;
+
+        // Both arrays are carved out of the same block
+        deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+        if (cpu) {
+            ASSERT_EQ(1u, alloc_buffers);
+            ASSERT_EQ(size_t(1 << 20), alloc_bytes);
+        }
+    }
+
+    // The array escaping the scope keeps its block
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(1u, lock_buffers);
+    ASSERT_ARRAYS_EQ(constant(2, 100), escaped);
+
+    escaped = array();
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(0u, lock_buffers);
+
+    EXPECT_EQ(cpu ? AF_ERR_ARG : AF_SUCCESS, af_pop_arena());
+}
+
 TEST(Memory, IndexedDevice) {
     // This test is checking to see if calling .device() will force copy to a
     // new buffer
@@ -2397,3 +2397,96 @@ TEST(Reduce, SNIPPET_algorithm_func_sum) {
     ASSERT_VEC_ARRAY_EQ(gold_a, d.dims(), d);
     ASSERT_VEC_ARRAY_EQ(gold_a, e.dims(), e);
 }
+
+TEST(Reduce, Sum_Global_CpuThreads) {
+    if (af::getActiveBackend() != AF_BACKEND_CPU) {
+        int num_threads = 0;
+        ASSERT_EQ(AF_ERR_NOT_SUPPORTED, af_get_cpu_threads(&num_threads));
+        GTEST_SKIP() << "Thread count is only configurable on the CPU backend";
+    }
+    const int old_threads = af::getCpuThreads();
+    EXPECT_EQ(AF_ERR_ARG, af_set_cpu_threads(0));
+
+    array a = af::randu(1000, 300, 2);
+    // The vector and the strided view are split within their columns
+    array v = af::randu(1 << 20);
+    array s = a(af::seq(1, 998, 3), af::span, af::span);
+    af::eval(a, v);
+
+    af::setCpuThreads(1);
+    ASSERT_EQ(1, af::getCpuThreads());
+    float serial     = af::sum<float>(a);
+    array serial_dim = af::sum(a, 1);
+    float serial_v   = af::sum<float>(v);
+    float serial_s   = af::sum<float>(s);
+
+    af::setCpuThreads(4);
+    ASSERT_EQ(4, af::getCpuThreads());
+    float parallel     = af::sum<float>(a);
+    array parallel_dim = af::sum(a, 1);
+    float parallel_v   = af::sum<float>(v);
+    float parallel_s   = af::sum<float>(s);
+
+    af::setCpuThreads(old_threads);
+
+    // The partial sums are combined in the same order for any thread count
+    ASSERT_EQ(serial, parallel);
+    ASSERT_ARRAYS_EQ(serial_dim, parallel_dim);
+    ASSERT_EQ(serial_v, parallel_v);
+    ASSERT_EQ(serial_s, parallel_s);
+
+    vector<float> hv(v.elements());
+    v.host(hv.data());
+    double gold_v = 0;
+    for (float x : hv) { gold_v += x; }
+    ASSERT_NEAR(gold_v, parallel_v, 1e-3 * gold_v);
+}
+
+TEST(Reduce, Sum_JIT) {
+    array a = randu(1001, 517);
+    array b = randu(1001, 517);
+    array c = randu(1001, 517);
+
+    // The evaluated copy goes through the regular kernels while the lazy
+    // expressions are reduced as they are evaluated
+    array gold = a * b + c;
+    gold.eval();
+
+    for (int dim = 0; dim < 4; dim++) {
+        ASSERT_ARRAYS_EQ(sum(gold, dim), sum(a * b + c, dim));
+        ASSERT_ARRAYS_EQ(max(gold, dim), max(a * b + c, dim));
+    }
+    ASSERT_EQ(sum<float>(gold), sum<float>(a * b + c));
+    ASSERT_EQ(count<unsigned>(gold > 1), count<unsigned>(a * b + c > 1));
+
+    // Sub-arrays make the tree evaluate along the strided path
+    array sa    = a(seq(1, 1000), seq(2, 516));
+    array sb    = b(seq(0, 999), seq(1, 515));
+    array sgold = sa - sb;
+    sgold.eval();
+
+    ASSERT_ARRAYS_EQ(sum(sgold, 0), sum(sa - sb, 0));
+    ASSERT_ARRAYS_EQ(sum(sgold, 1), sum(sa - sb, 1));
+    ASSERT_EQ(sum<float>(sgold), sum<float>(sa - sb));
+}
+
+TEST(Reduce, Sum_JIT_RowVector) {
+    array a = randu(1, 100000);
+    array b = randu(1, 100000);
+
+    // The first dimension is shorter than a chunk of the tree
+    array gold = a * b + 1;
+    gold.eval();
+
+    ASSERT_ARRAYS_EQ(sum(gold, 0), sum(a * b + 1, 0));
+    ASSERT_ARRAYS_EQ(sum(gold, 1), sum(a * b + 1, 1));
+    ASSERT_EQ(sum<float>(gold), sum<float>(a * b + 1));
+
+    array c     = randu(3, 100000);
+    array cgold = c * 2;
+    cgold.eval();
+
+    ASSERT_ARRAYS_EQ(sum(cgold, 0), sum(c * 2, 0));
+    ASSERT_ARRAYS_EQ(max(cgold, 1), max(c * 2, 1));
+    ASSERT_EQ(sum<float>(cgold), sum<float>(c * 2));
+}
@@ -16,6 +16,7 @@
 #include <complex>
 #include <condition_variable>
 #include <cstddef>
+#include <future>
 #include <iterator>
 #include <thread>
 #include <vector>
@@ -705,6 +706,165 @@ TEST(Threading, Sparse) {
         if (tests[testId].joinable()) tests[testId].join();
 }
 
+TEST(Threading, InterleavedQueueOperations) {
+    // Operations on different arrays can run at the same time while the
+    // operations on the same memory must keep the order they were called in
+    const int num_arrays = 8;
+    const int size       = 64;
+
+    vector<array> arrays;
+    vector<array> transposed(num_arrays);
+    vector<vector<float>> gold;
+    for (int i = 0; i < num_arrays; i++) {
+        arrays.push_back(constant(i, size, size));
+        gold.emplace_back(size * size, static_cast<float>(i));
+    }
+
+    for (int col = 0; col < 10; col++) {
+        for (int i = 0; i < num_arrays; i++) {
+            arrays[i](span, col) = arrays[i](span, col) + 1;
+            transposed[i]        = transpose(arrays[i]);
+            arrays[i](0, span)   = transposed[i](span, 1).T() * 2;
+        }
+        for (int i = 0; i < num_arrays; i++) {
+            vector<float> &g = gold[i];
+            for (int r = 0; r < size; r++) { g[col * size + r] += 1; }
+            vector<float> row1(size);
+            for (int c = 0; c < size; c++) { row1[c] = g[c * size + 1]; }
+            for (int c = 0; c < size; c++) { g[c * size] = row1[c] * 2; }
+        }
+    }
+
+    for (int i = 0; i < num_arrays; i++) {
+        ASSERT_VEC_ARRAY_EQ(gold[i], dim4(size, size), arrays[i]);
+    }
+}
+
+TEST(Threading, SmallOperationsAfterLargeOnes) {
+    // Small operations can run on the calling thread. They must still wait
+    // for the large operations writing the memory they read.
+    array in    = randu(512, 512);
+    array large = matmul(in, in);
+    array small = constant(0, 16);
+    for (int i = 0; i < 100; i++) {
+        small += large(seq(16), 0);
+        small.eval();
+    }
+    vector<float> column(16);
+    large(seq(16), 0).host(column.data());
+    for (float &value : column) { value *= 100; }
+    ASSERT_VEC_ARRAY_NEAR(column, dim4(16), small, 1.0);
+}
+
+TEST(Threading, EventAcrossThreads) {
+    // An event marked by one thread orders the work of another thread
+    const int size = 1024;
+    array in       = randu(size, size);
+    array out;
+    event ready;
+
+    std::thread producer([&] {
+        setDevice(0);
+        out = matmul(in, in) + 1;
+        ready.mark();
+    });
+    producer.join();
+
+    array result;
+    std::thread consumer([&] {
+        setDevice(0);
+        ready.enqueue();
+        result = out - 1;
+        af::sync();
+    });
+    consumer.join();
+
+    ASSERT_ARRAYS_NEAR(matmul(in, in), result, 1e-3);
+}
+
+TEST(Threading, EventAcrossThreadQueues) {
+    if (getActiveBackend() != AF_BACKEND_CPU) {
+        bool enabled = false;
+        ASSERT_EQ(AF_ERR_NOT_SUPPORTED, af_get_cpu_thread_queues(&enabled));
+        GTEST_SKIP() << "Only the CPU backend has queues per thread";
+    }
+    const bool old_thread_queues = getCpuThreadQueues();
+    setCpuThreadQueues(true);
+    ASSERT_TRUE(getCpuThreadQueues());
+
+    const int size = 1024;
+    array in       = randu(size, size);
+    in.eval();
+    af::sync();
+
+    array out, result;
+    event ready;
+    std::promise<void> marked, consumed;
+
+    // The producer is kept alive until the consumer is done, so its tasks
+    // are only waited for by the event
+    std::thread producer([&] {
+        setDevice(0);
+        out = matmul(in, in) + 1;
+        out.eval();
+        ready.mark();
+        marked.set_value();
+        consumed.get_future().wait();
+    });
+
+    std::thread consumer([&] {
+        setDevice(0);
+        marked.get_future().wait();
+        ready.enqueue();
+        result = out - 1;
+        af::sync();
+        consumed.set_value();
+    });
+    consumer.join();
+    producer.join();
+
+    setCpuThreadQueues(old_thread_queues);
+    ASSERT_ARRAYS_NEAR(matmul(in, in), result, 1e-3);
+}
+
+TEST(Threading, FreeAcrossThreadQueues) {
+    if (getActiveBackend() != AF_BACKEND_CPU) {
+        GTEST_SKIP() << "Only the CPU backend has queues per thread";
+    }
+    const bool old_thread_queues = getCpuThreadQueues();
+    setCpuThreadQueues(true);
+
+    const int size = 1024;
+    array in       = constant(1, size, size);
+    in.eval();
+    af::sync();
+
+    array out;
+    std::promise<void> enqueued, released;
+
+    // The reader only holds the buffer of in through its pending task
+    std::thread reader([&] {
+        setDevice(0);
+        out = matmul(in, in);
+        out.eval();
+        enqueued.set_value();
+        released.get_future().wait();
+        af::sync();
+    });
+
+    // The buffer must not be reused while the reader's queue reads it
+    enqueued.get_future().wait();
+    in           = array();
+    array reused = constant(0, size, size);
+    reused.eval();
+    af::sync();
+    released.set_value();
+    reader.join();
+
+    setCpuThreadQueues(old_thread_queues);
+    ASSERT_ARRAYS_EQ(constant(size, size, size), out);
+}
+
 TEST(Threading, DISABLED_MemoryManagerStressTest) {
     vector<std::thread> threads;
     for (int i = 0; i < THREAD_COUNT; i++) {
@@ -750,3 +910,22 @@ TEST(Threading, DISABLED_Sort) {
     for (auto& t : tests)
         if (t.joinable()) t.join();
 }
+
+TEST(Threading, MemoryCleanupDuringWork) {
+    // The garbage collection does not wait for the pending operations. The
+    // buffers they read are released once they complete.
+    const int size = 1024;
+    array expected;
+    array result;
+    {
+        array in = randu(size, size);
+        expected = matmul(in, in);
+        expected.eval();
+        af::sync();
+        result = matmul(in, in);
+        result.eval();
+    }
+    deviceGC();
+
+    ASSERT_ARRAYS_NEAR(expected, result, 1e-3);
+}